@@ -0,0 +1,78 @@
+#pragma once
+
+// Inputs shared by the benchmarks: the compressed blocks the editor knows about in the USA
+// ROM, and seeded synthetic data for runs without a ROM.
+
+#include "rom/tileset.h"
+
+#include "SDL3/SDL_stdinc.h"
+
+#include <cstddef>
+#include <random>
+#include <vector>
+
+namespace spintool::bench
+{
+	// The tile count headers of the SSC tilesets the tileset navigator loads.
+	inline constexpr Uint32 kKnownSSCTilesets[] =
+	{
+		0x0003DBB2, 0x000394AA, // Toxic Caves
+		0x00067672, 0x00064BB6, // Lava Powerhouse
+		0x00081EB6, 0x0007F29C, // The Machine
+		0x00053214, 0x0004FEE4, // Showdown
+		0x000BDD2E,             // Options
+	};
+
+	// Compressed2 blocks the tileset navigator and the frame decoders load.
+	inline constexpr Uint32 kKnownCompressed2Blocks[] =
+	{
+		0x0009D104, // Title screen art
+		0x000A3126, // Tails' plane art
+		0x000A220C, // Veg-o-fortress foreground art
+		0x000C77B0, // Bonus stage background art
+		0x000C9016, // Bonus stage foreground art
+		0x000CB14E,
+		0x000CC710,
+		0x000CF2DE,
+		0x000D10B0,
+	};
+
+	// Level art: num_base_tiles tiles on flat backgrounds with one byte in detail_one_in of
+	// detail, reused to make num_tiles tiles, one in edit_one_in of them with a byte changed.
+	inline std::vector<Uint8> MakeSyntheticTiles(std::mt19937& rng, Uint32 num_tiles, Uint32 num_base_tiles, int detail_one_in, int edit_one_in)
+	{
+		std::vector<std::vector<Uint8>> base_tiles(num_base_tiles, std::vector<Uint8>(rom::TileSet::s_tile_total_bytes));
+		for (std::vector<Uint8>& tile : base_tiles)
+		{
+			const Uint8 background = static_cast<Uint8>(rng() & 0x0F) * 0x11;
+			for (Uint8& byte : tile)
+			{
+				byte = static_cast<int>(rng() % detail_one_in) == 0 ? static_cast<Uint8>(rng()) : background;
+			}
+		}
+
+		std::vector<Uint8> tiles;
+		tiles.reserve(static_cast<std::size_t>(num_tiles) * rom::TileSet::s_tile_total_bytes);
+		for (Uint32 i = 0; i < num_tiles; ++i)
+		{
+			std::vector<Uint8> tile = base_tiles[rng() % num_base_tiles];
+			if (static_cast<int>(rng() % edit_one_in) == 0)
+			{
+				tile[rng() % tile.size()] = static_cast<Uint8>(rng());
+			}
+			tiles.insert(tiles.end(), tile.begin(), tile.end());
+		}
+		return tiles;
+	}
+
+	// Bytes no codec can shrink.
+	inline std::vector<Uint8> MakeNoise(std::mt19937& rng, std::size_t size)
+	{
+		std::vector<Uint8> noise(size);
+		for (Uint8& byte : noise)
+		{
+			byte = static_cast<Uint8>(rng());
+		}
+		return noise;
+	}
+}
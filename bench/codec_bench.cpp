@@ -0,0 +1,303 @@
+// Throughput and compression ratio of every codec the editor ships, on one corpus, with a
+// round trip checked on every sample: SSCCompressor with both parsers, SSCDecompressor's
+// reference and fast decoders, Compressed2Optimizer::Compress/Decode and the LZSSDecompressor
+// views of the same streams. The corpus is a seeded synthetic tile set, plus every tileset
+// and Compressed2 block the editor knows when SPINTOOL_ROM names a ROM. Results are printed
+// and written as JSON so runs can be compared over time; any failed round trip is reported
+// as "round trip no" and makes the exit code non-zero.
+//
+//   spintool_codec_bench [results.json]                        default codec_bench.json
+//   SPINTOOL_ROM=<rom> spintool_codec_bench [results.json]     adds the ROM's blocks
+
+#include "bench_corpus.h"
+
+#include "rom/compressed2_decoder.h"
+#include "rom/compressed2_optimizer.h"
+#include "rom/lzss_decompressor.h"
+#include "rom/spinball_rom.h"
+#include "rom/ssc_compressor.h"
+#include "rom/ssc_decompressor.h"
+#include "rom/tileset.h"
+#include "rom/tile.h"
+
+#include "nlohmann/json.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace spintool::bench
+{
+	namespace
+	{
+		using Json = nlohmann::ordered_json;
+
+		constexpr Uint32 kSeed = 0xC0DEC;
+		// Every measurement repeats until it has run this long, so fast decoders are not
+		// timed on a single call and slow encoders are not run hundreds of times.
+		constexpr double kMinimumMeasureMilliseconds = 100.0;
+		constexpr int kMaximumMeasureIterations = 1000;
+		// The 68k port indexes the ROM for its bit mask table, at this address.
+		constexpr std::size_t kLegacyMaskTableEnd = 0x9BCDA;
+
+		struct Sample
+		{
+			std::string name;
+			std::string source;
+			std::vector<Uint8> payload;
+			// Where the block came from and how big the game's own copy is, for ROM samples.
+			ByteSpan image;
+			Uint32 offset = 0;
+			CompressionAlgorithm shipped_algorithm = CompressionAlgorithm::NONE;
+			std::size_t shipped_size = 0;
+		};
+
+		template<typename Func>
+		double MeasureMilliseconds(Func&& func)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			double elapsed = 0.0;
+			int iterations = 0;
+			do
+			{
+				func();
+				++iterations;
+				elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			} while (elapsed < kMinimumMeasureMilliseconds && iterations < kMaximumMeasureIterations);
+			return elapsed / iterations;
+		}
+
+		double MegabytesPerSecond(std::size_t bytes, double milliseconds)
+		{
+			return milliseconds > 0.0 ? (static_cast<double>(bytes) / (1024.0 * 1024.0)) / (milliseconds / 1000.0) : 0.0;
+		}
+
+		double Ratio(std::size_t compressed, std::size_t uncompressed)
+		{
+			return uncompressed > 0 ? static_cast<double>(compressed) / static_cast<double>(uncompressed) : 0.0;
+		}
+
+		void PrintLine(const Sample& sample, const std::string& codec, const Json& result)
+		{
+			std::cout << std::left << std::setw(16) << sample.name << std::setw(14) << codec
+				<< std::right << std::fixed << std::setprecision(3);
+			if (result.contains("compressed_size"))
+			{
+				std::cout << std::setw(8) << sample.payload.size() << " -> " << std::setw(7) << result["compressed_size"].get<std::size_t>()
+					<< "  ratio " << result["ratio"].get<double>()
+					<< std::setprecision(1) << "  encode " << std::setw(7) << result["encode_mb_s"].get<double>() << " MB/s";
+			}
+			for (const auto& [decoder, megabytes_per_second] : result["decode_mb_s"].items())
+			{
+				std::cout << std::setprecision(1) << "  " << decoder << ' ' << std::setw(7) << megabytes_per_second.get<double>();
+			}
+			std::cout << "  round trip " << (result["round_trip"].get<bool>() ? "yes" : "no") << '\n';
+		}
+
+		Json BenchSSC(const Sample& sample, bool optimal_parse)
+		{
+			rom::SSCCompressionSettings settings;
+			settings.optimal_parse = optimal_parse;
+			const rom::SSCCompressionResult stream = rom::SSCCompressor::CompressData(sample.payload, settings);
+			const double encode_ms = MeasureMilliseconds([&]() { (void)rom::SSCCompressor::CompressData(sample.payload, settings); });
+
+			const Uint32 hint = static_cast<Uint32>(sample.payload.size());
+			const rom::SSCDecompressionResult reference = rom::SSCDecompressor::DecompressData(stream, 0, hint);
+			const rom::SSCDecompressionResult fast = rom::SSCDecompressor::DecompressDataFast(stream, 0, hint);
+			const double reference_ms = MeasureMilliseconds([&]() { (void)rom::SSCDecompressor::DecompressData(stream, 0, hint); });
+			const double fast_ms = MeasureMilliseconds([&]() { (void)rom::SSCDecompressor::DecompressDataFast(stream, 0, hint); });
+
+			Json result;
+			result["compressed_size"] = stream.size();
+			result["ratio"] = Ratio(stream.size(), sample.payload.size());
+			result["encode_mb_s"] = MegabytesPerSecond(sample.payload.size(), encode_ms);
+			result["decode_mb_s"]["reference"] = MegabytesPerSecond(sample.payload.size(), reference_ms);
+			result["decode_mb_s"]["fast"] = MegabytesPerSecond(sample.payload.size(), fast_ms);
+			result["round_trip"] = !reference.error_msg.has_value() && reference.uncompressed_data == sample.payload && reference == fast;
+			return result;
+		}
+
+		Json BenchCompressed2(const Sample& sample)
+		{
+			const rom::Compressed2CompressionResult compressed = rom::Compressed2Optimizer::Compress(sample.payload);
+			const double encode_ms = MeasureMilliseconds([&]() { (void)rom::Compressed2Optimizer::Compress(sample.payload); });
+
+			std::vector<Uint8> output;
+			std::string error;
+			std::size_t consumed = 0;
+			const bool round_trip = rom::Compressed2Optimizer::Decode(compressed.data, 0, output, error, &consumed)
+				&& output == sample.payload && consumed == compressed.data.size();
+			const double decode_ms = MeasureMilliseconds([&]() { (void)rom::Compressed2Optimizer::Decode(compressed.data, 0, output, error); });
+
+			Json result;
+			result["compressed_size"] = compressed.data.size();
+			result["ratio"] = Ratio(compressed.data.size(), sample.payload.size());
+			result["encode_mb_s"] = MegabytesPerSecond(sample.payload.size(), encode_ms);
+			result["decode_mb_s"]["table"] = MegabytesPerSecond(sample.payload.size(), decode_ms);
+			result["round_trip"] = round_trip;
+			return result;
+		}
+
+		// Both LZSSDecompressor paths on the same stream: the game's block in place for ROM
+		// samples, where the 68k port can run too, otherwise a freshly encoded stream.
+		Json BenchLZSS(const Sample& sample)
+		{
+			std::vector<Uint8> encoded;
+			ByteSpan image = sample.image;
+			Uint32 offset = sample.offset;
+			if (sample.shipped_algorithm != CompressionAlgorithm::LZSS)
+			{
+				encoded = rom::Compressed2Optimizer::Compress(sample.payload).data;
+				// The ports read three bytes at every token, so leave room after the END token.
+				encoded.insert(encoded.end(), 3, 0);
+				image = encoded;
+				offset = 0;
+			}
+
+			const rom::LZSSDecompressionResult fast = rom::LZSSDecompressor::DecompressDataFast(image, offset);
+			const rom::LZSSDecompressionResult portable = rom::LZSSDecompressor::DecompressDataRefactored(image, offset);
+			std::vector<Uint8> expected(2, 0);
+			expected.insert(expected.end(), sample.payload.begin(), sample.payload.begin() + (sample.payload.size() & ~static_cast<std::size_t>(1)));
+			bool round_trip = !fast.error_msg.has_value() && fast.uncompressed_data == expected && portable == fast;
+
+			Json result;
+			result["decode_mb_s"]["fast"] = MegabytesPerSecond(sample.payload.size(), MeasureMilliseconds([&]() { (void)rom::LZSSDecompressor::DecompressDataFast(image, offset); }));
+			result["decode_mb_s"]["portable"] = MegabytesPerSecond(sample.payload.size(), MeasureMilliseconds([&]() { (void)rom::LZSSDecompressor::DecompressDataRefactored(image, offset); }));
+			if (image.size() >= kLegacyMaskTableEnd)
+			{
+				round_trip &= rom::LZSSDecompressor::DecompressData(image, offset) == fast;
+				result["decode_mb_s"]["68k"] = MegabytesPerSecond(sample.payload.size(), MeasureMilliseconds([&]() { (void)rom::LZSSDecompressor::DecompressData(image, offset); }));
+			}
+			result["round_trip"] = round_trip;
+			return result;
+		}
+
+		// Level art: a handful of base tiles reused with small edits on flat backgrounds, plus
+		// a block of noise that no codec can shrink.
+		std::vector<Sample> MakeSyntheticCorpus()
+		{
+			std::mt19937 rng{ kSeed };
+
+			std::vector<Sample> corpus;
+			// Synthetic samples have no ROM copy, so only these fields are set.
+			auto add_sample = [&corpus](const char* name, std::vector<Uint8> payload)
+				{
+					Sample& sample = corpus.emplace_back();
+					sample.name = name;
+					sample.source = "synthetic";
+					sample.payload = std::move(payload);
+				};
+			add_sample("flat", MakeSyntheticTiles(rng, 0x200, 0x10, 8, 8));
+			add_sample("reused", MakeSyntheticTiles(rng, 0x300, 0x40, 3, 4));
+			add_sample("detailed", MakeSyntheticTiles(rng, 0x400, 0x200, 2, 2));
+			add_sample("noise", MakeNoise(rng, 0x100 * rom::TileSet::s_tile_total_bytes));
+			return corpus;
+		}
+
+		std::string OffsetName(Uint32 offset)
+		{
+			std::ostringstream name;
+			name << "0x" << std::hex << offset;
+			return name.str();
+		}
+
+		void AddROMCorpus(const rom::SpinballROM& rom, std::vector<Sample>& corpus)
+		{
+			for (const Uint32 offset : kKnownSSCTilesets)
+			{
+				const TilesetEntry entry = rom::TileSet::LoadFromROM_SSCCompression(rom, offset);
+				if (!entry.tileset || entry.result.error_msg.has_value())
+				{
+					std::cerr << "No SSC tileset at " << OffsetName(offset) << '\n';
+					continue;
+				}
+				// The shipped block is the tile count header plus the compressed stream.
+				corpus.push_back({ OffsetName(offset), "rom", entry.tileset->uncompressed_data, rom.m_buffer, offset + 2, CompressionAlgorithm::SSC, entry.tileset->rom_data.real_size - 2U });
+			}
+
+			for (const Uint32 offset : kKnownCompressed2Blocks)
+			{
+				rom::Compressed2DecodeResult decoded = rom::Compressed2Decoder::Decode(rom.m_buffer, offset);
+				if (decoded.error_msg.has_value() || decoded.output.empty())
+				{
+					std::cerr << "No Compressed2 block at " << OffsetName(offset) << '\n';
+					continue;
+				}
+				corpus.push_back({ OffsetName(offset), "rom", std::move(decoded.output), rom.m_buffer, offset, CompressionAlgorithm::LZSS, decoded.GetConsumedSize() });
+			}
+		}
+
+		int Run(int argc, char** argv)
+		{
+			const std::string output_path = argc >= 2 ? argv[1] : "codec_bench.json";
+			std::vector<Sample> corpus = MakeSyntheticCorpus();
+
+			rom::SpinballROM rom;
+			const char* rom_path = std::getenv("SPINTOOL_ROM");
+			if (rom_path != nullptr && *rom_path != '\0')
+			{
+				if (!rom.LoadROMFromPath(rom_path))
+				{
+					std::cerr << "Could not load " << rom_path << '\n';
+					return 1;
+				}
+				AddROMCorpus(rom, corpus);
+			}
+
+			Json report;
+			report["seed"] = kSeed;
+			report["rom"] = rom_path != nullptr ? Json(rom_path) : Json(nullptr);
+			report["samples"] = Json::array();
+
+			bool all_round_trips = true;
+			for (const Sample& sample : corpus)
+			{
+				Json entry;
+				entry["name"] = sample.name;
+				entry["source"] = sample.source;
+				entry["size"] = sample.payload.size();
+				if (sample.shipped_algorithm != CompressionAlgorithm::NONE)
+				{
+					entry["offset"] = sample.offset;
+					entry["shipped_codec"] = sample.shipped_algorithm == CompressionAlgorithm::SSC ? "ssc" : "compressed2";
+					entry["shipped_size"] = sample.shipped_size;
+					entry["shipped_ratio"] = Ratio(sample.shipped_size, sample.payload.size());
+				}
+
+				Json& codecs = entry["codecs"];
+				codecs["ssc_greedy"] = BenchSSC(sample, false);
+				codecs["ssc_optimal"] = BenchSSC(sample, true);
+				codecs["compressed2"] = BenchCompressed2(sample);
+				codecs["lzss"] = BenchLZSS(sample);
+				for (const auto& [codec, result] : codecs.items())
+				{
+					PrintLine(sample, codec, result);
+					all_round_trips &= result["round_trip"].get<bool>();
+				}
+				report["samples"].push_back(std::move(entry));
+			}
+			report["all_round_trips"] = all_round_trips;
+
+			std::ofstream output{ output_path };
+			if (!output)
+			{
+				std::cerr << "Could not write " << output_path << '\n';
+				return 1;
+			}
+			output << report.dump(2) << '\n';
+			std::cout << "Wrote " << output_path << '\n';
+			return all_round_trips ? 0 : 1;
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	return spintool::bench::Run(argc, argv);
+}
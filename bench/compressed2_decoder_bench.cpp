@@ -0,0 +1,143 @@
+// Times Compressed2Decoder against the decoders it replaced on the same streams: the 68k
+// port (LZSSDecompressor::DecompressData, only on a ROM), the portable port of it
+// (DecompressDataRefactored) and the bit-at-a-time Compressed2Optimizer::DecodeReference.
+// The LZSS views and the Compressed2 views must agree with their references, so an
+// "identical no" line is a bug.
+//
+//   spintool_compressed2_bench                          synthetic streams
+//   spintool_compressed2_bench <rom> [hex offset ...]   streams from a ROM; by default every
+//                                                       Compressed2 block the editor decodes
+
+#include "bench_corpus.h"
+
+#include "rom/compressed2_decoder.h"
+#include "rom/compressed2_optimizer.h"
+#include "rom/lzss_decompressor.h"
+#include "rom/spinball_rom.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace spintool::bench
+{
+	namespace
+	{
+		constexpr int kDecodeIterations = 200;
+		constexpr Uint32 kSyntheticSeed = 0xC2;
+
+		// The 68k port indexes the ROM for its bit mask table, at this address.
+		constexpr std::size_t kLegacyMaskTableEnd = 0x9BCDA;
+
+		template<typename Func>
+		double TimeMilliseconds(Func&& func)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			for (int i = 0; i < kDecodeIterations; ++i)
+			{
+				func();
+			}
+			return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / kDecodeIterations;
+		}
+
+		double MegabytesPerSecond(std::size_t bytes, double milliseconds)
+		{
+			return milliseconds > 0.0 ? (static_cast<double>(bytes) / (1024.0 * 1024.0)) / (milliseconds / 1000.0) : 0.0;
+		}
+
+		bool Report(const std::string& name, ByteSpan image, Uint32 offset)
+		{
+			const rom::Compressed2DecodeResult decoded = rom::Compressed2Decoder::Decode(image, offset);
+			if (decoded.error_msg.has_value())
+			{
+				std::cerr << name << ": " << *decoded.error_msg << '\n';
+				return false;
+			}
+
+			std::vector<Uint8> reference_output;
+			std::string reference_error;
+			std::size_t reference_consumed = 0;
+			std::vector<std::size_t> reference_resets;
+			const bool reference_ok = rom::Compressed2Optimizer::DecodeReference(image, offset, reference_output, reference_error, &reference_consumed, &reference_resets);
+			bool identical = reference_ok && reference_output == decoded.output
+				&& reference_consumed == decoded.GetConsumedSize() && reference_resets == decoded.reset_output_positions;
+			identical &= rom::LZSSDecompressor::DecompressDataRefactored(image, offset) == rom::LZSSDecompressor::DecompressDataFast(image, offset);
+
+			const bool run_legacy = image.size() >= kLegacyMaskTableEnd;
+			if (run_legacy)
+			{
+				identical &= rom::LZSSDecompressor::DecompressData(image, offset) == rom::LZSSDecompressor::DecompressDataFast(image, offset);
+			}
+
+			std::vector<Uint8> output;
+			std::string error;
+			const double table_ms = TimeMilliseconds([&]() { (void)rom::Compressed2Decoder::Decode(image, offset); });
+			const double bitwise_ms = TimeMilliseconds([&]() { (void)rom::Compressed2Optimizer::DecodeReference(image, offset, output, error); });
+			const double portable_ms = TimeMilliseconds([&]() { (void)rom::LZSSDecompressor::DecompressDataRefactored(image, offset); });
+			const double legacy_ms = run_legacy ? TimeMilliseconds([&]() { (void)rom::LZSSDecompressor::DecompressData(image, offset); }) : 0.0;
+
+			const std::size_t size = decoded.output.size();
+			std::cout << std::left << std::setw(12) << name
+				<< std::right << std::fixed << std::setprecision(1)
+				<< std::setw(7) << decoded.GetConsumedSize() << " -> " << std::setw(7) << size << " bytes"
+				<< "  table " << std::setw(7) << MegabytesPerSecond(size, table_ms) << " MB/s"
+				<< "  bitwise " << std::setw(6) << MegabytesPerSecond(size, bitwise_ms)
+				<< "  portable " << std::setw(6) << MegabytesPerSecond(size, portable_ms);
+			if (run_legacy)
+			{
+				std::cout << "  68k " << std::setw(6) << MegabytesPerSecond(size, legacy_ms);
+			}
+			std::cout << "  identical " << (identical ? "yes" : "no") << '\n';
+			return identical;
+		}
+
+		int Run(int argc, char** argv)
+		{
+			if (argc < 2)
+			{
+				std::mt19937 rng{ kSyntheticSeed };
+				const std::vector<Uint8> payload = MakeSyntheticTiles(rng, 0x400, 0x40, 3, 4);
+				rom::Compressed2CompressionResult compressed = rom::Compressed2Optimizer::Compress(payload);
+				// The ports read three bytes at every token, so leave room after the END token.
+				compressed.data.insert(compressed.data.end(), 3, 0);
+				return Report("synthetic", compressed.data, 0) ? 0 : 1;
+			}
+
+			rom::SpinballROM rom;
+			if (!rom.LoadROMFromPath(argv[1]))
+			{
+				std::cerr << "Could not load " << argv[1] << '\n';
+				return 1;
+			}
+
+			std::vector<Uint32> offsets;
+			for (int i = 2; i < argc; ++i)
+			{
+				offsets.emplace_back(static_cast<Uint32>(std::strtoul(argv[i], nullptr, 16)));
+			}
+			if (offsets.empty())
+			{
+				offsets.assign(std::begin(kKnownCompressed2Blocks), std::end(kKnownCompressed2Blocks));
+			}
+
+			bool all_identical = true;
+			for (const Uint32 offset : offsets)
+			{
+				std::ostringstream name;
+				name << "0x" << std::hex << offset;
+				all_identical &= Report(name.str(), rom.m_buffer, offset);
+			}
+			return all_identical ? 0 : 1;
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	return spintool::bench::Run(argc, argv);
+}
@@ -0,0 +1,185 @@
+// Compares per-field ROM access (one bounds check and, for writes, one journalled write per
+// field) against the ROMCursor/ROMWriter bulk API on a synthetic image.
+//
+//   spintool_bench [iterations]
+
+#include "bench_corpus.h"
+
+#include "rom/spinball_rom.h"
+#include "rom/rom_cursor.h"
+#include "rom/culling_tables/spline_culling_table.h"
+#include "rom/game_objects/game_object_ring.h"
+#include "rom/tile_brush.h"
+#include "rom/tile_layout.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace spintool::bench
+{
+	namespace
+	{
+		constexpr Uint32 kImageSize = 0x100000;
+		constexpr Uint32 kSplineTableOffset = 0x10000;
+		constexpr Uint32 kNumSplines = 0x2000;
+		constexpr Uint32 kRingTableOffset = 0x40000;
+		constexpr Uint32 kNumRings = 0x4000;
+		constexpr Uint32 kLayoutOffset = 0x80000;
+		constexpr Uint32 kLayoutInstances = 0x4000;
+
+		template<typename Func>
+		double TimeMilliseconds(int iterations, Func&& func)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			for (int i = 0; i < iterations; ++i)
+			{
+				func(i);
+			}
+			const auto end = std::chrono::steady_clock::now();
+			return std::chrono::duration<double, std::milli>(end - start).count() / iterations;
+		}
+
+		void Report(const std::string& name, double per_field_ms, double bulk_ms)
+		{
+			std::cout << std::left << std::setw(16) << name << std::right << std::fixed << std::setprecision(3)
+				<< " per-field " << std::setw(9) << per_field_ms << " ms"
+				<< "   bulk " << std::setw(9) << bulk_ms << " ms"
+				<< "   x" << std::setprecision(2) << (bulk_ms > 0.0 ? per_field_ms / bulk_ms : 0.0) << '\n';
+		}
+
+		// The decoders as they were before ROMCursor: every field goes through ReadUint16.
+		rom::CollisionSpline LoadSplinePerField(const rom::SpinballROM& rom, Uint32 offset)
+		{
+			rom::CollisionSpline spline;
+			spline.spline_vector.min.x = rom.ReadUint16(offset);
+			spline.spline_vector.min.y = rom.ReadUint16(offset + 2);
+			spline.spline_vector.max.x = rom.ReadUint16(offset + 4);
+			spline.spline_vector.max.y = rom.ReadUint16(offset + 6);
+			spline.object_type_flags = rom.ReadUint16(offset + 8);
+			spline.instance_id_binding = rom.ReadUint16(offset + 10);
+			spline.rom_data.SetROMData(offset, offset + rom::CollisionSpline::size_on_rom);
+			return spline;
+		}
+
+		rom::RingInstance LoadRingPerField(const rom::SpinballROM& rom, Uint32 offset)
+		{
+			rom::RingInstance ring;
+			ring.instance_id = rom.ReadUint16(offset);
+			ring.x_pos = rom.ReadUint16(offset + 2);
+			ring.y_pos = rom.ReadUint16(offset + 4);
+			ring.rom_data.SetROMData(offset, offset + 6);
+			return ring;
+		}
+
+		Uint32 SaveLayoutPerField(rom::SpinballROM& rom, const rom::TileLayout& layout, Uint32 offset)
+		{
+			for (const rom::TileBrushInstance& instance : layout.tile_brush_instances)
+			{
+				Uint8 first_byte = 0;
+				first_byte |= instance.is_flipped_vertically ? 0x10 : 0x00;
+				first_byte |= instance.is_flipped_horizontally ? 0x08 : 0x00;
+				first_byte |= (instance.tile_brush_index & 0x0700) >> 8;
+				offset = rom.WriteUint8(offset, first_byte);
+				offset = rom.WriteUint8(offset, instance.tile_brush_index & 0x00FF);
+			}
+			return offset;
+		}
+
+		int Run(int iterations)
+		{
+			std::mt19937 rng{ 0x5B1 };
+			const std::vector<Uint8> image = MakeNoise(rng, kImageSize);
+
+			rom::SpinballROM rom;
+			rom.m_buffer.Assign(image);
+
+			Uint64 checksum = 0;
+
+			const double splines_per_field = TimeMilliseconds(iterations, [&](int)
+				{
+					for (Uint32 i = 0; i < kNumSplines; ++i)
+					{
+						checksum += LoadSplinePerField(rom, kSplineTableOffset + i * rom::CollisionSpline::size_on_rom).object_type_flags;
+					}
+				});
+			const double splines_bulk = TimeMilliseconds(iterations, [&](int)
+				{
+					rom::ROMCursor cursor = rom.GetCursor(kSplineTableOffset, kNumSplines * rom::CollisionSpline::size_on_rom);
+					for (Uint32 i = 0; i < kNumSplines; ++i)
+					{
+						checksum += rom::CollisionSpline::LoadFromROM(cursor).object_type_flags;
+					}
+				});
+			Report("spline decode", splines_per_field, splines_bulk);
+
+			const double rings_per_field = TimeMilliseconds(iterations, [&](int)
+				{
+					for (Uint32 i = 0; i < kNumRings; ++i)
+					{
+						checksum += LoadRingPerField(rom, kRingTableOffset + i * 6).x_pos;
+					}
+				});
+			const double rings_bulk = TimeMilliseconds(iterations, [&](int)
+				{
+					rom::ROMCursor cursor = rom.GetCursor(kRingTableOffset, kNumRings * 6);
+					for (Uint32 i = 0; i < kNumRings; ++i)
+					{
+						checksum += rom::RingInstance::LoadFromROM(cursor).x_pos;
+					}
+				});
+			Report("ring decode", rings_per_field, rings_bulk);
+
+			// Each pass flips every flag so the writes are never skipped as no-ops.
+			rom::TileLayout layout;
+			layout.tile_brush_instances.resize(kLayoutInstances);
+			for (Uint32 i = 0; i < kLayoutInstances; ++i)
+			{
+				layout.tile_brush_instances[i].tile_brush_index = static_cast<Uint16>(rng() & 0x03FF);
+			}
+			auto flip_layout = [&layout]()
+				{
+					for (rom::TileBrushInstance& instance : layout.tile_brush_instances)
+					{
+						instance.is_flipped_horizontally = !instance.is_flipped_horizontally;
+					}
+				};
+
+			const double layout_per_field = TimeMilliseconds(iterations, [&](int)
+				{
+					flip_layout();
+					{
+						rom::ROMTransaction transaction{ rom, "Benchmark" };
+						checksum += SaveLayoutPerField(rom, layout, kLayoutOffset);
+					}
+					rom.GetJournal().Clear();
+				});
+			const double layout_bulk = TimeMilliseconds(iterations, [&](int)
+				{
+					flip_layout();
+					{
+						rom::ROMTransaction transaction{ rom, "Benchmark" };
+						checksum += layout.SaveLayoutToROM(rom, kLayoutOffset);
+					}
+					rom.GetJournal().Clear();
+				});
+			Report("layout write", layout_per_field, layout_bulk);
+
+			// Printed so the optimiser cannot discard the decode loops.
+			std::cout << "checksum " << std::hex << checksum << std::dec << '\n';
+			return 0;
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const int iterations = argc > 1 ? std::max(1, std::atoi(argv[1])) : 200;
+	return spintool::bench::Run(iterations);
+}
@@ -0,0 +1,140 @@
+// Measures the SSC codec. The encoder is compared on size against the raw tiles and, for
+// tilesets read from a ROM, against the block the game shipped with; every result is
+// decoded again by the compressor itself, so a "verified no" line is a bug. The fast
+// decoder is timed against the reference one and must produce identical results.
+//
+//   spintool_ssc_bench                                 synthetic tiles
+//   spintool_ssc_bench <rom> [hex offset ...]          SSC tilesets from a ROM; by default
+//                                                      every level tileset the editor knows
+
+#include "bench_corpus.h"
+
+#include "rom/spinball_rom.h"
+#include "rom/ssc_compressor.h"
+#include "rom/ssc_decompressor.h"
+#include "rom/tileset.h"
+#include "rom/tile.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace spintool::bench
+{
+	namespace
+	{
+		constexpr Uint32 kSyntheticSeed = 0x55C;
+		constexpr int kDecodeIterations = 200;
+
+		template<typename Func>
+		double TimeMilliseconds(Func&& func)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			for (int i = 0; i < kDecodeIterations; ++i)
+			{
+				func();
+			}
+			return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / kDecodeIterations;
+		}
+
+		// stream_offset points at the compressed data, after the tile count header.
+		bool ReportDecode(const std::string& name, ByteSpan image, Uint32 stream_offset, Uint32 expected_size)
+		{
+			const rom::SSCDecompressionResult reference = rom::SSCDecompressor::DecompressData(image, stream_offset, expected_size);
+			const rom::SSCDecompressionResult fast = rom::SSCDecompressor::DecompressDataFast(image, stream_offset, expected_size);
+			const bool identical = reference == fast;
+
+			const double reference_ms = TimeMilliseconds([&]() { (void)rom::SSCDecompressor::DecompressData(image, stream_offset, expected_size); });
+			const double fast_ms = TimeMilliseconds([&]() { (void)rom::SSCDecompressor::DecompressDataFast(image, stream_offset, expected_size); });
+			const double megabytes = static_cast<double>(reference.uncompressed_size) / (1024.0 * 1024.0);
+
+			std::cout << std::left << std::setw(12) << name << std::setw(8) << "decode"
+				<< std::right << std::fixed << std::setprecision(1)
+				<< std::setw(8) << reference.uncompressed_size << " bytes"
+				<< "  reference " << std::setw(7) << (reference_ms > 0.0 ? megabytes / (reference_ms / 1000.0) : 0.0) << " MB/s"
+				<< "  fast " << std::setw(7) << (fast_ms > 0.0 ? megabytes / (fast_ms / 1000.0) : 0.0) << " MB/s"
+				<< "  x" << std::setprecision(2) << (fast_ms > 0.0 ? reference_ms / fast_ms : 0.0)
+				<< "  identical " << (identical ? "yes" : "no") << '\n';
+			return identical;
+		}
+
+		void Report(const std::string& name, const std::vector<Uint8>& tiles, std::size_t original_size)
+		{
+			for (const bool optimal_parse : { false, true })
+			{
+				rom::SSCCompressionSettings settings;
+				settings.optimal_parse = optimal_parse;
+				rom::SSCCompressionStats stats;
+				const rom::SSCCompressionResult compressed = rom::SSCCompressor::CompressData(tiles, settings, &stats);
+
+				std::cout << std::left << std::setw(12) << name << std::setw(8) << (optimal_parse ? "optimal" : "greedy")
+					<< std::right << std::fixed << std::setprecision(3)
+					<< std::setw(8) << stats.input_size << " -> " << std::setw(7) << compressed.size() << " bytes"
+					<< "  ratio " << stats.GetRatio();
+				if (original_size > 0)
+				{
+					std::cout << "  vs original " << std::setw(7) << original_size;
+				}
+				std::cout << std::setprecision(1) << "  " << std::setw(7) << stats.GetMegabytesPerSecond() << " MB/s"
+					<< "  verified " << (stats.verified ? "yes" : "no") << '\n';
+			}
+		}
+
+		int Run(int argc, char** argv)
+		{
+			if (argc < 2)
+			{
+				std::mt19937 rng{ kSyntheticSeed };
+				const std::vector<Uint8> tiles = MakeSyntheticTiles(rng, 0x300, 0x40, 3, 4);
+				Report("synthetic", tiles, 0);
+				const rom::SSCCompressionResult stream = rom::SSCCompressor::CompressData(tiles);
+				return ReportDecode("synthetic", stream, 0, static_cast<Uint32>(tiles.size())) ? 0 : 1;
+			}
+
+			rom::SpinballROM rom;
+			if (!rom.LoadROMFromPath(argv[1]))
+			{
+				std::cerr << "Could not load " << argv[1] << '\n';
+				return 1;
+			}
+
+			std::vector<Uint32> offsets;
+			for (int i = 2; i < argc; ++i)
+			{
+				offsets.emplace_back(static_cast<Uint32>(std::strtoul(argv[i], nullptr, 16)));
+			}
+			if (offsets.empty())
+			{
+				offsets.assign(std::begin(kKnownSSCTilesets), std::end(kKnownSSCTilesets));
+			}
+
+			bool all_identical = true;
+			for (const Uint32 offset : offsets)
+			{
+				const TilesetEntry entry = rom::TileSet::LoadFromROM_SSCCompression(rom, offset);
+				if (!entry.tileset || entry.result.error_msg.has_value())
+				{
+					std::cerr << "No SSC tileset at 0x" << std::hex << offset << std::dec << '\n';
+					continue;
+				}
+
+				std::ostringstream name;
+				name << "0x" << std::hex << offset;
+				// The shipped block is the tile count header plus the compressed stream.
+				Report(name.str(), entry.tileset->uncompressed_data, entry.tileset->rom_data.real_size - 2);
+				all_identical &= ReportDecode(name.str(), rom.m_buffer, offset + 2, static_cast<Uint32>(entry.tileset->uncompressed_data.size()));
+			}
+			return all_identical ? 0 : 1;
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	return spintool::bench::Run(argc, argv);
+}
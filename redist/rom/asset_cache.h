@@ -0,0 +1,98 @@
+#pragma once
+
+#include "rom/rom_hash.h"
+#include "types/byte_span.h"
+#include "types/decompression_result.h"
+
+#include "SDL3/SDL_stdinc.h"
+
+#include <cstddef>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace spintool::rom
+{
+	class SpinballROM;
+}
+
+namespace spintool::rom
+{
+	enum class AssetCacheKind : Uint8
+	{
+		SSCDecompression,
+		LZSSDecompression,
+		Compressed2Decode,
+		SpriteScan,
+		StreamDiscovery
+	};
+
+	struct AssetCacheKey
+	{
+		AssetCacheKind kind = AssetCacheKind::SSCDecompression;
+		Uint32 offset = 0;
+		Uint32 parameter = 0; // Anything besides the offset that changes the output, e.g. a size hint
+
+		[[nodiscard]] bool operator<(const AssetCacheKey& rhs) const
+		{
+			return std::tie(kind, offset, parameter) < std::tie(rhs.kind, rhs.offset, rhs.parameter);
+		}
+	};
+
+	struct AssetCacheHit
+	{
+		Uint32 source_begin = 0;
+		Uint32 source_end = 0;
+		std::vector<Uint8> payload;
+	};
+
+	// Decoded data that survives between sessions, stored in one file per reference ROM
+	// (named after its content hash). Each entry remembers the ROM range it was decoded
+	// from and the hash of those bytes; a lookup rehashes the range in the image it is
+	// given and only returns the entry if it still matches, so edits invalidate exactly
+	// the entries they touch. Entries live in memory once opened and are written back
+	// on Flush. A cache that was never opened stores and finds nothing.
+	class AssetCache
+	{
+	public:
+		static constexpr Uint32 s_format_version = 1;
+		static constexpr std::size_t s_max_payload_bytes = 64 * 1024 * 1024;
+
+		~AssetCache();
+
+		// Flushes the file in use, then loads the one for rom_hash from directory.
+		bool Open(const std::filesystem::path& directory, const ROMHash& rom_hash);
+		bool Flush();
+		[[nodiscard]] bool IsOpen() const;
+
+		[[nodiscard]] std::optional<AssetCacheHit> Find(const AssetCacheKey& key, ByteSpan image) const;
+		void Store(const AssetCacheKey& key, ByteSpan image, Uint32 source_begin, Uint32 source_end, std::vector<Uint8> payload);
+
+	private:
+		struct Entry
+		{
+			Uint32 source_begin = 0;
+			Uint32 source_end = 0;
+			Uint64 source_hash = 0;
+			std::vector<Uint8> payload;
+		};
+
+		bool FlushLocked();
+		bool LoadFile();
+
+		mutable std::mutex m_mutex;
+		std::filesystem::path m_path;
+		std::map<AssetCacheKey, Entry> m_entries;
+		std::size_t m_payload_bytes = 0;
+		bool m_dirty = false;
+	};
+
+	// Decompressors routed through the ROM's cache. Only successful results are cached.
+	[[nodiscard]] DecompressionResult DecompressSSCCached(const SpinballROM& rom, Uint32 offset, Uint32 uncompressed_size_hint);
+	[[nodiscard]] DecompressionResult DecompressLZSSCached(const SpinballROM& rom, Uint32 offset);
+	bool DecodeCompressed2Cached(const SpinballROM& rom, Uint32 offset, std::vector<Uint8>& output, std::string& error);
+}
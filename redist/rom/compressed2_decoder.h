@@ -0,0 +1,120 @@
+#pragma once
+
+#include "types/byte_span.h"
+
+#include "SDL3/SDL_stdinc.h"
+
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace spintool::rom
+{
+	struct Compressed2DecodeResult
+	{
+		std::vector<Uint8> output;
+		// Output size at every CLEAR token that follows some output.
+		std::vector<std::size_t> reset_output_positions;
+		// For the same CLEAR tokens, the bit position just after each one, counted from offset.
+		std::vector<std::size_t> reset_bit_positions;
+		// Bits read up to and including the END token.
+		std::size_t consumed_bits = 0;
+		// On failure, output holds everything decoded before the bad token.
+		std::optional<std::string> error_msg;
+
+		// Byte length of the stream, including the partial byte holding the END token.
+		[[nodiscard]] std::size_t GetConsumedSize() const { return (consumed_bits + 7) / 8; }
+	};
+
+	// One Compressed2 stream decoded a piece at a time. DecodeUntil stops once the requested
+	// output is out and a later call carries on from the same token, so a preview can show
+	// the first tiles of a block and decode the rest over later frames. The input must stay
+	// alive and unchanged until decoding is finished. Compressed2Decoder runs through this.
+	class Compressed2StreamDecoder
+	{
+	public:
+		Compressed2StreamDecoder(ByteSpan input, std::size_t offset);
+
+		// Decodes until at least output_size bytes are out or the stream ends. Returns false
+		// once the stream has failed.
+		bool DecodeUntil(std::size_t output_size);
+		bool DecodeAll();
+
+		[[nodiscard]] bool IsFinished() const { return m_finished; }
+		[[nodiscard]] const std::optional<std::string>& GetError() const { return m_result.error_msg; }
+		[[nodiscard]] const std::vector<Uint8>& GetOutput() const { return m_result.output; }
+		[[nodiscard]] const Compressed2DecodeResult& GetResult() const { return m_result; }
+		[[nodiscard]] Compressed2DecodeResult TakeResult() { return std::move(m_result); }
+
+	private:
+		friend class Compressed2Decoder;
+
+		class BitReader
+		{
+		public:
+			BitReader(const Uint8* data, std::size_t size);
+
+			bool Read(unsigned int width, Uint16& code);
+			// Only before the first Read; bits must not run past the end of the data.
+			void Skip(std::size_t bits);
+
+			[[nodiscard]] std::size_t GetConsumedBits() const { return m_consumed_bits; }
+
+		private:
+			void Refill();
+
+			const Uint8* m_data = nullptr;
+			std::size_t m_size = 0;
+			std::size_t m_next_byte = 0;
+			Uint64 m_buffer = 0;
+			unsigned int m_buffered_bits = 0;
+			std::size_t m_consumed_bits = 0;
+		};
+
+		// Entries as (prefix code, last byte, length), indexed by code.
+		struct Dictionary
+		{
+			std::array<Uint16, 0x0800> prefix;
+			std::array<Uint16, 0x0800> length;
+			std::array<Uint8, 0x0800> suffix;
+		};
+
+		Compressed2StreamDecoder(ByteSpan input, std::size_t offset, std::size_t bit_position, bool after_clear, std::size_t stop_output_size);
+		bool Fail(const char* message);
+
+		Compressed2DecodeResult m_result;
+		BitReader m_reader;
+		Dictionary m_dictionary;
+		std::size_t m_stop_output_size = 0;
+		std::size_t m_token_count = 0;
+		unsigned int m_width = 9;
+		Uint16 m_next_code = 0x0102;
+		Uint16 m_next_width_threshold = 0x0200;
+		Uint16 m_previous_code = 0;
+		bool m_expect_literal = false;
+		bool m_finished = false;
+	};
+
+	// The game's "Compressed2" format: an LZW stream of 9 to 11 bit LSB-first tokens, where
+	// 0x100 resets the dictionary, 0x101 ends the stream and the first token after a reset
+	// is a literal. This is the decoder every loader goes through; LZSSDecompressor and
+	// Compressed2Optimizer::Decode are views over it. Tokens come out of a 64-bit bit buffer
+	// refilled a word at a time, and dictionary entries are stored as (prefix code, last byte,
+	// length) in flat tables, so expanding an entry writes its bytes backwards straight into
+	// the output without allocating.
+	class Compressed2Decoder
+	{
+	public:
+		static Compressed2DecodeResult Decode(ByteSpan input, std::size_t offset);
+		// Decodes part of a stream, starting at bit_position (counted from offset), which
+		// must directly follow a CLEAR token. Stops at the first CLEAR or END read once
+		// output_size bytes are out, so one run of segments can be checked on its own.
+		static Compressed2DecodeResult DecodeSegments(ByteSpan input, std::size_t offset, std::size_t bit_position, std::size_t output_size);
+
+		static constexpr std::size_t s_max_output_size = 64 * 1024 * 1024;
+		static constexpr std::size_t s_max_tokens = 1000000;
+	};
+}
@@ -1,8 +1,11 @@
 #pragma once
 
+#include "types/byte_span.h"
+
 #include "SDL3/SDL_stdinc.h"
 
 #include <cstddef>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -14,25 +17,54 @@ namespace spintool::rom
 		std::string strategy;
 		std::size_t baseline_size = 0;
 		std::size_t candidates_tested = 0;
+		// Candidates cut off once they could no longer beat the best finished stream.
+		std::size_t candidates_abandoned = 0;
+		double milliseconds = 0.0;
 	};
 
 	class Compressed2Optimizer
 	{
 	public:
 		// Compresses a Compressed2/LZW payload using several fully compatible
-		// dictionary-reset strategies and returns the smallest valid stream.
+		// dictionary-reset strategies and returns the smallest valid stream. One of
+		// them places the resets by dynamic programming over candidate positions.
 		// Supplying the original stream also lets the optimiser reuse its exact
 		// reset layout, and preserves it byte-for-byte when the payload is unchanged.
+		// Strategies are encoded on num_threads threads (0 = one per core); the result
+		// does not depend on the thread count.
 		static Compressed2CompressionResult Compress(
 			const std::vector<Uint8>& source,
-			const std::vector<Uint8>& original_stream = {}
+			const std::vector<Uint8>& original_stream = {},
+			unsigned int num_threads = 0
+		);
+
+		// Re-encodes only the segments of original_stream (the runs between its CLEAR
+		// tokens) whose bytes differ from source, and splices them between the original
+		// bits of the others, so the cost follows the size of the edit. Every spliced run
+		// is decoded again on its own. The result can be larger than a full Compress, and
+		// baseline_size is not measured. Returns nothing if original_stream does not decode
+		// to a payload of the same size as source.
+		static std::optional<Compressed2CompressionResult> CompressIncremental(
+			const std::vector<Uint8>& source,
+			const std::vector<Uint8>& original_stream
 		);
 
-		// Independent decoder used both for validation and for measuring the exact
-		// byte length of an existing bit-packed stream. consumed_size is rounded up
-		// to include the final partial byte containing the END token.
+		// Decodes through Compressed2Decoder; used both for validation and for measuring
+		// the exact byte length of an existing bit-packed stream. consumed_size is rounded
+		// up to include the final partial byte containing the END token.
 		static bool Decode(
-			const std::vector<Uint8>& input,
+			ByteSpan input,
+			std::size_t offset,
+			std::vector<Uint8>& output,
+			std::string& error,
+			std::size_t* consumed_size = nullptr,
+			std::vector<std::size_t>* reset_output_positions = nullptr
+		);
+
+		// The original bit-at-a-time decoder with one vector per dictionary entry, kept
+		// as a reference for benchmarking.
+		static bool DecodeReference(
+			ByteSpan input,
 			std::size_t offset,
 			std::vector<Uint8>& output,
 			std::string& error,
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "SDL3/SDL_stdinc.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace spintool::rom
+{
+	// The LZW dictionary of a Compressed2 encoder: maps (code, next byte) to the code of the
+	// longer string. Codes never exceed 0x7FF, so every possible child has a fixed slot in a
+	// dense table, and a lookup is one load with no hashing. Each slot is stamped with the
+	// generation that wrote it, so Clear() only bumps the generation instead of touching the
+	// table. One trie is meant to be kept per thread and reused for every stream it encodes.
+	class Compressed2Trie
+	{
+	public:
+		static constexpr Uint16 s_no_child = 0;
+		static constexpr std::size_t s_max_codes = 0x800;
+
+		Compressed2Trie();
+
+		void Clear();
+
+		[[nodiscard]] Uint16 Find(Uint16 code, Uint8 byte) const
+		{
+			const Uint32 slot = m_slots[Index(code, byte)];
+			return (slot >> 16) == m_generation ? static_cast<Uint16>(slot & 0xFFFF) : s_no_child;
+		}
+
+		// child must not be s_no_child; an existing child of (code, byte) is replaced.
+		void Insert(Uint16 code, Uint8 byte, Uint16 child)
+		{
+			m_slots[Index(code, byte)] = (m_generation << 16) | child;
+		}
+
+	private:
+		[[nodiscard]] static std::size_t Index(Uint16 code, Uint8 byte)
+		{
+			return (static_cast<std::size_t>(code) << 8) | byte;
+		}
+
+		std::vector<Uint32> m_slots; // generation << 16 | child code
+		Uint32 m_generation = 1;
+	};
+}
@@ -11,6 +11,8 @@
 namespace spintool::rom
 {
 	class SpinballROM;
+	class ROMCursor;
+	class ROMWriter;
 }
 
 namespace spintool::rom
@@ -42,7 +44,9 @@ namespace spintool::rom
 		bool operator==(const CollisionSpline& rhs) const;
 
 		static CollisionSpline LoadFromROM(const SpinballROM& rom, Ptr32 offset);
+		static CollisionSpline LoadFromROM(ROMCursor& cursor);
 		Ptr32 SaveToROM(SpinballROM& rom, Ptr32 offset) const;
+		void SaveToROM(ROMWriter& writer) const;
 	};
 
 	struct SplineCullingCell
@@ -60,6 +64,10 @@ namespace spintool::rom
 		std::array<SplineCullingCell, cells_count> cells;
 
 		[[nodiscard]] Uint32 CalculateTableSize() const;
+		// Exact number of bytes SaveToROM writes: jump table, per-cell counts and splines, terminator.
+		[[nodiscard]] Uint32 GetSizeOnROM() const;
+		// Extent of the table currently stored at offset, including the final cell.
+		[[nodiscard]] static ROMData MeasureOnROM(const SpinballROM& rom, Ptr32 offset);
 
 		static SplineCullingTable LoadFromROM(const SpinballROM& rom, Ptr32 offset);
 		Ptr32 SaveToROM(SpinballROM& rom, Ptr32 offset) const;
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "SDL3/SDL_stdinc.h"
+
+#include <cstddef>
+#include <map>
+#include <vector>
+
+namespace spintool::rom
+{
+	struct DirtyRange
+	{
+		Uint32 begin = 0;
+		Uint32 end = 0; // exclusive
+
+		[[nodiscard]] Uint32 Size() const { return end - begin; }
+	};
+
+	[[nodiscard]] bool RangesOverlap(const std::vector<DirtyRange>& ranges, Uint32 begin, Uint32 end);
+
+	// Ordered set of half-open byte ranges. Overlapping and touching ranges are merged
+	// on insertion, so the set always holds the minimal number of disjoint ranges.
+	class DirtyRangeSet
+	{
+	public:
+		void Add(Uint32 begin, Uint32 end);
+		void Clear();
+
+		[[nodiscard]] bool Empty() const { return m_ranges.empty(); }
+		[[nodiscard]] std::size_t NumRanges() const { return m_ranges.size(); }
+		[[nodiscard]] std::size_t TotalBytes() const { return m_total_bytes; }
+		[[nodiscard]] bool Overlaps(Uint32 begin, Uint32 end) const;
+		[[nodiscard]] std::vector<DirtyRange> GetRanges() const;
+
+	private:
+		std::map<Uint32, Uint32> m_ranges; // begin -> end
+		std::size_t m_total_bytes = 0;
+	};
+}
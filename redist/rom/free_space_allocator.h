@@ -0,0 +1,107 @@
+#pragma once
+
+#include "rom/rom_data.h"
+#include "types/rom_ptr.h"
+
+#include "SDL3/SDL_stdinc.h"
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <optional>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace spintool::rom
+{
+	class SpinballROM;
+}
+
+namespace spintool::rom
+{
+	struct FreeSpaceSettings
+	{
+		// The image may grow up to this size when an asset needs a new home. Mega Drive
+		// cartridges without a mapper top out at 4 MB.
+		Uint32 expanded_size = 0x200000;
+		// A run of this byte at least min_padding_run long at the end of the image is unused.
+		Uint8 padding_byte = 0xFF;
+		Uint32 min_padding_run = 0x100;
+
+		static constexpr Uint32 s_max_expanded_size = 0x400000;
+	};
+
+	// Set of free half-open byte ranges. Ranges are indexed both by offset (for merging
+	// and splitting) and by size (for best-fit allocation), so every operation is
+	// O(log n) in the number of free ranges.
+	class FreeSpaceAllocator
+	{
+	public:
+		void Clear();
+		void Release(Uint32 begin, Uint32 end);
+		void Reserve(Uint32 begin, Uint32 end);
+
+		// Takes the smallest free range that can hold size bytes at the requested alignment.
+		[[nodiscard]] std::optional<Uint32> Allocate(Uint32 size, Uint32 alignment = 2);
+
+		[[nodiscard]] bool IsFree(Uint32 begin, Uint32 end) const;
+		[[nodiscard]] std::size_t NumRanges() const { return m_ranges.size(); }
+		[[nodiscard]] std::size_t TotalFree() const { return m_total_free; }
+		[[nodiscard]] Uint32 LargestFree() const;
+
+	private:
+		void Insert(Uint32 begin, Uint32 end);
+		std::map<Uint32, Uint32>::iterator Erase(std::map<Uint32, Uint32>::iterator it);
+
+		std::map<Uint32, Uint32> m_ranges; // begin -> end
+		std::set<std::pair<Uint32, Uint32>> m_by_size; // (size, begin)
+		std::size_t m_total_free = 0;
+	};
+
+	// Writes assets that may have outgrown their original slot. The free-space map is built
+	// from the padding at the end of the image plus the room between the end of the image and
+	// FreeSpaceSettings::expanded_size, minus the known asset extents and every asset in the
+	// ROM's asset index. Padding runs inside the image are never counted, since data nothing
+	// has decoded yet can look the same. Space an asset gives up is overwritten with the
+	// padding byte and becomes free for this relocator, except where it overlaps an asset
+	// that is still live.
+	class AssetRelocator
+	{
+	public:
+		// Writes the asset at the offset it is given and returns the offset one past its end.
+		using AssetWriter = std::function<Ptr32(SpinballROM& rom, Ptr32 offset)>;
+
+		AssetRelocator(SpinballROM& rom, const std::vector<ROMData>& known_assets);
+
+		// Writes an asset that currently occupies current_extent and now needs new_size
+		// bytes. It is rewritten in place if it still fits, otherwise it moves to free space
+		// and every big-endian pointer at pointer_locations is redirected to it. Returns the
+		// offset the asset was written to.
+		std::optional<Ptr32> SaveAsset(
+			const ROMData& current_extent,
+			Uint32 new_size,
+			const std::vector<Uint32>& pointer_locations,
+			const AssetWriter& writer
+		);
+
+		// Lower-level pieces of SaveAsset for callers that manage their own in-place writes.
+		[[nodiscard]] std::optional<Ptr32> Allocate(Uint32 size, Uint32 alignment = 2);
+		// Frees what an asset occupied. Known assets lying wholly inside [begin, end) are
+		// taken to be that asset and forgotten; bytes any other live asset covers are kept.
+		void Release(Uint32 begin, Uint32 end);
+		[[nodiscard]] bool CanRepoint(const std::vector<Uint32>& pointer_locations, Ptr32 old_offset) const;
+		void Repoint(const std::vector<Uint32>& pointer_locations, Ptr32 new_offset);
+
+		[[nodiscard]] const FreeSpaceAllocator& GetAllocator() const { return m_allocator; }
+
+	private:
+		bool GrowImageToFit(Uint32 end);
+		// The asset at from now occupies to, so it no longer protects the bytes it left.
+		void MoveLiveAsset(const ROMData& from, const ROMData& to);
+
+		SpinballROM& m_rom;
+		FreeSpaceAllocator m_allocator;
+		std::vector<ROMData> m_live_assets;
+	};
+}
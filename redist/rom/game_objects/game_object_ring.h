@@ -6,6 +6,8 @@
 namespace spintool::rom
 {
 	class SpinballROM;
+	class ROMCursor;
+	class ROMWriter;
 }
 
 namespace spintool::rom
@@ -27,6 +29,8 @@ namespace spintool::rom
 		Point draw_pos_offset{ -8 , -16 };
 
 		static RingInstance LoadFromROM(const rom::SpinballROM& rom, Uint32 offset);
+		static RingInstance LoadFromROM(ROMCursor& cursor);
 		Uint32 SaveToROM(rom::SpinballROM& writeable_rom) const;
+		void SaveToROM(ROMWriter& writer) const;
 	};
 }
\ No newline at end of file
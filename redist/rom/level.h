@@ -8,6 +8,7 @@
 #include "rom/palette.h"
 
 #include "rom/rom_asset_definitions.h"
+#include "rom/ssc_compressor.h"
 #include "types/rom_ptr.h"
 
 #include <string>
@@ -50,5 +51,30 @@ namespace spintool::rom
 
 		static Level LoadFromROM(const rom::SpinballROM& rom, int level_index);
 		rom::Ptr32 SaveToROM(rom::SpinballROM& rom) const;
+		struct TilesetSaveStats
+		{
+			rom::Ptr32 rom_offset = 0; // Where the tileset was before it was saved
+			std::size_t previous_size = 0;
+			rom::SSCCompressionStats compression;
+		};
+
+		// Recompresses both tilesets, moving any that no longer fit into free space.
+		// out_stats receives one entry per tileset that was recompressed.
+		bool SaveTilesetsToROM(rom::SpinballROM& rom, std::vector<TilesetSaveStats>* out_stats = nullptr) const;
+		// Writes both tile layers' brushes and layouts, moving brushes that no longer fit.
+		bool SaveTileLayersToROM(rom::SpinballROM& rom) const;
+		// Reorders the tiles of each tileset so it compresses smaller, and rewrites the tile
+		// indices in that layer's layout to match; nothing looks any different. Tile 0 keeps
+		// its place, and tilesets or brushes shared with another level are left alone. Only
+		// this level's layouts are rewritten, so this is opt-in and must be followed by
+		// SaveTilesetsToROM and SaveTileLayersToROM. Returns the number of bytes saved.
+		std::size_t OptimiseTileOrder(const rom::SpinballROM& rom);
+
+		// Extents of every level asset reachable from the level tables, so relocation
+		// never treats them as free space. A brush table shared between layers is as long
+		// as the most any of their layouts uses.
+		[[nodiscard]] static std::vector<rom::ROMData> CollectAssetExtents(const rom::SpinballROM& rom);
+		// The same for one level only.
+		[[nodiscard]] static std::vector<rom::ROMData> CollectAssetExtents(const rom::SpinballROM& rom, int level_index);
 	};
 }
\ No newline at end of file
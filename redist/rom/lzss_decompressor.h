@@ -1,6 +1,7 @@
 #pragma once
 
 #include "rom_data.h"
+#include "types/byte_span.h"
 #include "types/decompression_result.h"
 
 #include "SDL3/SDL_stdinc.h"
@@ -15,8 +16,15 @@ namespace spintool::rom
 	class LZSSDecompressor
 	{
 	public:
-		static LZSSDecompressionResult DecompressData(const std::vector<Uint8>& in_data, Uint32 offset);
-		static LZSSDecompressionResult DecompressDataRefactored(const std::vector<Uint8>& in_data, Uint32 offset);
+		// Line-by-line port of the game's 68k routine. It reads its bit mask table from the
+		// ROM image itself, so it only works on a full USA ROM; kept as a reference.
+		static LZSSDecompressionResult DecompressData(ByteSpan in_data, Uint32 offset);
+		// Bounds-checked port of the same register logic, kept as a reference.
+		static LZSSDecompressionResult DecompressDataRefactored(ByteSpan in_data, Uint32 offset);
+		// Same results as the ports above, decoded by Compressed2Decoder. The output starts
+		// with the two bytes the game rewrites in front of the target VRAM address, and like
+		// the game's word writes it drops a trailing odd byte.
+		static LZSSDecompressionResult DecompressDataFast(ByteSpan in_data, Uint32 offset);
 	private:
 	};
 }
\ No newline at end of file
@@ -1,9 +1,12 @@
 #pragma once
 
 #include "rom_asset_definitions.h"
+#include "rom/rom_hash.h"
+#include "types/byte_span.h"
 
 #include <array>
 #include <filesystem>
+#include <optional>
 #include <vector>
 
 #include "json_fwd.hpp"
@@ -34,6 +37,7 @@ namespace spintool::rom
 
         std::string version_id = "unknown";
         std::filesystem::path location_on_disk;
+        std::optional<ROMHash> content_hash; // Of the reference ROM last identified as this version
         LevelDataTableOffsets level_data_table_offsets;
         std::array<LevelMetadata, 4> level_data_offsets;
 
@@ -48,5 +52,11 @@ namespace spintool::rom
         Metadata();
 
         ROMMetadata* GetROMMetadataFor(std::string_view version_id);
+        ROMMetadata* GetROMMetadataFor(const ROMHash& content_hash);
+
+        // Picks the entry for a reference ROM. A known hash wins; otherwise the region
+        // code in the cartridge header chooses the version and the hash is remembered
+        // for next time.
+        ROMMetadata* IdentifyROM(ByteSpan image, const ROMHash& content_hash);
     };
 }
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "rom/dirty_range_set.h"
+#include "types/byte_span.h"
+
+#include "SDL3/SDL_stdinc.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace spintool::rom
+{
+	struct PointerReference
+	{
+		Uint32 source = 0; // Offset of the big-endian longword
+		Uint32 target = 0; // Its value
+	};
+
+	enum class PointerAlignment : Uint8
+	{
+		Even, // Where the 68000 can read a longword from
+		Any
+	};
+
+	// Reverse index of every big-endian longword in the image whose value falls inside a set
+	// of target ranges, so relocating an asset can find what points at it. Nothing here knows
+	// which longwords really are pointers: data that happens to hold such a value shows up
+	// too, and callers decide what to trust.
+	//
+	// Scan tests the high word of a block of offsets at once (SSE2 where available) against
+	// the bounds of the target set, and only survivors are read in full. Build spreads the
+	// image over every core in fixed chunks. Writes only mark their bytes stale; the next
+	// query rescans the offsets whose longword overlaps them and merges what it finds into
+	// the two sorted lists, so the index stays current without another full pass.
+	class PointerIndex
+	{
+	public:
+		// Replaces the targets and drops the index; the next query rebuilds it.
+		void SetTargets(const std::vector<DirtyRange>& targets, PointerAlignment alignment);
+		void Clear();
+
+		// Appends every reference in [begin, end) to references, in source order.
+		static void Scan(ByteSpan image, Uint32 begin, Uint32 end, const std::vector<DirtyRange>& targets, PointerAlignment alignment, std::vector<PointerReference>& references);
+
+		void Build(ByteSpan image);
+		void NotifyWrite(Uint32 begin, Uint32 end);
+		// Rebuilds or rescans whatever went stale. Queries call this first.
+		void Refresh(ByteSpan image);
+
+		[[nodiscard]] bool IsBuilt() const { return m_built; }
+		[[nodiscard]] std::size_t Size() const { return m_by_target.size(); }
+		// Sources of every longword whose value is exactly target, in source order.
+		[[nodiscard]] std::vector<Uint32> FindReferencesTo(Uint32 target) const;
+		// Every reference whose value falls in [begin, end), in target order.
+		[[nodiscard]] std::vector<PointerReference> FindReferencesInto(Uint32 begin, Uint32 end) const;
+
+		static constexpr Uint32 s_chunk_bytes = 0x10000;
+		// Offsets whose high words are tested together.
+		static constexpr std::size_t s_block_size = 16;
+
+	private:
+		std::vector<DirtyRange> m_targets;
+		PointerAlignment m_alignment = PointerAlignment::Even;
+		bool m_built = false;
+		DirtyRangeSet m_stale;
+		std::vector<PointerReference> m_by_source;
+		std::vector<PointerReference> m_by_target; // Then by source
+	};
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "rom/rom_data.h"
+
+#include "SDL3/SDL_stdinc.h"
+
+#include <cstddef>
+#include <mutex>
+#include <set>
+#include <tuple>
+#include <vector>
+
+namespace spintool::rom
+{
+	enum class ROMAssetType : Uint8
+	{
+		Sprite,
+		Tileset,
+		AnimationSequence,
+		CollisionSpline,
+		TileLayout,
+		Palette
+	};
+
+	[[nodiscard]] const char* GetAssetTypeName(ROMAssetType type);
+
+	struct ROMAssetRef
+	{
+		ROMAssetType type = ROMAssetType::Sprite;
+		ROMData rom_data;
+
+		[[nodiscard]] bool operator<(const ROMAssetRef& rhs) const
+		{
+			return std::tie(rom_data.rom_offset, rom_data.rom_offset_end, type)
+				< std::tie(rhs.rom_data.rom_offset, rhs.rom_data.rom_offset_end, rhs.type);
+		}
+	};
+
+	// Answers "which decoded assets own this byte?". Loaders register the extent of every
+	// asset they decode; an asset is identified by its type and start offset, so decoding
+	// it again after an edit replaces the old extent. Queries run on an interval tree laid
+	// out over the entries sorted by start offset, where every node also holds the largest
+	// end offset in its subtree, so a lookup costs O(log n + k). The tree is rebuilt lazily
+	// on the first query after a change.
+	class ROMAssetIndex
+	{
+	public:
+		void Register(ROMAssetType type, const ROMData& rom_data);
+		void Unregister(ROMAssetType type, const ROMData& rom_data);
+		// Drops and returns every asset overlapping [begin, end), whose decoded form may no
+		// longer match the bytes.
+		std::vector<ROMAssetRef> Invalidate(Uint32 begin, Uint32 end);
+		// Follows an asset that moved: everything inside from is shifted to start at
+		// to.rom_offset, and an entry covering exactly from takes on to's size.
+		void Relocate(const ROMData& from, const ROMData& to);
+		void Clear();
+
+		// Indices attached to read-only copies of the ROM (see ROMSnapshot) ignore registrations.
+		void SetEnabled(bool enabled);
+
+		[[nodiscard]] std::vector<ROMAssetRef> FindAt(Uint32 offset) const;
+		[[nodiscard]] std::vector<ROMAssetRef> FindOverlapping(Uint32 begin, Uint32 end) const;
+		[[nodiscard]] std::size_t Size() const;
+
+	private:
+		std::vector<ROMAssetRef> FindOverlappingLocked(Uint32 begin, Uint32 end) const;
+		void RebuildTree() const;
+		Uint32 BuildSubtree(std::size_t begin, std::size_t end) const;
+		void QuerySubtree(std::size_t begin, std::size_t end, Uint32 query_begin, Uint32 query_end, std::vector<ROMAssetRef>& results) const;
+
+		mutable std::mutex m_mutex;
+		std::set<ROMAssetRef> m_entries;
+		bool m_enabled = true;
+
+		mutable std::vector<ROMAssetRef> m_tree; // m_entries in order; node of [begin, end) is the midpoint
+		mutable std::vector<Uint32> m_subtree_max_end;
+		mutable bool m_tree_dirty = false;
+	};
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "types/byte_span.h"
+
+#include "SDL3/SDL_stdinc.h"
+
+#include <cstddef>
+#include <filesystem>
+#include <vector>
+
+namespace spintool::rom
+{
+	// Backing storage for the working ROM image.
+	//
+	// The file is mapped read-only and private, so opening a ROM costs no copy and
+	// untouched pages stay shared with the OS page cache. The first write to a page
+	// promotes just that page to writable; the kernel then copies it on write, so the
+	// set of promoted pages forms a copy-on-write overlay over the pristine file.
+	// When the platform cannot map the file the buffer falls back to owning a copy.
+	//
+	// Readers only ever see a const view. Mutable access goes through GetWritableRange,
+	// which SpinballROM uses for its write API.
+	class ROMBuffer
+	{
+	public:
+		ROMBuffer() = default;
+		~ROMBuffer();
+
+		ROMBuffer(const ROMBuffer&) = delete;
+		ROMBuffer& operator=(const ROMBuffer&) = delete;
+		ROMBuffer(ROMBuffer&& other) noexcept;
+		ROMBuffer& operator=(ROMBuffer&& other) noexcept;
+
+		bool MapFile(const std::filesystem::path& path);
+		void Assign(ByteSpan bytes);
+		void Resize(std::size_t new_size, Uint8 fill_value = 0x00);
+		void Clear();
+
+		// Stops referencing the mapped file, keeping the current contents in owned memory.
+		// Needed before the file on disk can be replaced on platforms that lock mapped files.
+		void DetachFromFile();
+
+		// Returns nullptr if the range does not fit inside the buffer.
+		[[nodiscard]] Uint8* GetWritableRange(std::size_t offset, std::size_t count);
+
+		[[nodiscard]] const Uint8* data() const { return m_view; }
+		[[nodiscard]] std::size_t size() const { return m_size; }
+		[[nodiscard]] bool empty() const { return m_size == 0; }
+		[[nodiscard]] const Uint8& operator[](std::size_t index) const { return m_view[index]; }
+		[[nodiscard]] const Uint8* begin() const { return m_view; }
+		[[nodiscard]] const Uint8* end() const { return m_view + m_size; }
+
+		[[nodiscard]] bool IsMapped() const { return m_mapping != nullptr; }
+		[[nodiscard]] std::size_t GetOverlayPageCount() const { return m_overlay_page_count; }
+		[[nodiscard]] static std::size_t GetPageSize();
+
+	private:
+		bool PromotePages(std::size_t first_page, std::size_t last_page);
+		void Unmap();
+
+		const Uint8* m_view = nullptr;
+		std::size_t m_size = 0;
+
+		std::vector<Uint8> m_owned;
+
+		void* m_mapping = nullptr;
+		void* m_mapping_handle = nullptr;
+		std::vector<bool> m_overlay_pages;
+		std::size_t m_overlay_page_count = 0;
+	};
+
+	[[nodiscard]] bool operator==(const ROMBuffer& lhs, const std::vector<Uint8>& rhs);
+	[[nodiscard]] bool operator!=(const ROMBuffer& lhs, const std::vector<Uint8>& rhs);
+	[[nodiscard]] inline bool operator==(const std::vector<Uint8>& lhs, const ROMBuffer& rhs) { return rhs == lhs; }
+	[[nodiscard]] inline bool operator!=(const std::vector<Uint8>& lhs, const ROMBuffer& rhs) { return rhs != lhs; }
+}
@@ -0,0 +1,181 @@
+#pragma once
+
+#include "types/byte_span.h"
+
+#include "SDL3/SDL_stdinc.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace spintool::rom
+{
+	class SpinballROM;
+}
+
+namespace spintool::rom
+{
+	// A range of the ROM image that has been bounds checked once, up front. Reads inside
+	// the span need no further checks, so loaders validate a whole struct or array and
+	// then decode it in one go.
+	class ROMSpan
+	{
+	public:
+		ROMSpan() = default;
+		// Invalid (and empty) if [offset, offset + size) is not entirely inside image.
+		ROMSpan(ByteSpan image, Uint32 offset, Uint32 size);
+
+		[[nodiscard]] bool IsValid() const { return m_valid; }
+		[[nodiscard]] Uint32 GetOffset() const { return m_offset; }
+		[[nodiscard]] Uint32 GetEndOffset() const { return m_offset + static_cast<Uint32>(m_bytes.size()); }
+		[[nodiscard]] Uint32 Size() const { return static_cast<Uint32>(m_bytes.size()); }
+		[[nodiscard]] ByteSpan Bytes() const { return m_bytes; }
+
+		// Offsets are relative to the start of the span and must be inside it.
+		[[nodiscard]] Uint8 Uint8At(Uint32 relative_offset) const { return m_bytes[relative_offset]; }
+		[[nodiscard]] Uint16 Uint16At(Uint32 relative_offset) const
+		{
+			return static_cast<Uint16>((m_bytes[relative_offset] << 8) | m_bytes[relative_offset + 1]);
+		}
+
+		[[nodiscard]] Uint32 Uint32At(Uint32 relative_offset) const
+		{
+			return (static_cast<Uint32>(m_bytes[relative_offset]) << 24)
+				| (static_cast<Uint32>(m_bytes[relative_offset + 1]) << 16)
+				| (static_cast<Uint32>(m_bytes[relative_offset + 2]) << 8)
+				| static_cast<Uint32>(m_bytes[relative_offset + 3]);
+		}
+
+		// Decodes count consecutive big-endian words starting at relative_offset.
+		void ReadUint16Array(Uint32 relative_offset, Uint16* out, std::size_t count) const
+		{
+			const Uint8* source = m_bytes.data() + relative_offset;
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				out[i] = static_cast<Uint16>((source[i * 2] << 8) | source[i * 2 + 1]);
+			}
+		}
+
+	private:
+		ByteSpan m_bytes;
+		Uint32 m_offset = 0;
+		bool m_valid = false;
+	};
+
+	// Sequential big-endian reader. Each read checks the remaining length with a single
+	// compare; reading past the end yields zeroes and latches HasFailed(), so a loader can
+	// decode a whole record and test once at the end. ReadUint16s/ReadUint16Array check a
+	// whole group of fields at once. The reads are defined here so decode loops inline them.
+	class ROMCursor
+	{
+	public:
+		ROMCursor() = default;
+		explicit ROMCursor(const ROMSpan& span);
+
+		Uint8 ReadUint8()
+		{
+			if (!Take(1))
+			{
+				return 0;
+			}
+			return m_span.Uint8At(m_position++);
+		}
+
+		Uint16 ReadUint16()
+		{
+			if (!Take(2))
+			{
+				return 0;
+			}
+			const Uint16 value = m_span.Uint16At(m_position);
+			m_position += 2;
+			return value;
+		}
+
+		Uint32 ReadUint32()
+		{
+			if (!Take(4))
+			{
+				return 0;
+			}
+			const Uint32 value = m_span.Uint32At(m_position);
+			m_position += 4;
+			return value;
+		}
+
+		bool ReadUint16Array(Uint16* out, std::size_t count)
+		{
+			if (count > Remaining() / 2 || !Take(static_cast<Uint32>(count * 2)))
+			{
+				m_failed = true;
+				std::fill(out, out + count, static_cast<Uint16>(0));
+				return false;
+			}
+			m_span.ReadUint16Array(m_position, out, count);
+			m_position += static_cast<Uint32>(count * 2);
+			return true;
+		}
+
+		void Skip(Uint32 count)
+		{
+			if (Take(count))
+			{
+				m_position += count;
+			}
+		}
+
+		template<std::size_t Count>
+		std::array<Uint16, Count> ReadUint16s()
+		{
+			std::array<Uint16, Count> values{};
+			ReadUint16Array(values.data(), Count);
+			return values;
+		}
+
+		[[nodiscard]] Uint32 GetOffset() const { return m_span.GetOffset() + m_position; }
+		[[nodiscard]] Uint32 Remaining() const { return m_span.Size() - m_position; }
+		[[nodiscard]] bool HasFailed() const { return m_failed; }
+
+	private:
+		bool Take(Uint32 count)
+		{
+			if (m_failed || count > Remaining())
+			{
+				m_failed = true;
+				return false;
+			}
+			return true;
+		}
+
+		ROMSpan m_span;
+		Uint32 m_position = 0;
+		bool m_failed = false;
+	};
+
+	// Collects big-endian fields into a local buffer and hands them to the ROM as one
+	// WriteBytes call, so dirty tracking, the undo journal and the checksum update see a
+	// single write instead of one per field.
+	class ROMWriter
+	{
+	public:
+		explicit ROMWriter(Uint32 offset);
+
+		void WriteUint8(Uint8 value);
+		void WriteUint16(Uint16 value);
+		void WriteUint32(Uint32 value);
+		void WriteBytes(ByteSpan bytes);
+		void Reserve(std::size_t count) { m_bytes.reserve(count); }
+
+		// Absolute ROM offset the next field will be written to.
+		[[nodiscard]] Uint32 GetOffset() const { return m_offset + static_cast<Uint32>(m_bytes.size()); }
+		[[nodiscard]] ByteSpan GetBytes() const { return m_bytes; }
+
+		// Writes everything collected so far and returns the offset one past the end.
+		Uint32 Commit(SpinballROM& rom);
+
+	private:
+		Uint32 m_offset = 0;
+		std::vector<Uint8> m_bytes;
+	};
+}
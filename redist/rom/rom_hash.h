@@ -0,0 +1,32 @@
+#pragma once
+
+#include "types/byte_span.h"
+
+#include "SDL3/SDL_stdinc.h"
+
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace spintool::rom
+{
+	// Content identity of a ROM image. The image is cut into fixed 256 KB chunks that are
+	// hashed with XXH64 in parallel; the chunk digests are then hashed again together with
+	// the image size. The chunk size is part of the definition, so the value does not
+	// depend on how many threads computed it and can be stored in config files and used
+	// to key anything cached per ROM.
+	struct ROMHash
+	{
+		Uint64 value = 0;
+
+		[[nodiscard]] std::string ToString() const;
+		[[nodiscard]] static std::optional<ROMHash> FromString(std::string_view text);
+
+		[[nodiscard]] bool operator==(const ROMHash& rhs) const { return value == rhs.value; }
+		[[nodiscard]] bool operator!=(const ROMHash& rhs) const { return value != rhs.value; }
+	};
+
+	[[nodiscard]] ROMHash ComputeROMHash(ByteSpan image);
+	// Plain single-threaded XXH64, for hashing small ranges of the image.
+	[[nodiscard]] Uint64 HashBytes(ByteSpan bytes, Uint64 seed = 0);
+}
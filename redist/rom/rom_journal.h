@@ -0,0 +1,103 @@
+#pragma once
+
+#include "types/byte_span.h"
+#include "rom/dirty_range_set.h"
+
+#include "SDL3/SDL_stdinc.h"
+
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace spintool::rom
+{
+	// One contiguous change: the bytes at offset before and after the write.
+	// While its transaction is open the bytes are stored raw so later writes can be
+	// coalesced into it. Sealing run-length packs both sides.
+	// A delta that changes the size of the image covers the bytes past the shorter of the
+	// two sizes: old_bytes holds the tail a shrink cut off, new_bytes the tail a grow added.
+	struct JournalDelta
+	{
+		Uint32 offset = 0;
+		Uint32 size = 0;
+		std::vector<Uint8> old_bytes;
+		std::vector<Uint8> new_bytes;
+		Uint32 old_image_size = 0;
+		Uint32 new_image_size = 0;
+		bool packed = false;
+
+		[[nodiscard]] bool IsResize() const { return old_image_size != new_image_size; }
+
+		[[nodiscard]] std::vector<Uint8> GetOldBytes() const;
+		[[nodiscard]] std::vector<Uint8> GetNewBytes() const;
+		[[nodiscard]] size_t GetMemoryUsage() const;
+	};
+
+	struct JournalTransaction
+	{
+		std::string name;
+		std::vector<JournalDelta> deltas;
+		std::chrono::steady_clock::time_point last_write_time;
+		bool implicit = false;
+
+		[[nodiscard]] std::vector<DirtyRange> GetRanges() const;
+		[[nodiscard]] size_t GetMemoryUsage() const;
+	};
+
+	// Undo/redo history for every byte written to the working ROM.
+	//
+	// Writes are grouped into named transactions. Writes made outside an explicit
+	// transaction are gathered into an implicit one, closed by the next explicit
+	// transaction, undo/redo or save. Consecutive transactions with the same name that
+	// follow each other quickly (e.g. dragging an object) are merged into one step.
+	// History is bounded by a byte budget and a transaction count; the oldest steps are
+	// dropped first.
+	class ROMJournal
+	{
+	public:
+		void BeginTransaction(std::string name);
+		void EndTransaction();
+		void SealImplicitTransaction();
+		void Record(Uint32 offset, ByteSpan old_bytes, ByteSpan new_bytes);
+		// removed_tail holds the bytes a shrink cuts off, added_tail the bytes a grow adds.
+		void RecordResize(Uint32 old_size, Uint32 new_size, ByteSpan removed_tail, ByteSpan added_tail);
+		// Removes the deltas written since the open explicit transaction began and returns
+		// them in the order they were made, so the caller can revert them.
+		[[nodiscard]] std::vector<JournalDelta> DiscardOpenWrites();
+		void Clear();
+
+		[[nodiscard]] bool CanUndo() const;
+		[[nodiscard]] bool CanRedo() const;
+		[[nodiscard]] const std::string& GetUndoName() const;
+		[[nodiscard]] const std::string& GetRedoName() const;
+		[[nodiscard]] const JournalTransaction* PeekUndo() const;
+		[[nodiscard]] const JournalTransaction* PeekRedo() const;
+		void CommitUndo();
+		void CommitRedo();
+
+		[[nodiscard]] size_t GetNumUndoSteps() const { return m_undo_stack.size(); }
+		[[nodiscard]] size_t GetNumRedoSteps() const { return m_redo_stack.size(); }
+		[[nodiscard]] size_t GetMemoryUsage() const { return m_memory_usage; }
+
+		size_t m_max_memory_usage = 32 * 1024 * 1024;
+		size_t m_max_transactions = 512;
+		std::chrono::milliseconds m_coalesce_window{ 750 };
+
+	private:
+		JournalTransaction& OpenTransactionForWrite();
+		void Seal(JournalTransaction& transaction);
+		void TrimHistory();
+		void ClearRedo();
+
+		std::deque<JournalTransaction> m_undo_stack;
+		std::vector<JournalTransaction> m_redo_stack;
+		std::string m_open_name;
+		int m_transaction_depth = 0;
+		bool m_implicit_open = false;
+		bool m_explicit_open = false;
+		size_t m_open_delta_start = 0; // First delta of the open transaction written in this scope
+		size_t m_memory_usage = 0;
+	};
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "rom/spinball_rom.h"
+
+#include "SDL3/SDL_stdinc.h"
+
+#include <memory>
+
+namespace spintool::rom
+{
+	// Immutable copy of the ROM image as it was at one version. Background jobs pin a
+	// snapshot for their whole lifetime through the shared_ptr, so edits, resizes and
+	// reloads of the live ROM never tear or unmap what they are reading, and they never
+	// have to take a lock to read it. The wrapped SpinballROM only carries the image and
+	// its path; palettes, history and dirty state stay with the live ROM.
+	class ROMSnapshot
+	{
+	public:
+		ROMSnapshot(const SpinballROM& source, Uint64 version);
+
+		ROMSnapshot(const ROMSnapshot&) = delete;
+		ROMSnapshot& operator=(const ROMSnapshot&) = delete;
+
+		[[nodiscard]] const SpinballROM& GetROM() const { return m_rom; }
+		[[nodiscard]] Uint64 GetVersion() const { return m_version; }
+
+	private:
+		SpinballROM m_rom;
+		Uint64 m_version = 0;
+	};
+}
@@ -2,7 +2,16 @@
 
 #include "types/sdl_handle_defs.h"
 #include "types/bounding_box.h"
+#include "types/byte_span.h"
 #include "render.h"
+#include "rom/rom_buffer.h"
+#include "rom/dirty_range_set.h"
+#include "rom/free_space_allocator.h"
+#include "rom/rom_journal.h"
+#include "rom/rom_cursor.h"
+#include "rom/rom_asset_index.h"
+#include "rom/pointer_index.h"
+#include "rom/asset_cache.h"
 #include "rom/tileset.h"
 #include "rom/sprite.h"
 #include "rom/palette.h"
@@ -14,9 +23,28 @@
 #include <memory>
 #include <optional>
 #include <filesystem>
+#include <string>
 
 namespace spintool::rom
 {
+	class ROMSnapshot;
+
+	enum class ROMSaveStrategy
+	{
+		AtomicCopy,    // Patch dirty ranges into a copy of the file (a reflink where the filesystem has them), then rename it over the original
+		PatchInPlace   // Write dirty ranges straight into the original file
+	};
+
+	struct ROMSaveStats
+	{
+		bool success = false;
+		bool incremental = false;
+		size_t ranges_written = 0;
+		size_t bytes_written = 0; // Dirty ranges plus bytes_copied
+		size_t bytes_copied = 0;  // Of the file on disk, when AtomicCopy couldn't clone it
+		double milliseconds = 0.0;
+	};
+
 	class SpinballROM
 	{
 	public:
@@ -24,7 +52,14 @@ namespace spintool::rom
 		[[nodiscard]] Uint32 GetOffsetForNextSprite(const rom::Sprite& current_sprite) const;
 		[[nodiscard]] std::vector<std::shared_ptr<rom::Palette>> LoadPalettes(Uint32 num_palettes) const;
 
-		void SaveROM();
+		bool SaveROM();
+		void SetSaveStrategy(ROMSaveStrategy strategy);
+		[[nodiscard]] ROMSaveStrategy GetSaveStrategy() const;
+		[[nodiscard]] const DirtyRangeSet& GetDirtyRanges() const;
+		// Every range written since the last call, undo, redo and resizes included, for views
+		// that keep what they decoded from the image up to date. Saving doesn't clear these.
+		[[nodiscard]] std::vector<DirtyRange> TakeChangedRanges();
+		[[nodiscard]] const ROMSaveStats& GetLastSaveStats() const;
 
 		void RenderToSurface(SDL_Surface* surface, Uint32 offset, Point dimensions) const;
 		void RenderToSurface(SDL_Surface* surface, Uint32 offset, Point dimensions, const rom::Palette& palette) const;
@@ -34,13 +69,65 @@ namespace spintool::rom
 		[[nodiscard]] Uint16 ReadUint16(Uint32 offset) const;
 		[[nodiscard]] Uint32 ReadUint32(Uint32 offset) const;
 
+		// Bounds checked once for the whole range; see rom_cursor.h.
+		[[nodiscard]] ROMSpan GetSpan(Uint32 offset, Uint32 size) const;
+		[[nodiscard]] ROMCursor GetCursor(Uint32 offset, Uint32 size) const;
+		[[nodiscard]] ROMCursor GetCursor(Uint32 offset) const;
+
 		Uint32 WriteUint8(Uint32 offset, Uint8 value);
 		Uint32 WriteUint16(Uint32 offset, Uint16 value);
 		Uint32 WriteUint32(Uint32 offset, Uint32 value);
+		Uint32 WriteBytes(Uint32 offset, ByteSpan bytes);
+		Uint32 FillBytes(Uint32 offset, Uint8 value, Uint32 count);
+		void Resize(Uint32 new_size, Uint8 fill_value = 0x00);
+
+		// Mega Drive header checksum: the 16-bit sum of every big-endian word from 0x200 to
+		// the end of the image, stored at 0x18E. Every write keeps the running sum up to date,
+		// so RefreshChecksum only has to store it. ComputeChecksum does the full pass and is
+		// meant for validation.
+		void RefreshChecksum();
+		[[nodiscard]] Uint16 GetChecksum() const;
+		[[nodiscard]] static Uint16 ComputeChecksum(ByteSpan image);
+		static constexpr Uint32 s_checksum_offset = 0x18E;
+		static constexpr Uint32 s_checksum_range_start = 0x200;
+
+		// Undo/redo. Writes between BeginTransaction/EndTransaction (or inside a ROMTransaction
+		// scope) form one named step. Undo and Redo return the byte ranges they changed so
+		// callers can refresh whatever they decoded from them; they return nothing if the
+		// image no longer matches the journal, in which case the history is discarded.
+		void BeginTransaction(std::string name);
+		void EndTransaction();
+		// Reverts every write made since the open transaction began and leaves it out of the
+		// history, for operations that fail partway through.
+		void RollbackTransaction();
+		std::vector<DirtyRange> Undo();
+		std::vector<DirtyRange> Redo();
+		[[nodiscard]] const ROMJournal& GetJournal() const;
+		ROMJournal& GetJournal();
+
+		// Snapshots for background jobs (see rom_snapshot.h). Every change to the image bumps
+		// the version. GetSnapshot publishes a new snapshot if the image changed since the
+		// last one and returns it, so the image is only copied when a job asks for it after
+		// an edit; it must be called from the thread that writes to the ROM.
+		[[nodiscard]] Uint64 GetVersion() const;
+		[[nodiscard]] std::shared_ptr<const ROMSnapshot> GetSnapshot();
 
-		std::vector<unsigned char> m_buffer;
+		// Extents of every asset decoded from this image. Loaders only get a const ROM, so
+		// registering through a const reference is allowed; the index locks internally.
+		[[nodiscard]] ROMAssetIndex& GetAssetIndex() const;
+		// Decoded data kept across sessions; opened by the editor once the ROM is identified.
+		[[nodiscard]] AssetCache& GetAssetCache() const;
+		// Every even longword pointing past the header into the cartridge's address space.
+		// Built on first use and brought up to date with the writes since the last call.
+		[[nodiscard]] const PointerIndex& GetPointerIndex();
+		static constexpr Uint32 s_pointer_targets_start = 0x200;
+		static constexpr Uint32 s_cartridge_address_end = 0x400000;
+
+		// Read-only view of the image. All modifications go through the Write* functions above.
+		ROMBuffer m_buffer;
 		std::filesystem::path m_filepath;
 		std::vector<std::shared_ptr<rom::Palette>> m_palettes;
+		FreeSpaceSettings m_free_space_settings;
 
 		// Hardcoded resources
 		[[nodiscard]] const std::vector<std::shared_ptr<spintool::rom::Palette>>& GetGlobalPalettes() const;
@@ -48,5 +135,42 @@ namespace spintool::rom
 		[[nodiscard]] std::shared_ptr<rom::PaletteSet> GetIntroCutscenePaletteSet() const;
 		[[nodiscard]] std::shared_ptr<rom::PaletteSet> GetMainMenuPaletteSet() const;
 		[[nodiscard]] std::shared_ptr<rom::PaletteSet> GetSegaLogoIntroPaletteSet() const;
+
+	private:
+		void ApplyWrite(Uint32 offset, ByteSpan bytes);
+		std::vector<DirtyRange> ApplyHistory(const JournalTransaction& transaction, bool undo);
+		[[nodiscard]] bool HistoryDeltaMatches(const JournalDelta& delta, bool undo) const;
+		void ApplyHistoryDelta(const JournalDelta& delta, bool undo);
+
+		DirtyRangeSet m_dirty_ranges;
+		DirtyRangeSet m_changed_ranges;
+		std::filesystem::path m_saved_filepath; // File the dirty ranges are relative to
+		bool m_requires_full_save = false;
+		ROMSaveStrategy m_save_strategy = ROMSaveStrategy::AtomicCopy;
+		ROMSaveStats m_last_save_stats;
+		Uint16 m_checksum = 0;
+		ROMJournal m_journal;
+		bool m_applying_history = false;
+		Uint64 m_version = 0;
+		std::shared_ptr<const ROMSnapshot> m_published_snapshot; // Only touched by GetSnapshot, on the writing thread
+		mutable ROMAssetIndex m_asset_index;
+		mutable AssetCache m_asset_cache;
+		PointerIndex m_pointer_index;
+	};
+
+	// Groups every ROM write made during its lifetime into one named undo step.
+	class ROMTransaction
+	{
+	public:
+		ROMTransaction(SpinballROM& rom, std::string name);
+		~ROMTransaction();
+
+		ROMTransaction(const ROMTransaction&) = delete;
+		ROMTransaction& operator=(const ROMTransaction&) = delete;
+
+		void Rollback();
+
+	private:
+		SpinballROM& m_rom;
 	};
 }
\ No newline at end of file
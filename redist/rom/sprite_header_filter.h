@@ -0,0 +1,49 @@
+#pragma once
+
+#include "types/byte_span.h"
+
+#include "SDL3/SDL_stdinc.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace spintool::rom
+{
+	// Why Sprite::LoadFromROM would turn an offset down, in the order it checks.
+	enum class SpriteHeaderRejection : Uint8
+	{
+		None,
+		OutOfBounds,
+		TileCount,
+		VDPTileCount,
+		TruncatedPieceHeaders,
+		PieceSize,
+		PieceVDPTileCount,
+		TruncatedPixelData
+	};
+
+	[[nodiscard]] const char* GetSpriteHeaderRejectionName(SpriteHeaderRejection rejection);
+
+	// Decides whether a sprite header could start at an offset without building the Sprite.
+	// Almost every offset a scan tries fails on the two fixed header words, so those are
+	// tested for a block of offsets at once (SSE2 where available, SWAR otherwise) and only
+	// survivors have their pieces walked. Check mirrors every test in Sprite::LoadFromROM,
+	// so an offset is a candidate exactly when loading it would succeed.
+	class SpriteHeaderFilter
+	{
+	public:
+		[[nodiscard]] static SpriteHeaderRejection Check(ByteSpan image, Uint32 offset);
+
+		// Appends every candidate in [begin, end] to candidates, in offset order.
+		static void FindCandidates(ByteSpan image, Uint32 begin, Uint32 end, std::vector<Uint32>& candidates);
+
+		// One entry per offset in [begin, end], for diagnostics.
+		[[nodiscard]] static std::vector<SpriteHeaderRejection> Classify(ByteSpan image, Uint32 begin, Uint32 end);
+
+		// Offsets whose fixed header words are tested together.
+		static constexpr std::size_t s_block_size = 16;
+		// The most bytes one sprite can cover: the header, 0x80 piece headers and 0x80 pieces
+		// of 32x32 pixels. An edit can only change what parses at the offsets this far before it.
+		static constexpr Uint32 s_max_sprite_bytes = 4 + 0x80 * 6 + 0x80 * (32 * 32 / 2);
+	};
+}
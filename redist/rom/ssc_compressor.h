@@ -1,6 +1,7 @@
 #pragma once
 
 #include "types/decompression_result.h"
+#include <cstddef>
 #include <vector>
 #include "SDL3/SDL_stdinc.h"
 
@@ -8,9 +9,40 @@ namespace spintool::rom
 {
 	using SSCCompressionResult = std::vector<Uint8>;
 
+	struct SSCCompressionSettings
+	{
+		// Picks tokens by exact cost over the whole input instead of always taking the
+		// longest match. Never produces a larger stream, at roughly twice the time.
+		bool optimal_parse = true;
+		// Candidates visited per position in the match finder's hash chains.
+		Uint32 max_chain_length = 256;
+	};
+
+	struct SSCCompressionStats
+	{
+		std::size_t input_size = 0;
+		std::size_t output_size = 0;
+		std::size_t num_literals = 0;
+		std::size_t num_copies = 0;
+		double milliseconds = 0.0;
+		// False when the round trip through SSCDecompressor failed and literals were emitted instead.
+		bool verified = false;
+
+		[[nodiscard]] double GetRatio() const;
+		[[nodiscard]] double GetMegabytesPerSecond() const;
+	};
+
 	class SSCCompressor
 	{
 	public:
-		static SSCCompressionResult CompressData(const std::vector<Uint8>& in_data, Uint32 offset, Uint32 working_data_size_hint);
+		// Produces the stream SSCDecompressor::DecompressData reads: groups of eight tokens
+		// behind a flag byte (bit set = literal, LSB first), where a copy token is a 12-bit
+		// position in the 4 KB ring plus a 4-bit length - 2, and a copy from position zero
+		// ends the stream. Every result is decoded again before it is returned.
+		static SSCCompressionResult CompressData(
+			const std::vector<Uint8>& in_data,
+			const SSCCompressionSettings& settings = {},
+			SSCCompressionStats* stats = nullptr
+		);
 	};
-}
\ No newline at end of file
+}
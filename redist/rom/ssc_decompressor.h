@@ -1,9 +1,11 @@
 #pragma once
 
 #include "rom_data.h"
+#include "types/byte_span.h"
 #include "types/decompression_result.h"
 
 #include "SDL3/SDL_stdinc.h"
+#include <cstddef>
 #include <vector>
 #include <optional>
 #include <string>
@@ -15,8 +17,49 @@ namespace spintool::rom
 	class SSCDecompressor
 	{
 	public:
-		static SSCDecompressionResult DecompressData(const std::vector<Uint8>& in_data, Uint32 offset, Uint32 working_data_size_hint);
+		static constexpr std::size_t s_max_output_size = 16U * 1024U * 1024U;
+
+		// Reference decoder: one byte at a time through a separate 4 KB ring, every read checked.
+		static SSCDecompressionResult DecompressData(ByteSpan in_data, Uint32 offset, Uint32 working_data_size_hint);
+		// Same results as DecompressData, including errors. The output doubles as the window
+		// and input bounds are checked once per group of eight tokens. Decoding stops with an
+		// error once more than output_limit bytes come out, so scans can reject a candidate
+		// as soon as it overruns the size they expect.
+		static SSCDecompressionResult DecompressDataFast(ByteSpan in_data, Uint32 offset, Uint32 working_data_size_hint, std::size_t output_limit = s_max_output_size);
 		static SSCDecompressionResult IsValidSSCCompressedData(const Uint8* in_data, Uint32 starting_offset);
 	private:
 	};
+
+	// One SSC stream decoded a piece at a time, with the same output and errors as
+	// DecompressDataFast, which runs through this. DecodeUntil stops at the first group of
+	// eight tokens that takes the output to the requested size, and a later call carries on
+	// from there, so previews can show the first tiles of a block while the rest decodes.
+	// The input must stay alive and unchanged until decoding is finished.
+	class SSCStreamDecoder
+	{
+	public:
+		SSCStreamDecoder(ByteSpan in_data, Uint32 offset, Uint32 working_data_size_hint, std::size_t output_limit = SSCDecompressor::s_max_output_size);
+
+		// Decodes until at least output_size bytes are out or the stream ends. Returns false
+		// once the stream has failed.
+		bool DecodeUntil(std::size_t output_size);
+		bool DecodeAll();
+
+		[[nodiscard]] bool IsFinished() const { return m_finished; }
+		[[nodiscard]] const std::optional<std::string>& GetError() const { return m_error_msg; }
+		[[nodiscard]] ByteSpan GetOutput() const { return ByteSpan{ m_out_data.data(), m_pos }; }
+		// Output and ROM range so far; the decoder is left empty.
+		[[nodiscard]] SSCDecompressionResult TakeResult();
+
+	private:
+		ByteSpan m_in_data;
+		Uint32 m_offset = 0;
+		std::size_t m_max_output_size = 0;
+		// Holds slack past m_pos so a whole group can be written unchecked.
+		std::vector<Uint8> m_out_data;
+		std::size_t m_pos = 0;
+		std::size_t m_current = 0;
+		std::optional<std::string> m_error_msg;
+		bool m_finished = false;
+	};
 }
\ No newline at end of file
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "rom/dirty_range_set.h"
+#include "rom/rom_data.h"
+#include "types/byte_span.h"
+#include "types/decompression_result.h"
+
+#include "SDL3/SDL_stdinc.h"
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace spintool::rom
+{
+	class AssetCache;
+	class ROMSnapshot;
+
+	struct DiscoveredStream
+	{
+		// SSC tilesets, or LZSS for Compressed2 blocks as the loaders name them.
+		CompressionAlgorithm algorithm = CompressionAlgorithm::NONE;
+		// From the tile count header (SSC) or the first token (Compressed2) to the end of the stream.
+		ROMData rom_data;
+		Uint32 uncompressed_size = 0;
+		Uint32 num_tiles = 0;
+		// 0 to 1: how closely the stream looks like tile data the game's tools wrote.
+		float confidence = 0.0f;
+	};
+
+	// Looks for SSC and Compressed2 tile data in a ROM range on background threads. Every
+	// even offset goes through an allocation-free prefilter for each format, and only the
+	// survivors get a trial decode, bounded by the most a tileset of that format can hold.
+	// Workers pull fixed chunks of the range from a shared counter. Streams are published in
+	// offset order, one per end offset, so a stream found again from inside itself is dropped.
+	// A finished search is stored in the asset cache and the same range of an unchanged image
+	// comes back from there next time. Reads only the pinned snapshot, and only [begin, end],
+	// so streams must end inside the range.
+	//
+	// A rescan brings the results of a finished search up to date with edits instead, on the
+	// same kind of thread over a newer snapshot. Only offsets whose stream could reach a changed
+	// byte are tried again, each format as far back as its own longest stream, along with the
+	// offsets a dropped hit covered, where a stream ending with it may have been left out.
+	// The whole list is published at once when it is done, as a fresh search would find it.
+	class StreamDiscovery
+	{
+	public:
+		StreamDiscovery(std::shared_ptr<const ROMSnapshot> snapshot, AssetCache& asset_cache, Uint32 begin, Uint32 end);
+		// Rescans [begin, end] of snapshot, where results were found before the bytes in ranges changed.
+		StreamDiscovery(std::shared_ptr<const ROMSnapshot> snapshot, AssetCache& asset_cache, Uint32 begin, Uint32 end,
+			std::vector<DiscoveredStream> results, std::vector<DirtyRange> ranges);
+		// Cancels the search and waits for the workers.
+		~StreamDiscovery();
+
+		StreamDiscovery(const StreamDiscovery&) = delete;
+		StreamDiscovery& operator=(const StreamDiscovery&) = delete;
+
+		void Cancel();
+		[[nodiscard]] bool IsFinished() const { return m_finished.load(); }
+		[[nodiscard]] bool WasCancelled() const { return m_cancelled.load(); }
+		[[nodiscard]] float GetProgress() const { return m_progress.load(); }
+		[[nodiscard]] Uint32 GetBegin() const { return m_begin; }
+		[[nodiscard]] Uint32 GetEnd() const { return m_end; }
+		// Appends the streams published since the last call.
+		void CollectResults(std::vector<DiscoveredStream>& results);
+
+		static constexpr Uint32 s_chunk_bytes = 0x2000;
+		// Smaller hits are mostly noise that happens to decode.
+		static constexpr Uint32 s_min_uncompressed_size = 0x400;
+		static constexpr Uint32 s_max_ssc_tiles = 0x100;
+		// Compressed2 blocks are unpacked straight into the 64 KiB of VRAM.
+		static constexpr Uint32 s_max_compressed2_size = 0x10000;
+		// The most bytes a stream the search accepts can cover. SSC is worst when every byte
+		// is raw: a flag byte per eight, then the two-byte end token. Every Compressed2 token
+		// but END outputs a byte or is a CLEAR followed by a literal, and none is over 11 bits.
+		static constexpr Uint32 s_max_ssc_stream_bytes = 2 + (s_max_ssc_tiles - 1) * 32 + ((s_max_ssc_tiles - 1) * 32 + 1 + 7) / 8 + 2;
+		static constexpr Uint32 s_max_compressed2_stream_bytes = (11 * (2 * s_max_compressed2_size + 1) + 7) / 8;
+
+	private:
+		void SetRange(Uint32 begin, Uint32 end);
+		void Run();
+		void Rescan(std::vector<DiscoveredStream> results, const std::vector<DirtyRange>& ranges);
+		// Publishes the cached list for the range, if the image has one.
+		bool TakeCachedResults();
+
+		std::shared_ptr<const ROMSnapshot> m_snapshot;
+		AssetCache& m_asset_cache;
+		// The range searched, starting on an even offset and clamped to the image.
+		Uint32 m_begin = 0;
+		Uint32 m_end = 0;
+		std::thread m_thread;
+		std::mutex m_results_mutex;
+		std::vector<DiscoveredStream> m_results;
+		std::size_t m_collected_results = 0;
+		std::atomic<bool> m_cancelled{ false };
+		std::atomic<bool> m_finished{ false };
+		std::atomic<float> m_progress{ 0.0f };
+	};
+}
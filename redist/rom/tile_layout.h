@@ -1,6 +1,7 @@
 #pragma once
 
 #include "rom_data.h"
+#include "types/rom_ptr.h"
 #include "types/bounding_box.h"
 #include "rom/tile.h"
 #include "rom/tile_brush.h"
@@ -36,7 +37,15 @@ namespace spintool::rom
 		static std::shared_ptr<TileLayout> LoadFromROM(const SpinballROM& src_rom, const rom::TileSet& tileset, Uint32 layout_offset, std::optional<Uint32> layout_end);
 		static std::shared_ptr<TileLayout> LoadRawTilesFromROM(const SpinballROM& src_rom, const rom::TileSet& tileset, Uint32 layout_width, Uint32 layout_height, Uint32 layout_offset, Uint32 layout_end);
 		void SaveToROM(SpinballROM& src_rom, const rom::TileSet& tile_set, Uint32 brushes_offset, Uint32 layout_offset);
+		Ptr32 SaveBrushesToROM(SpinballROM& src_rom, Uint32 brushes_offset) const;
+		Ptr32 SaveLayoutToROM(SpinballROM& src_rom, Uint32 layout_offset) const;
+		[[nodiscard]] Uint32 GetBrushesSizeOnROM() const;
+		// Number of brushes a layout stored on ROM refers to (highest brush index + 1).
+		[[nodiscard]] static Uint32 CountReferencedBrushes(const SpinballROM& src_rom, Uint32 layout_offset, Uint32 layout_size);
 		void CollapseTilesIntoBrushes(const rom::TileSet& tile_set);
+		// Rewrites every tile index in the brushes and the tile instances; old_to_new comes
+		// from TileOrderOptimizer. Indices past its end are left alone.
+		void RemapTileIndices(const std::vector<Uint32>& old_to_new);
 		void BlitTileInstancesFromBrushInstances();
 		void BlitTileBrushToLayout(const rom::TileBrush& brush, size_t brush_x_index, size_t brush_y_index, bool flip_x, bool flip_y);
 
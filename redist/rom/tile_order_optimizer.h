@@ -0,0 +1,43 @@
+#pragma once
+
+#include "types/decompression_result.h"
+
+#include "SDL3/SDL_stdinc.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace spintool::rom
+{
+	struct TileOrder
+	{
+		// Old tile index at every new position.
+		std::vector<Uint32> new_to_old;
+		// New position of every old tile.
+		std::vector<Uint32> old_to_new;
+		// Compressed sizes in the original and the chosen order.
+		std::size_t original_size = 0;
+		std::size_t optimised_size = 0;
+
+		[[nodiscard]] bool IsIdentity() const;
+	};
+
+	// Tiles that share rows of pixels compress better next to each other, in the SSC window
+	// and in the Compressed2 dictionary alike. This orders tiles greedily by nearest neighbour
+	// on a row-sharing similarity, refines the order with 2-opt over each tile's closest
+	// neighbours, then compresses the candidates for real and keeps the smallest, which is
+	// the original order whenever nothing beats it. Callers must rewrite every reference to
+	// the tiles with old_to_new.
+	class TileOrderOptimizer
+	{
+	public:
+		// tile_data holds whole tiles; the first num_pinned_tiles keep their index.
+		static TileOrder Optimise(const std::vector<Uint8>& tile_data, CompressionAlgorithm compression_algorithm, Uint32 num_pinned_tiles = 1);
+
+		[[nodiscard]] static std::vector<Uint8> ApplyOrder(const std::vector<Uint8>& tile_data, const std::vector<Uint32>& new_to_old);
+		[[nodiscard]] static std::size_t MeasureCompressedSize(const std::vector<Uint8>& tile_data, CompressionAlgorithm compression_algorithm);
+
+		static constexpr std::size_t s_neighbour_count = 8;
+		static constexpr int s_max_refinement_passes = 8;
+	};
+}
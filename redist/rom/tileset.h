@@ -1,6 +1,7 @@
 #pragma once
 
 #include "rom/rom_data.h"
+#include "types/byte_span.h"
 #include "types/decompression_result.h"
 #include "types/rom_ptr.h"
 
@@ -9,6 +10,8 @@
 
 #include <vector>
 #include <memory>
+#include <optional>
+#include <string>
 
 namespace spintool::rom
 {
@@ -17,6 +20,9 @@ namespace spintool::rom
 	struct SpriteTile;
 	struct Tile;
 	struct TileSet;
+	struct SSCCompressionStats;
+	class SSCStreamDecoder;
+	class Compressed2StreamDecoder;
 }
 
 namespace spintool
@@ -53,15 +59,53 @@ namespace spintool::rom
 		static TilesetEntry LoadFromROM_LZSSCompression(const SpinballROM& src_rom, Uint32 rom_offset);
 
 		Ptr32 SaveToROM_SSCCompression(SpinballROM& src_rom, Uint32 rom_offset) const;
+		// Tile count header followed by the SSC-compressed tiles, exactly as stored on ROM.
+		[[nodiscard]] std::vector<Uint8> EncodeSSCCompression(SSCCompressionStats* stats = nullptr) const;
 
 		[[nodiscard]] std::shared_ptr<const Sprite> CreateSpriteFromTile(const Uint32 offset) const;
 		[[nodiscard]] std::shared_ptr<SpriteTile> CreateSpriteTileFromTile(const Uint32 tile_index) const;
 
 		[[nodiscard]] SDLSurfaceHandle RenderToSurface(const rom::Palette& palette_line) const;
 
+		// A copy holding old tile new_to_old[i] at index i, for TileOrderOptimizer results.
+		// Tile surfaces are not copied.
+		[[nodiscard]] std::unique_ptr<TileSet> CreateReordered(const std::vector<Uint32>& new_to_old) const;
+
 		constexpr const static Uint16 s_tile_width = 0x08;
 		constexpr const static Uint16 s_tile_height = 0x08;
 		constexpr const static Uint16 s_tile_total_pixels = s_tile_width * s_tile_height;
 		constexpr const static Uint16 s_tile_total_bytes = (s_tile_width / 2) * s_tile_height;
 	};
-}
\ No newline at end of file
+	// Decodes a tileset from ROM a few tiles at a time, for previews that want the first
+	// page on screen before the rest of the block is unpacked. Only the tile bytes are kept;
+	// no rom::Tile objects are built. src_rom is read in place, so it must outlive the decoder
+	// and not change while it is decoding; decode from a ROMSnapshot rather than the live ROM.
+	class TileSetStreamDecoder
+	{
+	public:
+		TileSetStreamDecoder(const SpinballROM& src_rom, Uint32 rom_offset, CompressionAlgorithm compression_algorithm);
+		~TileSetStreamDecoder();
+
+		// Decodes until at least num_tiles tiles are available or the tileset ends. Returns
+		// false once decoding has failed.
+		bool DecodeTiles(Uint32 num_tiles);
+
+		[[nodiscard]] Uint32 GetDecodedTileCount() const;
+		// SSC tilesets store their tile count up front; other tilesets only know it once finished.
+		[[nodiscard]] std::optional<Uint32> GetTotalTileCount() const;
+		[[nodiscard]] bool IsFinished() const;
+		[[nodiscard]] std::optional<std::string> GetError() const;
+
+		// The tiles decoded so far, ready for RenderToSurface.
+		[[nodiscard]] std::unique_ptr<TileSet> MakePartialTileSet() const;
+
+	private:
+		[[nodiscard]] ByteSpan GetOutput() const;
+
+		Uint32 m_rom_offset = 0;
+		std::optional<Uint32> m_total_tiles;
+		std::optional<std::string> m_error_msg;
+		std::unique_ptr<SSCStreamDecoder> m_ssc_decoder;
+		std::unique_ptr<Compressed2StreamDecoder> m_compressed2_decoder;
+	};
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "SDL3/SDL_stdinc.h"
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace spintool
+{
+	// Non-owning, read-only view over contiguous bytes. Decoders and loaders take
+	// this instead of a std::vector so they can read the memory-mapped working ROM,
+	// a decompressed payload or a plain vector without copying.
+	class ByteSpan
+	{
+	public:
+		constexpr ByteSpan() = default;
+		constexpr ByteSpan(const Uint8* data, std::size_t size)
+			: m_data(data)
+			, m_size(size)
+		{
+		}
+
+		template<
+			typename Container,
+			typename = std::enable_if_t<!std::is_same_v<std::decay_t<Container>, ByteSpan>>,
+			typename = std::enable_if_t<sizeof(*std::declval<const Container&>().data()) == 1>,
+			typename = decltype(std::declval<const Container&>().size())>
+		ByteSpan(const Container& container)
+			: m_data(reinterpret_cast<const Uint8*>(container.data()))
+			, m_size(container.size())
+		{
+		}
+
+		[[nodiscard]] constexpr const Uint8* data() const { return m_data; }
+		[[nodiscard]] constexpr std::size_t size() const { return m_size; }
+		[[nodiscard]] constexpr bool empty() const { return m_size == 0; }
+
+		[[nodiscard]] constexpr const Uint8& operator[](std::size_t index) const { return m_data[index]; }
+
+		[[nodiscard]] constexpr const Uint8* begin() const { return m_data; }
+		[[nodiscard]] constexpr const Uint8* end() const { return m_data + m_size; }
+
+		// Clamped to the view, so an out-of-range request yields an empty span.
+		[[nodiscard]] constexpr ByteSpan subspan(std::size_t offset, std::size_t count = static_cast<std::size_t>(-1)) const
+		{
+			if (offset >= m_size)
+			{
+				return ByteSpan{ m_data + m_size, 0 };
+			}
+			const std::size_t available = m_size - offset;
+			return ByteSpan{ m_data + offset, count < available ? count : available };
+		}
+
+	private:
+		const Uint8* m_data = nullptr;
+		std::size_t m_size = 0;
+	};
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "rom/rom_asset_index.h"
+#include "ui/ui_editor_window.h"
+
+#include "SDL3/SDL_stdinc.h"
+
+#include <string>
+#include <vector>
+
+namespace spintool
+{
+	class EditorAssetLookup : public EditorWindowBase
+	{
+	public:
+		using EditorWindowBase::EditorWindowBase;
+		void Update() override;
+
+	private:
+		void RunQuery();
+
+		Uint32 m_offset = 0;
+		std::vector<rom::ROMAssetRef> m_results;
+		// Offsets of longwords holding m_offset; see rom/pointer_index.h.
+		std::vector<Uint32> m_references;
+		std::string m_status;
+	};
+}
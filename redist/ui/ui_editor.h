@@ -12,10 +12,12 @@
 #include "ui/ui_palette_viewer.h"
 #include "ui/ui_sprite_importer.h"
 #include "ui/ui_animation_navigator.h"
+#include "ui/ui_asset_lookup.h"
 
 #include <filesystem>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <vector>
 
 namespace spintool
@@ -53,10 +55,20 @@ namespace spintool
 		// Editable copy actually loaded from <project>/rom_export.
 		[[nodiscard]] std::filesystem::path GetWorkingROMPath() const;
 
+		// Content hash of the reference ROM; key anything cached on disk per ROM with it.
+		[[nodiscard]] const std::optional<rom::ROMHash>& GetReferenceROMHash() const;
+
 		[[nodiscard]] const std::vector<TilesetEntry>& GetTilesets() const;
 		[[nodiscard]] const std::vector<std::shared_ptr<rom::Palette>>& GetPalettes() const;
 		void NotifyPaletteChanged();
 
+		// Called with every range written since the last call, whoever wrote it (imports,
+		// saves, undo/redo), so any window holding data decoded from those ranges can
+		// refresh it. writer, when given, made the change itself and is not told about it.
+		void NotifyROMChanged(const std::vector<rom::DirtyRange>& ranges, const EditorWindowBase* writer = nullptr);
+		void UndoROMEdit();
+		void RedoROMEdit();
+
 		void OpenSpriteViewer(std::shared_ptr<const rom::Sprite>& sprite);
 		void OpenImageImporter(rom::Sprite& sprite);
 		void OpenImageImporter(
@@ -67,6 +79,9 @@ namespace spintool
 		std::recursive_mutex m_render_to_texture_mutex;
 
 	private:
+		// Hands the ranges written since the last call to NotifyROMChanged.
+		void DispatchROMChanges(const EditorWindowBase* writer = nullptr);
+
 		rom::SpinballROM m_rom;
 
 		rom::ROMMetadata* m_current_rom_metadata = nullptr;
@@ -81,6 +96,7 @@ namespace spintool
 
 		std::filesystem::path m_reference_rom_path;
 		std::filesystem::path m_working_rom_path;
+		std::optional<rom::ROMHash> m_reference_rom_hash;
 
 		std::vector<std::shared_ptr<rom::Palette>> m_palettes;
 		std::vector<std::unique_ptr<EditorSpriteViewer>> m_sprite_viewer_windows;
@@ -91,6 +107,7 @@ namespace spintool
 		EditorAnimationNavigator m_animation_navigator;
 		EditorPaletteViewer m_palette_viewer;
 		EditorImageImporter m_sprite_importer;
+		EditorAssetLookup m_asset_lookup;
 
 		bool m_change_path_popup_open = false;
 		float m_font_scale = 1.0f;
@@ -4,6 +4,7 @@
 #include "ui/ui_sprite.h"
 #include "ui/ui_palette_viewer.h"
 #include "rom/title_screen_decoder.h"
+#include "rom/dirty_range_set.h"
 
 #include <array>
 #include <atomic>
@@ -62,6 +63,9 @@ namespace spintool
 
 		void Update() override;
 		void InvalidatePaletteDependentTextures();
+		void NotifyROMChanged(const std::vector<rom::DirtyRange>& ranges);
+		// A different ROM was loaded; the main sprite scan came from the old one.
+		void NotifyROMLoaded();
 
 	private:
 		void LoadBonusStageImages();
@@ -73,6 +77,9 @@ namespace spintool
 		void ImportTitleScreenImage(const std::filesystem::path& path, std::size_t image_index);
 		void ExportTitleScreenImage(std::size_t image_index);
 		void ImportMainSpriteImage(const std::filesystem::path& path, Uint32 sprite_rom_offset);
+		void RescanSpriteRanges(const std::vector<rom::DirtyRange>& ranges);
+		// Stops any running scan and forgets its results.
+		void ClearSpriteScan();
 
 		std::vector<std::shared_ptr<UISpriteTexture>> m_sprites_found;
 		std::vector<BonusStageImagePreview> m_bonus_stage_images;
@@ -86,6 +93,12 @@ namespace spintool
 		std::atomic<bool> m_find_all_cancel{ false };
 		std::atomic<int> m_find_all_result_count{ 0 };
 		std::atomic<Uint32> m_scan_generation{ 0 };
+		// A scan is running, or its last results haven't been merged yet.
+		bool m_main_scan_pending = false;
+		// m_sprites_found holds a whole scan of the applied range, kept live through edits.
+		bool m_main_scan_complete = false;
+		// Edits made while the scan read an older snapshot, rescanned once it finishes.
+		rom::DirtyRangeSet m_edits_during_scan;
 
 		SDLTextureHandle m_random_texture;
 		int m_arbitrary_num_tiles_width = 16;
@@ -98,6 +111,10 @@ namespace spintool
 		// active full-scan range.
 		Uint32 m_scan_start_offset = 0x14D2;
 		Uint32 m_scan_end_offset = 0x03909D;
+		// Range the last full scan was started over. The End field edits m_scan_end_offset
+		// before it is applied, so rescans after an edit must not read it.
+		Uint32 m_applied_scan_start = 0;
+		Uint32 m_applied_scan_end = 0;
 		Uint32 m_selected_sprite_rom_offset = 0;
 		Uint32 m_offset = 0x14D2;
 		int m_chosen_palette = 0;
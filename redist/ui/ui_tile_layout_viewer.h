@@ -9,6 +9,7 @@
 #include "rom/game_objects/game_object_flipper.h"
 #include "rom/game_objects/game_object_ring.h"
 #include "rom/palette.h"
+#include "rom/dirty_range_set.h"
 
 #include "editor/spline_manager.h"
 #include "editor/game_obj_manager.h"
@@ -296,6 +297,7 @@ namespace spintool
 		[[nodiscard]] bool IsDraggingObject() const;
 		[[nodiscard]] static bool IsObjectPopupOpen();
 		[[nodiscard]] bool IsEditingSomething() const;
+		void NotifyROMChanged(const std::vector<rom::DirtyRange>& ranges);
 
 		struct AnimSpriteEntry
 		{
@@ -355,6 +357,9 @@ namespace spintool
 		bool m_export_result = false;
 		bool m_preview_bonus_alt_palette = false;
 		bool m_render_from_edit = false;
+		bool m_reload_level_requested = false;
+		bool m_reload_level_prompt = false; // The ROM under the level changed while its layout has unsaved edits
+		bool m_has_unsaved_layout_edits = false;
 		bool m_request_open_obj_popup = false;
 
 	};
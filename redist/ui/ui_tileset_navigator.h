@@ -3,6 +3,8 @@
 #include "ui_editor_window.h"
 #include "types/decompression_result.h"
 #include "rom/tileset.h"
+#include "rom/dirty_range_set.h"
+#include "rom/stream_discovery.h"
 
 #include <memory>
 #include <vector>
@@ -14,6 +16,7 @@ namespace spintool
 	{
 		struct TileSet;
 		class SpinballROM;
+		class ROMSnapshot;
 	}
 }
 
@@ -25,7 +28,33 @@ namespace spintool
 		using EditorWindowBase::EditorWindowBase;
 		
 		void Update() override;
+		void NotifyROMChanged(const std::vector<rom::DirtyRange>& ranges);
+		// A different ROM was loaded; everything shown so far came from the old one.
+		void NotifyROMLoaded();
 
 		std::vector<TilesetEntry> m_tilesets;
+
+	private:
+		void DrawPreview();
+		void ResetPreview();
+		void DrawDiscoveredStreams();
+		void CollectDiscoveredStreams();
+		// Starts a rescan for edits made since the search or the last rescan started, once it has finished.
+		void RescanDiscoveredStreams();
+
+		// Decoded a page per frame so the first tiles show up straight away. The decoder
+		// reads the snapshot in place, so the snapshot has to outlive it.
+		std::shared_ptr<const rom::ROMSnapshot> m_preview_snapshot;
+		std::unique_ptr<rom::TileSetStreamDecoder> m_preview_decoder;
+		SDLSurfaceHandle m_preview_surface;
+		SDLTextureHandle m_preview_texture;
+		Uint32 m_preview_rendered_tiles = 0;
+		int m_preview_palette_index = 0;
+
+		std::unique_ptr<rom::StreamDiscovery> m_discovery;
+		std::vector<rom::DiscoveredStream> m_discovered_streams;
+		rom::DirtyRangeSet m_edits_during_discovery;
+		rom::DirtyRangeSet m_edits_being_rescanned; // Handed to the running rescan; back in m_edits_during_discovery if it is cancelled
+		bool m_rescanning_discovered_streams = false; // m_discovery is a rescan of m_discovered_streams
 	};
 }
\ No newline at end of file
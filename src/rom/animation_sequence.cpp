@@ -436,6 +436,7 @@ namespace spintool::rom
 		}
 
 		new_animation->rom_data.SetROMData(offset, current_offset);
+		src_rom.GetAssetIndex().Register(ROMAssetType::AnimationSequence, new_animation->rom_data);
 		new_animation->command_sequence = result_data;
 		
 		return new_animation;
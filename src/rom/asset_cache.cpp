@@ -0,0 +1,309 @@
+#include "rom/asset_cache.h"
+
+#include "rom/spinball_rom.h"
+#include "rom/ssc_decompressor.h"
+#include "rom/lzss_decompressor.h"
+#include "rom/compressed2_decoder.h"
+
+#include <array>
+#include <fstream>
+#include <iostream>
+#include <system_error>
+#include <utility>
+
+namespace spintool::rom
+{
+	namespace
+	{
+		constexpr std::array<char, 8> kFileMagic = { 'S', 'P', 'I', 'N', 'C', 'A', 'C', 'H' };
+
+		// The file is little-endian whatever the host, like the hash it is named after.
+		template<typename T>
+		void WriteLE(std::ofstream& stream, T value)
+		{
+			std::array<char, sizeof(T)> bytes{};
+			for (std::size_t i = 0; i < sizeof(T); ++i)
+			{
+				bytes[i] = static_cast<char>(static_cast<Uint64>(value) >> (i * 8));
+			}
+			stream.write(bytes.data(), bytes.size());
+		}
+
+		template<typename T>
+		bool ReadLE(std::ifstream& stream, T& value)
+		{
+			std::array<char, sizeof(T)> bytes{};
+			if (!stream.read(bytes.data(), bytes.size()))
+			{
+				return false;
+			}
+			Uint64 result = 0;
+			for (std::size_t i = 0; i < sizeof(T); ++i)
+			{
+				result |= static_cast<Uint64>(static_cast<Uint8>(bytes[i])) << (i * 8);
+			}
+			value = static_cast<T>(result);
+			return true;
+		}
+
+		Uint64 HashSource(ByteSpan image, Uint32 source_begin, Uint32 source_end)
+		{
+			return HashBytes(image.subspan(source_begin, source_end - source_begin));
+		}
+	}
+
+	AssetCache::~AssetCache()
+	{
+		Flush();
+	}
+
+	bool AssetCache::Open(const std::filesystem::path& directory, const ROMHash& rom_hash)
+	{
+		std::lock_guard lock{ m_mutex };
+		FlushLocked();
+
+		m_entries.clear();
+		m_payload_bytes = 0;
+		m_dirty = false;
+		m_path = directory / (rom_hash.ToString() + ".cache");
+
+		std::error_code error;
+		std::filesystem::create_directories(directory, error);
+		if (error)
+		{
+			std::cerr << "Could not create asset cache directory " << directory << ": " << error.message() << '\n';
+			m_path.clear();
+			return false;
+		}
+
+		if (!LoadFile())
+		{
+			// A stale or damaged file is simply rebuilt.
+			m_entries.clear();
+			m_payload_bytes = 0;
+		}
+		return true;
+	}
+
+	bool AssetCache::Flush()
+	{
+		std::lock_guard lock{ m_mutex };
+		return FlushLocked();
+	}
+
+	bool AssetCache::IsOpen() const
+	{
+		std::lock_guard lock{ m_mutex };
+		return !m_path.empty();
+	}
+
+	std::optional<AssetCacheHit> AssetCache::Find(const AssetCacheKey& key, ByteSpan image) const
+	{
+		std::lock_guard lock{ m_mutex };
+		const auto entry_it = m_entries.find(key);
+		if (entry_it == m_entries.end())
+		{
+			return std::nullopt;
+		}
+
+		const Entry& entry = entry_it->second;
+		if (entry.source_end > image.size() || HashSource(image, entry.source_begin, entry.source_end) != entry.source_hash)
+		{
+			return std::nullopt;
+		}
+		return AssetCacheHit{ entry.source_begin, entry.source_end, entry.payload };
+	}
+
+	void AssetCache::Store(const AssetCacheKey& key, ByteSpan image, Uint32 source_begin, Uint32 source_end, std::vector<Uint8> payload)
+	{
+		if (source_begin >= source_end || source_end > image.size())
+		{
+			return;
+		}
+
+		std::lock_guard lock{ m_mutex };
+		if (m_path.empty())
+		{
+			return;
+		}
+
+		Entry& entry = m_entries[key];
+		m_payload_bytes -= entry.payload.size();
+		if (m_payload_bytes + payload.size() > s_max_payload_bytes)
+		{
+			m_entries.erase(key);
+			return;
+		}
+
+		entry.source_begin = source_begin;
+		entry.source_end = source_end;
+		entry.source_hash = HashSource(image, source_begin, source_end);
+		entry.payload = std::move(payload);
+		m_payload_bytes += entry.payload.size();
+		m_dirty = true;
+	}
+
+	bool AssetCache::FlushLocked()
+	{
+		if (!m_dirty || m_path.empty())
+		{
+			return true;
+		}
+
+		// Write beside the old file and swap it in, so a crash never leaves half a cache.
+		std::filesystem::path temp_path = m_path;
+		temp_path += ".tmp";
+		{
+			std::ofstream stream(temp_path, std::ios::binary | std::ios::trunc);
+			if (!stream)
+			{
+				std::cerr << "Could not write asset cache " << temp_path << '\n';
+				return false;
+			}
+
+			stream.write(kFileMagic.data(), kFileMagic.size());
+			WriteLE<Uint32>(stream, s_format_version);
+			WriteLE<Uint32>(stream, static_cast<Uint32>(m_entries.size()));
+			for (const auto& [key, entry] : m_entries)
+			{
+				WriteLE<Uint8>(stream, static_cast<Uint8>(key.kind));
+				WriteLE<Uint32>(stream, key.offset);
+				WriteLE<Uint32>(stream, key.parameter);
+				WriteLE<Uint32>(stream, entry.source_begin);
+				WriteLE<Uint32>(stream, entry.source_end);
+				WriteLE<Uint64>(stream, entry.source_hash);
+				WriteLE<Uint32>(stream, static_cast<Uint32>(entry.payload.size()));
+				stream.write(reinterpret_cast<const char*>(entry.payload.data()), static_cast<std::streamsize>(entry.payload.size()));
+			}
+
+			if (!stream)
+			{
+				std::cerr << "Could not write asset cache " << temp_path << '\n';
+				return false;
+			}
+		}
+
+		std::error_code error;
+		std::filesystem::rename(temp_path, m_path, error);
+		if (error)
+		{
+			std::cerr << "Could not replace asset cache " << m_path << ": " << error.message() << '\n';
+			return false;
+		}
+
+		m_dirty = false;
+		return true;
+	}
+
+	bool AssetCache::LoadFile()
+	{
+		std::ifstream stream(m_path, std::ios::binary);
+		if (!stream)
+		{
+			return true;
+		}
+
+		std::array<char, kFileMagic.size()> magic{};
+		Uint32 version = 0;
+		Uint32 num_entries = 0;
+		if (!stream.read(magic.data(), magic.size()) || magic != kFileMagic ||
+			!ReadLE(stream, version) || version != s_format_version ||
+			!ReadLE(stream, num_entries))
+		{
+			return false;
+		}
+
+		for (Uint32 i = 0; i < num_entries; ++i)
+		{
+			Uint8 kind = 0;
+			AssetCacheKey key;
+			Entry entry;
+			Uint32 payload_size = 0;
+			if (!ReadLE(stream, kind) ||
+				!ReadLE(stream, key.offset) ||
+				!ReadLE(stream, key.parameter) ||
+				!ReadLE(stream, entry.source_begin) ||
+				!ReadLE(stream, entry.source_end) ||
+				!ReadLE(stream, entry.source_hash) ||
+				!ReadLE(stream, payload_size) ||
+				m_payload_bytes + payload_size > s_max_payload_bytes)
+			{
+				return false;
+			}
+
+			key.kind = static_cast<AssetCacheKind>(kind);
+			entry.payload.resize(payload_size);
+			if (!stream.read(reinterpret_cast<char*>(entry.payload.data()), payload_size))
+			{
+				return false;
+			}
+			m_payload_bytes += payload_size;
+			m_entries[key] = std::move(entry);
+		}
+		return true;
+	}
+
+	DecompressionResult DecompressSSCCached(const SpinballROM& rom, Uint32 offset, Uint32 uncompressed_size_hint)
+	{
+		const AssetCacheKey key{ AssetCacheKind::SSCDecompression, offset, uncompressed_size_hint };
+		AssetCache& cache = rom.GetAssetCache();
+		if (std::optional<AssetCacheHit> hit = cache.Find(key, rom.m_buffer))
+		{
+			DecompressionResult results;
+			results.rom_data.SetROMData(hit->source_begin, hit->source_end);
+			results.uncompressed_size = hit->payload.size();
+			results.uncompressed_data = std::move(hit->payload);
+			return results;
+		}
+
+		DecompressionResult results = SSCDecompressor::DecompressDataFast(rom.m_buffer, offset, uncompressed_size_hint);
+		if (!results.error_msg.has_value())
+		{
+			cache.Store(key, rom.m_buffer, results.rom_data.rom_offset, results.rom_data.rom_offset_end, results.uncompressed_data);
+		}
+		return results;
+	}
+
+	DecompressionResult DecompressLZSSCached(const SpinballROM& rom, Uint32 offset)
+	{
+		const AssetCacheKey key{ AssetCacheKind::LZSSDecompression, offset, 0 };
+		AssetCache& cache = rom.GetAssetCache();
+		if (std::optional<AssetCacheHit> hit = cache.Find(key, rom.m_buffer))
+		{
+			DecompressionResult results;
+			results.rom_data.SetROMData(hit->source_begin, hit->source_end);
+			results.uncompressed_size = hit->payload.size();
+			results.uncompressed_data = std::move(hit->payload);
+			return results;
+		}
+
+		DecompressionResult results = LZSSDecompressor::DecompressDataFast(rom.m_buffer, offset);
+		if (!results.error_msg.has_value())
+		{
+			cache.Store(key, rom.m_buffer, results.rom_data.rom_offset, results.rom_data.rom_offset_end, results.uncompressed_data);
+		}
+		return results;
+	}
+
+	bool DecodeCompressed2Cached(const SpinballROM& rom, Uint32 offset, std::vector<Uint8>& output, std::string& error)
+	{
+		const AssetCacheKey key{ AssetCacheKind::Compressed2Decode, offset, 0 };
+		AssetCache& cache = rom.GetAssetCache();
+		if (std::optional<AssetCacheHit> hit = cache.Find(key, rom.m_buffer))
+		{
+			output = std::move(hit->payload);
+			return true;
+		}
+
+		Compressed2DecodeResult result = Compressed2Decoder::Decode(rom.m_buffer, offset);
+		output = std::move(result.output);
+		if (result.error_msg.has_value())
+		{
+			error = std::move(*result.error_msg);
+			return false;
+		}
+		error.clear();
+		cache.Store(key, rom.m_buffer, offset, offset + static_cast<Uint32>(result.GetConsumedSize()), output);
+		return true;
+	}
+}
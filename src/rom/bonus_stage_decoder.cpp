@@ -1,6 +1,8 @@
 #include "rom/bonus_stage_decoder.h"
 
 #include "rom/compressed2_optimizer.h"
+#include "rom/free_space_allocator.h"
+#include "rom/level.h"
 
 #include "rom/tile.h"
 #include "rom/spinball_rom.h"
@@ -12,6 +14,7 @@
 #include <cstdint>
 #include <iterator>
 #include <limits>
+#include <optional>
 #include <sstream>
 #include <unordered_map>
 #include <unordered_set>
@@ -378,7 +381,9 @@ namespace spintool::rom
 			Uint32 rom_offset = 0;
 			Uint32 pointer_operand_offset = 0;
 			Uint32 vram_offset = 0;
-			std::size_t original_capacity = 0;
+			// Bytes this block may use in place: the whole original slot while the art still
+			// lives there, otherwise exactly its current stream once it has been relocated.
+			std::size_t capacity = 0;
 			std::size_t current_compressed_size = 0;
 			std::vector<Uint8> data;
 			std::vector<Uint8> original_compressed;
@@ -391,12 +396,12 @@ namespace spintool::rom
 			std::array<Uint32, 6> art_offsets{};
 		};
 
-		bool CanRead(const std::vector<Uint8>& data, Uint32 offset, std::size_t count)
+		bool CanRead(ByteSpan data, Uint32 offset, std::size_t count)
 		{
 			return offset <= data.size() && count <= data.size() - offset;
 		}
 
-		Uint16 ReadBE16(const std::vector<Uint8>& data, Uint32 offset)
+		Uint16 ReadBE16(ByteSpan data, Uint32 offset)
 		{
 			return static_cast<Uint16>(
 				(static_cast<Uint16>(data[offset]) << 8U) |
@@ -404,12 +409,12 @@ namespace spintool::rom
 			);
 		}
 
-		Sint16 ReadBE16Signed(const std::vector<Uint8>& data, Uint32 offset)
+		Sint16 ReadBE16Signed(ByteSpan data, Uint32 offset)
 		{
 			return static_cast<Sint16>(ReadBE16(data, offset));
 		}
 
-		Uint32 ReadBE32(const std::vector<Uint8>& data, Uint32 offset)
+		Uint32 ReadBE32(ByteSpan data, Uint32 offset)
 		{
 			return
 				(static_cast<Uint32>(data[offset]) << 24U) |
@@ -599,7 +604,9 @@ namespace spintool::rom
 			block.rom_offset = rom_offset;
 			block.pointer_operand_offset = pointer_operand_offset;
 			block.vram_offset = vram_offset;
-			block.original_capacity = reference_stream_size;
+			block.capacity = rom_offset == reference_rom_offset
+				? reference_stream_size
+				: current_stream_size;
 			block.current_compressed_size = current_stream_size;
 			block.data = std::move(entry.tileset->uncompressed_data);
 			block.original_compressed.assign(
@@ -658,47 +665,29 @@ namespace spintool::rom
 				error = "Optimized Compressed2 validation produced different art data";
 				return false;
 			}
-			if (compression.data.size() > block.original_capacity)
-			{
-				std::ostringstream message;
-				message << "Import refused before writing the ROM: block "
-					<< HexOffset(block.rom_offset) << " needs "
-					<< compression.data.size() << " bytes after optimized compression, but "
-					<< "its original capacity is " << block.original_capacity << " bytes ("
-					<< compression.data.size() - block.original_capacity
-					<< " bytes too large; basic compression was "
-					<< compression.baseline_size << " bytes).";
-				error = message.str();
-				return false;
-			}
 			return true;
 		}
 
-
-		void UpdateMegaDriveChecksum(SpinballROM& rom)
+		std::string DescribeOversizedBlock(
+			const EditableArtBlock& block,
+			const Compressed2CompressionResult& compression
+		)
 		{
-			if (rom.m_buffer.size() < 0x190U)
-			{
-				return;
-			}
-
-			Uint32 checksum = 0;
-			for (std::size_t offset = 0x200; offset < rom.m_buffer.size(); offset += 2U)
-			{
-				Uint16 word = static_cast<Uint16>(rom.m_buffer[offset]) << 8U;
-				if (offset + 1U < rom.m_buffer.size())
-				{
-					word = static_cast<Uint16>(word | rom.m_buffer[offset + 1U]);
-				}
-				checksum = (checksum + word) & 0xFFFFU;
-			}
-
-			rom.m_buffer[0x18E] = static_cast<Uint8>((checksum >> 8U) & 0xFFU);
-			rom.m_buffer[0x18F] = static_cast<Uint8>(checksum & 0xFFU);
+			std::ostringstream message;
+			message << "Import refused before writing the ROM: block "
+				<< HexOffset(block.rom_offset) << " needs "
+				<< compression.data.size() << " bytes after optimized compression, but "
+				<< "its capacity is " << block.capacity << " bytes ("
+				<< compression.data.size() - block.capacity
+				<< " bytes too large; basic compression was "
+				<< compression.baseline_size << " bytes) and there is no free space to "
+				<< "move it to.";
+			return message.str();
 		}
 
+
 		bool ParseMapping(
-			const std::vector<Uint8>& rom,
+			ByteSpan rom,
 			Uint32 mapping_offset,
 			ParsedMapping& out,
 			std::string& error
@@ -1582,7 +1571,7 @@ namespace spintool::rom
 				return result;
 			}
 			if (block.rom_offset > rom.m_buffer.size() ||
-				block.original_capacity > rom.m_buffer.size() - block.rom_offset)
+				block.capacity > rom.m_buffer.size() - block.rom_offset)
 			{
 				result.message = "Compressed2 block extends outside the working ROM";
 				return result;
@@ -1590,42 +1579,102 @@ namespace spintool::rom
 			prepared_rewrites.emplace_back(std::move(prepared));
 		}
 
+		// Blocks that outgrew their slot move to free space and have their pointer operand
+		// redirected. Check that every move can succeed before anything is written.
+		std::optional<AssetRelocator> relocator;
+		if (std::any_of(prepared_rewrites.begin(), prepared_rewrites.end(), [](const PreparedRewrite& prepared)
+			{
+				return prepared.compression.data.size() > prepared.block->capacity;
+			}))
+		{
+			// Level data isn't in the asset index until a level is opened.
+			std::vector<ROMData> known_assets = Level::CollectAssetExtents(rom);
+			for (const EditableArtBlock& block : art_blocks)
+			{
+				known_assets.emplace_back().SetROMData(
+					block.rom_offset,
+					block.rom_offset + static_cast<Uint32>(std::max(block.capacity, block.current_compressed_size))
+				);
+			}
+			relocator.emplace(rom, known_assets);
+
+			FreeSpaceAllocator trial_allocator = relocator->GetAllocator();
+			for (const PreparedRewrite& prepared : prepared_rewrites)
+			{
+				if (prepared.compression.data.size() <= prepared.block->capacity)
+				{
+					continue;
+				}
+				if (!relocator->CanRepoint({ prepared.block->pointer_operand_offset }, prepared.block->rom_offset) ||
+					!trial_allocator.Allocate(static_cast<Uint32>(prepared.compression.data.size())))
+				{
+					result.message = DescribeOversizedBlock(*prepared.block, prepared.compression);
+					return result;
+				}
+			}
+		}
+
 		// Nothing above modifies rom.m_buffer. Only commit after every touched block
-		// has compressed successfully and fits its original capacity.
+		// has compressed successfully and has somewhere to go.
 		for (PreparedRewrite& prepared : prepared_rewrites)
 		{
 			EditableArtBlock& block = *prepared.block;
 			const std::vector<Uint8>& compressed = prepared.compression.data;
-			std::copy(
-				compressed.begin(),
-				compressed.end(),
-				rom.m_buffer.begin() + block.rom_offset
-			);
-			std::fill(
-				rom.m_buffer.begin() + block.rom_offset + compressed.size(),
-				rom.m_buffer.begin() + block.rom_offset + block.original_capacity,
-				0U
-			);
-
-			result.rewritten_art_offsets.emplace_back(block.rom_offset);
 			std::ostringstream rewrite;
-			rewrite << HexOffset(block.rom_offset)
-				<< " in place (capacity " << block.original_capacity
-				<< " bytes, previous " << block.current_compressed_size
-				<< " bytes, optimized " << compressed.size()
-				<< " bytes, remaining "
-				<< block.original_capacity - compressed.size();
+			if (compressed.size() <= block.capacity)
+			{
+				rom.WriteBytes(block.rom_offset, compressed);
+				rom.FillBytes(
+					static_cast<Uint32>(block.rom_offset + compressed.size()),
+					0U,
+					static_cast<Uint32>(block.capacity - compressed.size())
+				);
+
+				result.rewritten_art_offsets.emplace_back(block.rom_offset);
+				rewrite << HexOffset(block.rom_offset)
+					<< " in place (capacity " << block.capacity
+					<< " bytes, previous " << block.current_compressed_size
+					<< " bytes, optimized " << compressed.size()
+					<< " bytes, remaining "
+					<< block.capacity - compressed.size();
+			}
+			else
+			{
+				// The trial run above doesn't grow the image, so this can still fail.
+				const std::optional<Ptr32> allocated = relocator->Allocate(static_cast<Uint32>(compressed.size()));
+				if (!allocated)
+				{
+					std::ostringstream message;
+					message << "Import failed: block " << HexOffset(block.rom_offset)
+						<< " needs " << compressed.size() << " bytes and the ROM could not grow to make room for it";
+					result.message = message.str();
+					return result;
+				}
+				const Ptr32 new_offset = *allocated;
+				rom.WriteBytes(new_offset, compressed);
+				relocator->Repoint({ block.pointer_operand_offset }, new_offset);
+				relocator->Release(block.rom_offset, static_cast<Uint32>(block.rom_offset + block.capacity));
+
+				result.rewritten_art_offsets.emplace_back(new_offset);
+				rewrite << HexOffset(block.rom_offset)
+					<< " moved to " << HexOffset(new_offset)
+					<< " (capacity " << block.capacity
+					<< " bytes, previous " << block.current_compressed_size
+					<< " bytes, optimized " << compressed.size() << " bytes";
+			}
 			if (prepared.compression.baseline_size > compressed.size())
 			{
 				rewrite << ", saved "
 					<< prepared.compression.baseline_size - compressed.size()
 					<< " bytes versus basic compression";
 			}
-			rewrite << ", strategy " << prepared.compression.strategy << ")";
+			rewrite << ", strategy " << prepared.compression.strategy
+				<< ", " << prepared.compression.candidates_tested << " candidates in "
+				<< static_cast<int>(prepared.compression.milliseconds) << " ms)";
 			rewrite_messages.emplace_back(rewrite.str());
 		}
 
-		UpdateMegaDriveChecksum(rom);
+		rom.RefreshChecksum();
 
 		result.success = written_pixels != 0 && !result.rewritten_art_offsets.empty();
 		result.changed = result.success;
@@ -1634,7 +1683,7 @@ namespace spintool::rom
 			std::ostringstream message;
 			message << "Imported " << written_pixels << " pixels into "
 				<< result.rewritten_art_offsets.size()
-				<< " Compressed2 block(s) at their original address";
+				<< " Compressed2 block(s)";
 			for (const std::string& rewrite : rewrite_messages)
 			{
 				message << "; " << rewrite;
@@ -0,0 +1,244 @@
+#include "rom/compressed2_decoder.h"
+
+#include "SDL3/SDL_endian.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace spintool::rom
+{
+	namespace
+	{
+		constexpr Uint16 kClearCode = 0x0100U;
+		constexpr Uint16 kEndCode = 0x0101U;
+		constexpr Uint16 kFirstDictionaryCode = 0x0102U;
+		constexpr Uint16 kDictionarySize = 0x0800U;
+		constexpr unsigned int kMinimumWidth = 9U;
+		constexpr unsigned int kMaximumWidth = 11U;
+
+		// Appends the string for code, which must be a literal or a defined entry.
+		template<typename Dictionary>
+		void Expand(const Dictionary& dictionary, Uint16 code, std::vector<Uint8>& output)
+		{
+			const std::size_t length = dictionary.length[code];
+			output.resize(output.size() + length);
+			Uint8* write = output.data() + output.size();
+			while (code >= kFirstDictionaryCode)
+			{
+				*--write = dictionary.suffix[code];
+				code = dictionary.prefix[code];
+			}
+			*--write = static_cast<Uint8>(code);
+		}
+	}
+
+	Compressed2StreamDecoder::BitReader::BitReader(const Uint8* data, std::size_t size)
+		: m_data(data)
+		, m_size(size)
+	{
+	}
+
+	bool Compressed2StreamDecoder::BitReader::Read(unsigned int width, Uint16& code)
+	{
+		if (m_buffered_bits < width)
+		{
+			Refill();
+			if (m_buffered_bits < width)
+			{
+				return false;
+			}
+		}
+		code = static_cast<Uint16>(m_buffer & ((1U << width) - 1U));
+		m_buffer >>= width;
+		m_buffered_bits -= width;
+		m_consumed_bits += width;
+		return true;
+	}
+
+	void Compressed2StreamDecoder::BitReader::Skip(std::size_t bits)
+	{
+		m_next_byte = bits / 8;
+		m_consumed_bits = m_next_byte * 8;
+		Uint16 discarded = 0;
+		Read(static_cast<unsigned int>(bits % 8), discarded);
+	}
+
+	void Compressed2StreamDecoder::BitReader::Refill()
+	{
+		if (m_size - m_next_byte >= sizeof(Uint64))
+		{
+			// Bits past the whole bytes taken here are the real next bits of the
+			// stream, so ORing the same word in again on the next refill is harmless.
+			Uint64 word = 0;
+			std::memcpy(&word, m_data + m_next_byte, sizeof(word));
+			m_buffer |= SDL_Swap64LE(word) << m_buffered_bits;
+			const unsigned int bytes = (63U - m_buffered_bits) >> 3;
+			m_next_byte += bytes;
+			m_buffered_bits += bytes * 8U;
+			return;
+		}
+
+		while (m_buffered_bits <= 56U && m_next_byte < m_size)
+		{
+			m_buffer |= static_cast<Uint64>(m_data[m_next_byte++]) << m_buffered_bits;
+			m_buffered_bits += 8U;
+		}
+	}
+
+	Compressed2StreamDecoder::Compressed2StreamDecoder(ByteSpan input, std::size_t offset)
+		: Compressed2StreamDecoder(input, offset, 0, false, std::numeric_limits<std::size_t>::max())
+	{
+	}
+
+	Compressed2StreamDecoder::Compressed2StreamDecoder(ByteSpan input, std::size_t offset, std::size_t bit_position, bool after_clear, std::size_t stop_output_size)
+		: m_reader(input.data() + std::min(offset, input.size()), input.size() - std::min(offset, input.size()))
+		, m_stop_output_size(stop_output_size)
+		, m_expect_literal(after_clear)
+	{
+		if (offset >= input.size() || bit_position / 8 >= input.size() - offset)
+		{
+			m_result.error_msg = "Compressed2 start offset is outside the input";
+			m_finished = true;
+			return;
+		}
+
+		for (Uint16 value = 0; value < 0x0100U; ++value)
+		{
+			m_dictionary.length[value] = 1;
+		}
+		m_reader.Skip(bit_position);
+		// Every stream in the game fits the 64 KiB of VRAM it is unpacked to.
+		m_result.output.reserve(0x10000);
+	}
+
+	bool Compressed2StreamDecoder::Fail(const char* message)
+	{
+		m_result.consumed_bits = m_reader.GetConsumedBits();
+		m_result.error_msg = message;
+		m_finished = true;
+		return false;
+	}
+
+	bool Compressed2StreamDecoder::DecodeAll()
+	{
+		return DecodeUntil(std::numeric_limits<std::size_t>::max());
+	}
+
+	bool Compressed2StreamDecoder::DecodeUntil(std::size_t output_size)
+	{
+		if (m_finished)
+		{
+			return !m_result.error_msg.has_value();
+		}
+
+		std::vector<Uint8>& output = m_result.output;
+		// The game starts as if a zero byte had just been decoded, so the first token of a
+		// stream still defines entry 0x102. The token after a CLEAR is a literal that
+		// defines no entry.
+		while (output.size() < output_size)
+		{
+			if (m_token_count++ >= Compressed2Decoder::s_max_tokens)
+			{
+				return Fail("Compressed2 stream exceeded the token limit");
+			}
+
+			Uint16 code = 0;
+			if (!m_reader.Read(m_width, code))
+			{
+				return Fail(m_expect_literal ? "Compressed2 CLEAR token has no following literal" : "Unexpected end of Compressed2 stream");
+			}
+			if (code == kEndCode)
+			{
+				m_result.consumed_bits = m_reader.GetConsumedBits();
+				m_finished = true;
+				return true;
+			}
+
+			if (m_expect_literal)
+			{
+				if (code > 0x00FFU)
+				{
+					return Fail("Compressed2 CLEAR token is not followed by a literal");
+				}
+				output.emplace_back(static_cast<Uint8>(code));
+				m_previous_code = code;
+				m_expect_literal = false;
+				continue;
+			}
+
+			if (code == kClearCode)
+			{
+				if (output.size() >= m_stop_output_size)
+				{
+					m_result.consumed_bits = m_reader.GetConsumedBits();
+					m_finished = true;
+					return true;
+				}
+				if (!output.empty())
+				{
+					m_result.reset_output_positions.emplace_back(output.size());
+					m_result.reset_bit_positions.emplace_back(m_reader.GetConsumedBits());
+				}
+				m_width = kMinimumWidth;
+				m_next_code = kFirstDictionaryCode;
+				m_next_width_threshold = 0x0200U;
+				m_expect_literal = true;
+				continue;
+			}
+
+			const std::size_t string_start = output.size();
+			if (code < m_next_code)
+			{
+				Expand(m_dictionary, code, output);
+			}
+			else if (code == m_next_code && m_next_code < kDictionarySize)
+			{
+				// The entry being defined by this very token: the previous string plus its own first byte.
+				Expand(m_dictionary, m_previous_code, output);
+				const Uint8 first_byte = output[string_start];
+				output.emplace_back(first_byte);
+			}
+			else
+			{
+				return Fail("Invalid Compressed2 dictionary code");
+			}
+
+			if (m_next_code < kDictionarySize)
+			{
+				m_dictionary.prefix[m_next_code] = m_previous_code;
+				m_dictionary.suffix[m_next_code] = output[string_start];
+				m_dictionary.length[m_next_code] = static_cast<Uint16>(m_dictionary.length[m_previous_code] + 1);
+				++m_next_code;
+			}
+			if (m_next_code >= m_next_width_threshold && m_width < kMaximumWidth)
+			{
+				++m_width;
+				m_next_width_threshold = static_cast<Uint16>(m_next_width_threshold << 1U);
+			}
+			m_previous_code = code;
+
+			if (output.size() > Compressed2Decoder::s_max_output_size)
+			{
+				return Fail("Compressed2 output exceeded the maximum size");
+			}
+		}
+
+		m_result.consumed_bits = m_reader.GetConsumedBits();
+		return true;
+	}
+
+	Compressed2DecodeResult Compressed2Decoder::Decode(ByteSpan input, std::size_t offset)
+	{
+		Compressed2StreamDecoder decoder{ input, offset };
+		decoder.DecodeAll();
+		return decoder.TakeResult();
+	}
+
+	Compressed2DecodeResult Compressed2Decoder::DecodeSegments(ByteSpan input, std::size_t offset, std::size_t bit_position, std::size_t output_size)
+	{
+		Compressed2StreamDecoder decoder{ input, offset, bit_position, true, output_size };
+		decoder.DecodeAll();
+		return decoder.TakeResult();
+	}
+}
@@ -1,11 +1,19 @@
 #include "rom/compressed2_optimizer.h"
 
+#include "rom/compressed2_decoder.h"
+#include "rom/compressed2_trie.h"
+
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <chrono>
 #include <cmath>
 #include <cstdint>
+#include <iterator>
 #include <limits>
-#include <unordered_map>
+#include <optional>
+#include <sstream>
+#include <thread>
 #include <utility>
 
 namespace spintool::rom
@@ -33,6 +41,31 @@ namespace spintool::rom
 				}
 			}
 
+			// Appends bits [begin_bit, end_bit) of an LSB-first stream.
+			void WriteBits(const std::vector<Uint8>& bytes, std::size_t begin_bit, const std::size_t end_bit)
+			{
+				if (m_buffered_bits == 0U && (begin_bit & 7U) == 0U)
+				{
+					const std::size_t whole_bytes = (end_bit - begin_bit) / 8U;
+					const auto first = bytes.begin() + static_cast<std::ptrdiff_t>(begin_bit / 8U);
+					m_bytes.insert(m_bytes.end(), first, first + static_cast<std::ptrdiff_t>(whole_bytes));
+					m_total_bits += whole_bytes * 8U;
+					begin_bit += whole_bytes * 8U;
+				}
+				while (begin_bit < end_bit)
+				{
+					const unsigned int count = static_cast<unsigned int>(std::min<std::size_t>(16U, end_bit - begin_bit));
+					const std::size_t byte = begin_bit / 8U;
+					Uint32 window = 0U;
+					for (std::size_t i = 0U; i < 3U && byte + i < bytes.size(); ++i)
+					{
+						window |= static_cast<Uint32>(bytes[byte + i]) << (i * 8U);
+					}
+					Write(static_cast<Uint16>((window >> (begin_bit & 7U)) & ((1U << count) - 1U)), count);
+					begin_bit += count;
+				}
+			}
+
 			std::vector<Uint8> Finish()
 			{
 				if (m_buffered_bits != 0U)
@@ -62,6 +95,8 @@ namespace spintool::rom
 			bool adaptive = false;
 			std::size_t adaptive_minimum_bytes = 0U;
 			double adaptive_degradation = 0.0;
+			// Replaces forced_reset_positions with the layout PlanOptimalResets finds.
+			bool optimal_resets = false;
 			std::string name;
 		};
 
@@ -69,21 +104,192 @@ namespace spintool::rom
 		{
 			std::vector<Uint8> data;
 			std::size_t bit_count = 0U;
+			// Width of the END token, the last code in the stream.
+			unsigned int final_width = 9U;
 			std::string strategy;
 		};
 
-		EncodedCandidate EncodeWithPolicy(
+		// Clears may only be placed on this grid at first; the second pass then also tries
+		// every position within one step of the clears the first pass chose.
+		constexpr std::size_t kResetPlanStep = 64U;
+		constexpr int kResetPlanPasses = 3;
+
+		// Finds the CLEAR positions giving the fewest stream bits, by dynamic programming
+		// over the candidate positions. A segment always starts from an empty dictionary,
+		// so its cost only depends on where it starts and ends: the codes EncodeWithPolicy
+		// writes for it, plus the CLEAR or END after it at the width it reached. One greedy
+		// LZW pass from each candidate start prices every segment beginning there, until
+		// the dictionary reaches code 0x7FF, the largest the game's decoder can hold.
+		// Candidates are a grid refined around the chosen clears, so the plan is optimal
+		// for the final candidate set rather than for every byte position.
+		std::vector<std::size_t> PlanOptimalResets(const std::vector<Uint8>& source, Compressed2Trie& trie)
+		{
+			const std::size_t size = source.size();
+			if (size < 2U)
+			{
+				return {};
+			}
+
+			constexpr std::size_t kUnreachable = std::numeric_limits<std::size_t>::max();
+
+			std::vector<std::size_t> candidates;
+			for (std::size_t position = 0U; position < size; position += kResetPlanStep)
+			{
+				candidates.emplace_back(position);
+			}
+			candidates.emplace_back(size);
+
+			std::vector<std::size_t> resets;
+			std::size_t previous_total = kUnreachable;
+			for (int pass = 0; pass < kResetPlanPasses; ++pass)
+			{
+				// best_bits[i]: fewest bits to encode source[0, candidates[i]) ending in a
+				// CLEAR, counting the CLEAR every stream starts with.
+				std::vector<std::size_t> best_bits(candidates.size(), kUnreachable);
+				std::vector<std::size_t> best_start(candidates.size(), 0U);
+				best_bits[0] = 9U;
+
+				for (std::size_t start_index = 0U; start_index + 1U < candidates.size(); ++start_index)
+				{
+					if (best_bits[start_index] == kUnreachable)
+					{
+						continue;
+					}
+
+					trie.Clear();
+					const std::size_t start = candidates[start_index];
+					std::size_t end_index = start_index + 1U;
+					std::size_t segment_bits = 0U;
+					unsigned int width = 9U;
+					Uint16 next_dictionary_code = kFirstDictionaryCode;
+					Uint16 decoder_next_code = kFirstDictionaryCode;
+					Uint16 decoder_width_threshold = 0x0200U;
+					bool first_data_code = true;
+					Uint16 current_code = source[start];
+
+					// Flushes the pending code and prices the CLEAR or END that follows it.
+					auto close_segment = [&]()
+					{
+						unsigned int closing_width = width;
+						if (!first_data_code &&
+							static_cast<Uint16>(decoder_next_code + 1U) >= decoder_width_threshold &&
+							width < 11U)
+						{
+							++closing_width;
+						}
+						return best_bits[start_index] + segment_bits + width + closing_width;
+					};
+					auto relax = [&](std::size_t index, std::size_t bits)
+					{
+						if (bits < best_bits[index])
+						{
+							best_bits[index] = bits;
+							best_start[index] = start_index;
+						}
+					};
+
+					for (std::size_t position = start + 1U; position <= size; ++position)
+					{
+						if (position == candidates[end_index])
+						{
+							relax(end_index, close_segment());
+							if (++end_index == candidates.size())
+							{
+								break;
+							}
+						}
+						if (position == size)
+						{
+							break;
+						}
+
+						const Uint16 child = trie.Find(current_code, source[position]);
+						if (child != Compressed2Trie::s_no_child)
+						{
+							current_code = child;
+							continue;
+						}
+
+						segment_bits += width;
+						if (first_data_code)
+						{
+							first_data_code = false;
+						}
+						else if (++decoder_next_code >= decoder_width_threshold && width < 11U)
+						{
+							++width;
+							decoder_width_threshold = static_cast<Uint16>(decoder_width_threshold << 1U);
+						}
+						if (next_dictionary_code > kMaximumDictionaryCode)
+						{
+							// The encoder would clear here on its own; longer segments are not allowed.
+							break;
+						}
+						trie.Insert(current_code, source[position], next_dictionary_code++);
+						current_code = source[position];
+					}
+				}
+
+				const std::size_t total = best_bits.back();
+				if (total == kUnreachable || total >= previous_total)
+				{
+					break;
+				}
+				previous_total = total;
+
+				resets.clear();
+				for (std::size_t index = best_start.back(); index != 0U; index = best_start[index])
+				{
+					resets.emplace_back(candidates[index]);
+				}
+				std::reverse(resets.begin(), resets.end());
+
+				std::vector<std::size_t> refined;
+				for (const std::size_t reset : resets)
+				{
+					const std::size_t first = reset > kResetPlanStep ? reset - kResetPlanStep : 1U;
+					const std::size_t last = std::min(reset + kResetPlanStep, size - 1U);
+					for (std::size_t position = first; position <= last; ++position)
+					{
+						refined.emplace_back(position);
+					}
+				}
+				std::sort(refined.begin(), refined.end());
+				std::vector<std::size_t> merged;
+				merged.reserve(candidates.size() + refined.size());
+				std::merge(candidates.begin(), candidates.end(), refined.begin(), refined.end(), std::back_inserter(merged));
+				merged.erase(std::unique(merged.begin(), merged.end()), merged.end());
+				if (merged.size() == candidates.size())
+				{
+					break;
+				}
+				candidates = std::move(merged);
+			}
+			return resets;
+		}
+
+		// Gives up and returns nothing once the stream grows past bit_limit, which other
+		// workers lower as they finish smaller streams.
+		std::optional<EncodedCandidate> EncodeWithPolicy(
 			const std::vector<Uint8>& source,
-			const EncodingPolicy& policy
+			const EncodingPolicy& policy,
+			Compressed2Trie& trie,
+			const std::atomic<std::size_t>* bit_limit = nullptr
 		)
 		{
+			if (policy.optimal_resets)
+			{
+				EncodingPolicy planned = policy;
+				planned.optimal_resets = false;
+				planned.forced_reset_positions = PlanOptimalResets(source, trie);
+				return EncodeWithPolicy(source, planned, trie, bit_limit);
+			}
+
 			const Uint8 fallback_zero = 0U;
 			const Uint8* input = source.empty() ? &fallback_zero : source.data();
 			const std::size_t input_size = source.empty() ? 1U : source.size();
 
 			LsbBitWriter bit_writer;
-			std::unordered_map<Uint32, Uint16> transitions;
-			transitions.reserve(2048U);
 
 			Uint16 next_dictionary_code = kFirstDictionaryCode;
 			unsigned int stream_width = 9U;
@@ -97,7 +303,7 @@ namespace spintool::rom
 
 			auto reset_encoder_dictionary = [&]()
 			{
-				transitions.clear();
+				trie.Clear();
 				next_dictionary_code = kFirstDictionaryCode;
 			};
 			auto reset_stream_state = [&]()
@@ -133,6 +339,11 @@ namespace spintool::rom
 				}
 			};
 
+			auto over_limit = [&]()
+			{
+				return bit_limit && bit_writer.GetTotalBits() > bit_limit->load(std::memory_order_relaxed);
+			};
+
 			write_clear(0U);
 			Uint16 current_code = input[0];
 			for (std::size_t position = 1U; position < input_size; ++position)
@@ -150,6 +361,10 @@ namespace spintool::rom
 				if (forced_reset || fixed_segment_reset)
 				{
 					write_data_code(current_code);
+					if (over_limit())
+					{
+						return std::nullopt;
+					}
 					write_clear(position);
 					current_code = input[position];
 					if (forced_reset)
@@ -160,17 +375,18 @@ namespace spintool::rom
 				}
 
 				const Uint8 next_byte = input[position];
-				const Uint32 transition_key =
-					(static_cast<Uint32>(current_code) << 8U) |
-					static_cast<Uint32>(next_byte);
-				const auto found = transitions.find(transition_key);
-				if (found != transitions.end())
+				const Uint16 child = trie.Find(current_code, next_byte);
+				if (child != Compressed2Trie::s_no_child)
 				{
-					current_code = found->second;
+					current_code = child;
 					continue;
 				}
 
 				write_data_code(current_code);
+				if (over_limit())
+				{
+					return std::nullopt;
+				}
 
 				bool adaptive_reset = false;
 				if (policy.adaptive)
@@ -200,7 +416,7 @@ namespace spintool::rom
 				}
 				else if (next_dictionary_code <= kMaximumDictionaryCode)
 				{
-					transitions.emplace(transition_key, next_dictionary_code);
+					trie.Insert(current_code, next_byte, next_dictionary_code);
 					++next_dictionary_code;
 				}
 				else
@@ -212,8 +428,13 @@ namespace spintool::rom
 
 			write_data_code(current_code);
 			bit_writer.Write(kEndCode, stream_width);
+			if (over_limit())
+			{
+				return std::nullopt;
+			}
 			EncodedCandidate result;
 			result.bit_count = bit_writer.GetTotalBits();
+			result.final_width = stream_width;
 			result.data = bit_writer.Finish();
 			result.strategy = policy.name;
 			return result;
@@ -258,7 +479,30 @@ namespace spintool::rom
 	}
 
 	bool Compressed2Optimizer::Decode(
-		const std::vector<Uint8>& input,
+		ByteSpan input,
+		const std::size_t offset,
+		std::vector<Uint8>& output,
+		std::string& error,
+		std::size_t* consumed_size,
+		std::vector<std::size_t>* reset_output_positions
+	)
+	{
+		Compressed2DecodeResult result = Compressed2Decoder::Decode(input, offset);
+		output = std::move(result.output);
+		error = result.error_msg.value_or(std::string{});
+		if (consumed_size)
+		{
+			*consumed_size = result.error_msg.has_value() ? 0U : result.GetConsumedSize();
+		}
+		if (reset_output_positions)
+		{
+			*reset_output_positions = std::move(result.reset_output_positions);
+		}
+		return !result.error_msg.has_value();
+	}
+
+	bool Compressed2Optimizer::DecodeReference(
+		ByteSpan input,
 		const std::size_t offset,
 		std::vector<Uint8>& output,
 		std::string& error,
@@ -412,27 +656,27 @@ namespace spintool::rom
 
 	Compressed2CompressionResult Compressed2Optimizer::Compress(
 		const std::vector<Uint8>& source,
-		const std::vector<Uint8>& original_stream
+		const std::vector<Uint8>& original_stream,
+		unsigned int num_threads
 	)
 	{
+		const auto start = std::chrono::steady_clock::now();
 		Compressed2CompressionResult result;
-		EncodedCandidate best;
-
-		auto test_policy = [&](EncodingPolicy policy)
-		{
-			EncodedCandidate candidate = EncodeWithPolicy(source, policy);
-			++result.candidates_tested;
-			if (IsBetter(candidate, best))
-			{
-				best = std::move(candidate);
-			}
-		};
 
 		EncodingPolicy baseline;
 		baseline.name = "full dictionary";
-		test_policy(baseline);
+		Compressed2Trie trie;
+		EncodedCandidate best = *EncodeWithPolicy(source, baseline, trie);
+		++result.candidates_tested;
 		result.baseline_size = best.data.size();
 
+		// Every other policy is collected first and encoded on the worker pool below.
+		std::vector<EncodingPolicy> policies;
+		auto add_policy = [&policies](EncodingPolicy policy)
+		{
+			policies.emplace_back(std::move(policy));
+		};
+
 		std::vector<std::size_t> original_resets;
 		if (!original_stream.empty())
 		{
@@ -468,7 +712,7 @@ namespace spintool::rom
 					EncodingPolicy original_layout;
 					original_layout.forced_reset_positions = original_resets;
 					original_layout.name = "original reset layout";
-					test_policy(std::move(original_layout));
+					add_policy(std::move(original_layout));
 
 					constexpr std::array<std::ptrdiff_t, 8> shifts =
 					{
@@ -487,12 +731,21 @@ namespace spintool::rom
 							continue;
 						}
 						shifted_layout.name = "shifted original reset layout";
-						test_policy(std::move(shifted_layout));
+						add_policy(std::move(shifted_layout));
 					}
 				}
 			}
 		}
 
+		// Queued first so its usually smallest stream tightens the cutoff for the rest.
+		// Inserted ahead of the original-layout policies, which are already queued.
+		{
+			EncodingPolicy policy;
+			policy.optimal_resets = true;
+			policy.name = "optimal reset placement";
+			policies.insert(policies.begin(), std::move(policy));
+		}
+
 		// Test smaller dictionary limits. Resetting before the table reaches its
 		// maximum can save enough 10/11-bit codes to offset the extra CLEAR token.
 		for (Uint16 limit = 0x0140U; limit < kMaximumDictionaryCode; limit =
@@ -501,14 +754,14 @@ namespace spintool::rom
 			EncodingPolicy policy;
 			policy.dictionary_limit = limit;
 			policy.name = "early dictionary reset";
-			test_policy(std::move(policy));
+			add_policy(std::move(policy));
 		}
 		for (const Uint16 limit : { Uint16(0x01FFU), Uint16(0x03FFU), Uint16(0x05FFU) })
 		{
 			EncodingPolicy policy;
 			policy.dictionary_limit = limit;
 			policy.name = "code-width boundary reset";
-			test_policy(std::move(policy));
+			add_policy(std::move(policy));
 		}
 
 		// Also test fixed source segment sizes. This is effective when an art block
@@ -529,7 +782,7 @@ namespace spintool::rom
 			EncodingPolicy policy;
 			policy.maximum_segment_bytes = segment_size;
 			policy.name = "fixed-size segments";
-			test_policy(std::move(policy));
+			add_policy(std::move(policy));
 		}
 
 		// Adaptive policies clear the dictionary only after its measured coding
@@ -548,7 +801,74 @@ namespace spintool::rom
 				policy.adaptive_minimum_bytes = minimum_bytes;
 				policy.adaptive_degradation = degradation;
 				policy.name = "adaptive ratio reset";
-				test_policy(std::move(policy));
+				add_policy(std::move(policy));
+			}
+		}
+
+		// Workers pull policies in order and share the size of the smallest finished
+		// stream, so a candidate stops as soon as it can no longer win. Results land in
+		// per-policy slots and are compared in policy order afterwards, so the winner is
+		// the one a serial run picks whatever the thread count: an abandoned candidate
+		// was already larger than some finished one.
+		std::atomic<std::size_t> best_bit_count{ best.bit_count };
+		std::atomic<std::size_t> next_policy{ 0U };
+		std::vector<std::optional<EncodedCandidate>> candidates(policies.size());
+		auto run_worker = [&](Compressed2Trie& worker_trie)
+		{
+			for (std::size_t i = next_policy++; i < policies.size(); i = next_policy++)
+			{
+				candidates[i] = EncodeWithPolicy(source, policies[i], worker_trie, &best_bit_count);
+				if (!candidates[i])
+				{
+					continue;
+				}
+				std::size_t current = best_bit_count.load(std::memory_order_relaxed);
+				while (candidates[i]->bit_count < current &&
+					!best_bit_count.compare_exchange_weak(current, candidates[i]->bit_count, std::memory_order_relaxed))
+				{
+				}
+			}
+		};
+
+		if (num_threads == 0U)
+		{
+			num_threads = std::max(1U, std::thread::hardware_concurrency());
+		}
+		num_threads = static_cast<unsigned int>(std::min<std::size_t>(num_threads, policies.size()));
+		if (num_threads <= 1U)
+		{
+			run_worker(trie);
+		}
+		else
+		{
+			// The calling thread is worker 0.
+			std::vector<std::thread> workers;
+			workers.reserve(num_threads - 1U);
+			for (unsigned int worker = 1U; worker < num_threads; ++worker)
+			{
+				workers.emplace_back([&run_worker]()
+					{
+						Compressed2Trie worker_trie;
+						run_worker(worker_trie);
+					});
+			}
+			run_worker(trie);
+			for (std::thread& worker : workers)
+			{
+				worker.join();
+			}
+		}
+
+		for (std::optional<EncodedCandidate>& candidate : candidates)
+		{
+			++result.candidates_tested;
+			if (!candidate)
+			{
+				++result.candidates_abandoned;
+			}
+			else if (IsBetter(*candidate, best))
+			{
+				best = std::move(*candidate);
 			}
 		}
 
@@ -562,12 +882,147 @@ namespace spintool::rom
 		{
 			// The baseline is built by the same compatible encoder but keep a safe,
 			// deterministic fallback rather than returning a possibly invalid stream.
-			best = EncodeWithPolicy(source, baseline);
+			best = *EncodeWithPolicy(source, baseline, trie);
 			best.strategy = "validated full dictionary fallback";
 		}
 
 		result.data = std::move(best.data);
 		result.strategy = std::move(best.strategy);
+		result.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		return result;
+	}
+
+	std::optional<Compressed2CompressionResult> Compressed2Optimizer::CompressIncremental(
+		const std::vector<Uint8>& source,
+		const std::vector<Uint8>& original_stream
+	)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		if (source.empty() || original_stream.empty())
+		{
+			return std::nullopt;
+		}
+
+		const Compressed2DecodeResult original = Compressed2Decoder::Decode(original_stream, 0U);
+		if (original.error_msg.has_value() || original.output.size() != source.size() ||
+			original.GetConsumedSize() > original_stream.size())
+		{
+			return std::nullopt;
+		}
+
+		// Segment k holds output [segment_begin[k], segment_begin[k + 1]), and its codes start
+		// at bit segment_bit[k], just after the CLEAR opening it (at bit 0 for the first).
+		std::vector<std::size_t> segment_begin{ 0U };
+		std::vector<std::size_t> segment_bit{ 0U };
+		segment_begin.insert(segment_begin.end(), original.reset_output_positions.begin(), original.reset_output_positions.end());
+		segment_bit.insert(segment_bit.end(), original.reset_bit_positions.begin(), original.reset_bit_positions.end());
+		segment_begin.emplace_back(source.size());
+		const std::size_t segment_count = segment_bit.size();
+
+		std::vector<bool> changed(segment_count);
+		bool any_changed = false;
+		for (std::size_t segment = 0U; segment < segment_count; ++segment)
+		{
+			const std::size_t begin = segment_begin[segment];
+			const std::size_t end = segment_begin[segment + 1U];
+			if (end <= begin)
+			{
+				// Back-to-back CLEARs leave nothing to splice between.
+				return std::nullopt;
+			}
+			changed[segment] = !std::equal(source.begin() + begin, source.begin() + end, original.output.begin() + begin);
+			any_changed |= changed[segment];
+		}
+
+		Compressed2CompressionResult result;
+		if (!any_changed)
+		{
+			result.data.assign(original_stream.begin(), original_stream.begin() + static_cast<std::ptrdiff_t>(original.GetConsumedSize()));
+			result.strategy = "original stream preserved";
+			result.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			return result;
+		}
+
+		struct SplicedRun
+		{
+			std::size_t bit_begin = 0U;
+			std::size_t bit_end = 0U;
+			std::size_t output_begin = 0U;
+			std::size_t output_end = 0U;
+		};
+		std::vector<SplicedRun> spliced_runs;
+		std::size_t segments_reencoded = 0U;
+
+		LsbBitWriter writer;
+		Compressed2Trie trie;
+		for (std::size_t segment = 0U; segment < segment_count;)
+		{
+			std::size_t run_end = segment;
+			while (run_end < segment_count && changed[run_end] == changed[segment])
+			{
+				++run_end;
+			}
+
+			if (!changed[segment])
+			{
+				// Untouched segments keep their bits, including the CLEAR or END after them,
+				// whose width only depends on the segment before it.
+				writer.WriteBits(original_stream, segment_bit[segment], run_end < segment_count ? segment_bit[run_end] : original.consumed_bits);
+				segment = run_end;
+				continue;
+			}
+
+			const std::vector<Uint8> payload(
+				source.begin() + static_cast<std::ptrdiff_t>(segment_begin[segment]),
+				source.begin() + static_cast<std::ptrdiff_t>(segment_begin[run_end])
+			);
+			EncodingPolicy full_dictionary;
+			EncodingPolicy planned;
+			planned.optimal_resets = true;
+			EncodedCandidate encoded = *EncodeWithPolicy(payload, full_dictionary, trie);
+			EncodedCandidate planned_encoded = *EncodeWithPolicy(payload, planned, trie);
+			result.candidates_tested += 2U;
+			if (planned_encoded.bit_count < encoded.bit_count)
+			{
+				encoded = std::move(planned_encoded);
+			}
+
+			if (segment == 0U)
+			{
+				writer.Write(kClearCode, 9U);
+			}
+			SplicedRun run;
+			run.bit_begin = writer.GetTotalBits();
+			run.output_begin = segment_begin[segment];
+			run.output_end = segment_begin[run_end];
+			// The encoded stream opens with a 9-bit CLEAR and closes with END at final_width;
+			// its codes go in between the neighbouring segments, closed at that same width.
+			writer.WriteBits(encoded.data, 9U, encoded.bit_count - encoded.final_width);
+			writer.Write(run_end < segment_count ? kClearCode : kEndCode, encoded.final_width);
+			run.bit_end = writer.GetTotalBits();
+			spliced_runs.emplace_back(run);
+
+			segments_reencoded += run_end - segment;
+			segment = run_end;
+		}
+		result.data = writer.Finish();
+
+		// Only the spliced bits are new; each run must decode to its slice of the payload and
+		// end exactly where the untouched bits resume.
+		for (const SplicedRun& run : spliced_runs)
+		{
+			const Compressed2DecodeResult check = Compressed2Decoder::DecodeSegments(result.data, 0U, run.bit_begin, run.output_end - run.output_begin);
+			if (check.error_msg.has_value() || check.consumed_bits != run.bit_end ||
+				!std::equal(check.output.begin(), check.output.end(), source.begin() + static_cast<std::ptrdiff_t>(run.output_begin), source.begin() + static_cast<std::ptrdiff_t>(run.output_end)))
+			{
+				return std::nullopt;
+			}
+		}
+
+		std::ostringstream strategy;
+		strategy << "incremental, " << segments_reencoded << " of " << segment_count << " segments re-encoded";
+		result.strategy = strategy.str();
+		result.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
 		return result;
 	}
 }
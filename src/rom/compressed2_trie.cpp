@@ -0,0 +1,21 @@
+#include "rom/compressed2_trie.h"
+
+#include <algorithm>
+
+namespace spintool::rom
+{
+	Compressed2Trie::Compressed2Trie()
+		: m_slots(s_max_codes * 0x100, 0)
+	{
+	}
+
+	void Compressed2Trie::Clear()
+	{
+		if (++m_generation > 0xFFFF)
+		{
+			// Stamps from 0xFFFF clears ago would look current again.
+			std::fill(m_slots.begin(), m_slots.end(), 0);
+			m_generation = 1;
+		}
+	}
+}
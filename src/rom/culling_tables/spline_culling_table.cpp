@@ -1,6 +1,8 @@
 #include "rom/culling_tables/spline_culling_table.h"
 
 #include "rom/spinball_rom.h"
+#include "rom/rom_cursor.h"
+#include <algorithm>
 #include <numeric>
 
 namespace spintool::rom
@@ -48,72 +50,79 @@ namespace spintool::rom
 	}
 
 	CollisionSpline CollisionSpline::LoadFromROM(const SpinballROM& rom, Ptr32 offset)
+	{
+		ROMCursor cursor = rom.GetCursor(offset, size_on_rom);
+		CollisionSpline new_spline = LoadFromROM(cursor);
+		rom.GetAssetIndex().Register(ROMAssetType::CollisionSpline, new_spline.rom_data);
+		return new_spline;
+	}
+
+	CollisionSpline CollisionSpline::LoadFromROM(ROMCursor& cursor)
 	{
 		CollisionSpline new_spline;
 
-		Ptr32 current_offset = offset;
+		const Ptr32 offset = cursor.GetOffset();
+		const std::array<Uint16, size_on_rom / 2> fields = cursor.ReadUint16s<size_on_rom / 2>();
 
-		new_spline.spline_vector.min.x = rom.ReadUint16(current_offset);
-		current_offset += 2;
-		new_spline.spline_vector.min.y = rom.ReadUint16(current_offset);
-		current_offset += 2;
-		new_spline.spline_vector.max.x = rom.ReadUint16(current_offset);
-		current_offset += 2;
-		new_spline.spline_vector.max.y = rom.ReadUint16(current_offset);
-		current_offset += 2;
+		new_spline.spline_vector.min.x = fields[0];
+		new_spline.spline_vector.min.y = fields[1];
+		new_spline.spline_vector.max.x = fields[2];
+		new_spline.spline_vector.max.y = fields[3];
 
-		new_spline.object_type_flags = rom.ReadUint16(current_offset);
-		current_offset += 2;
-		new_spline.instance_id_binding = rom.ReadUint16(current_offset);
-		current_offset += 2;
+		new_spline.object_type_flags = fields[4];
+		new_spline.instance_id_binding = fields[5];
 
-		new_spline.rom_data.SetROMData(offset, current_offset);
+		new_spline.rom_data.SetROMData(offset, offset + size_on_rom);
 
 		return new_spline;
 	}
 
 	Ptr32 CollisionSpline::SaveToROM(SpinballROM& rom, Ptr32 offset) const
 	{
-		Ptr32 current_offset = offset;
-
-		current_offset = rom.WriteUint16(current_offset, spline_vector.min.x);
-		current_offset = rom.WriteUint16(current_offset, spline_vector.min.y);
-		current_offset = rom.WriteUint16(current_offset, spline_vector.max.x);
-		current_offset = rom.WriteUint16(current_offset, spline_vector.max.y);
+		ROMWriter writer{ offset };
+		SaveToROM(writer);
+		return writer.Commit(rom);
+	}
 
-		current_offset = rom.WriteUint16(current_offset, object_type_flags);
-		current_offset = rom.WriteUint16(current_offset, instance_id_binding);
+	void CollisionSpline::SaveToROM(ROMWriter& writer) const
+	{
+		writer.WriteUint16(static_cast<Uint16>(spline_vector.min.x));
+		writer.WriteUint16(static_cast<Uint16>(spline_vector.min.y));
+		writer.WriteUint16(static_cast<Uint16>(spline_vector.max.x));
+		writer.WriteUint16(static_cast<Uint16>(spline_vector.max.y));
 
-		return current_offset;
+		writer.WriteUint16(object_type_flags);
+		writer.WriteUint16(instance_id_binding);
 	}
 
 	SplineCullingTable SplineCullingTable::LoadFromROM(const SpinballROM& rom, const Ptr32 offset)
 	{
-		rom; offset;
 		SplineCullingTable new_table;
 
-		Ptr32 next_offset = offset;
-
-		for (SplineCullingCell& cell : new_table.cells)
+		std::array<Uint16, cells_count> jump_table{};
+		rom.GetCursor(offset, cells_count * 2).ReadUint16Array(jump_table.data(), jump_table.size());
+		for (Uint32 i = 0; i < cells_count; ++i)
 		{
-			cell.jump_offset = rom.ReadUint16(next_offset);
-			next_offset += 2;
+			new_table.cells[i].jump_offset = jump_table[i];
 		}
 
-		for (int i = 0; i < cells_count - 1; ++i)
+		for (Uint32 i = 0; i < cells_count - 1; ++i)
 		{
 			const Uint32 start_offset = offset + (new_table.cells[i].jump_offset * 2);
-			const Uint32 data_start_offset = start_offset + 2;
-			const Uint32 end_offset = offset + (new_table.cells[i + 1].jump_offset * 2);
-
-			SplineCullingCell& cell = new_table.cells[i];
 			const Uint16 num_objects = rom.ReadUint16(start_offset);
-			new_table.cells[i].splines.resize(num_objects);
 
+			// One bounds check per cell; a cell that runs off the end of the image decodes as
+			// zeroed splines, as the per-field reads used to.
+			ROMCursor cursor = rom.GetCursor(start_offset + 2, num_objects * CollisionSpline::size_on_rom);
+			std::vector<CollisionSpline>& splines = new_table.cells[i].splines;
+			splines.reserve(num_objects);
 			for (Uint16 s = 0; s < num_objects; ++s)
 			{
-				const rom::Ptr32 short_offset = s * CollisionSpline::size_on_rom;
-				new_table.cells[i].splines[s] = CollisionSpline::LoadFromROM(rom, data_start_offset + short_offset);
+				splines.emplace_back(CollisionSpline::LoadFromROM(cursor));
+				if (!cursor.HasFailed())
+				{
+					rom.GetAssetIndex().Register(ROMAssetType::CollisionSpline, splines.back().rom_data);
+				}
 			}
 		}
 
@@ -122,20 +131,27 @@ namespace spintool::rom
 
 	Ptr32 SplineCullingTable::SaveToROM(SpinballROM& rom, Ptr32 offset) const
 	{
-		Ptr32 jump_table_offset = offset;
-		Ptr32 data_offset = jump_table_offset + static_cast<Uint32>(cells_count) * 2;
+		// Built in memory and written as one block: the jump table first, then each cell's
+		// spline count and splines, then the terminator.
+		const Uint32 jump_table_size = static_cast<Uint32>(cells_count) * 2;
+		ROMWriter jump_table{ offset };
+		ROMWriter data{ offset + jump_table_size };
+		jump_table.Reserve(jump_table_size);
+		data.Reserve(GetSizeOnROM() - jump_table_size);
 
 		for (const SplineCullingCell& cell : cells)
 		{
-			jump_table_offset = rom.WriteUint16(jump_table_offset, (data_offset - offset) / 2);
-			data_offset = rom.WriteUint16(data_offset, static_cast<Uint16>(cell.splines.size()));
+			jump_table.WriteUint16(static_cast<Uint16>((data.GetOffset() - offset) / 2));
+			data.WriteUint16(static_cast<Uint16>(cell.splines.size()));
 			for (const CollisionSpline& spline : cell.splines)
 			{
-				data_offset = spline.SaveToROM(rom, data_offset);
+				spline.SaveToROM(data);
 			}
 		}
-		data_offset = rom.WriteUint16(data_offset, (data_offset - jump_table_offset) / 2);
-		return data_offset;
+		data.WriteUint16(static_cast<Uint16>((data.GetOffset() - jump_table.GetOffset()) / 2));
+
+		jump_table.WriteBytes(data.GetBytes());
+		return jump_table.Commit(rom);
 	}
 
 	Uint32 SplineCullingTable::CalculateTableSize() const
@@ -147,4 +163,29 @@ namespace spintool::rom
 			});
 	}
 
+	Uint32 SplineCullingTable::GetSizeOnROM() const
+	{
+		return CalculateTableSize() + static_cast<Uint32>(cells_count * 2) + 2;
+	}
+
+	ROMData SplineCullingTable::MeasureOnROM(const SpinballROM& rom, const Ptr32 offset)
+	{
+		ROMData rom_data;
+		const Uint32 last_cell_jump = offset + (cells_count - 1) * 2;
+		if (last_cell_jump + 2 > rom.m_buffer.size())
+		{
+			return rom_data;
+		}
+
+		const Uint32 last_cell = offset + rom.ReadUint16(last_cell_jump) * 2;
+		if (last_cell + 2 > rom.m_buffer.size())
+		{
+			return rom_data;
+		}
+
+		const Uint32 table_end = last_cell + 2 + rom.ReadUint16(last_cell) * CollisionSpline::size_on_rom + 2;
+		rom_data.SetROMData(offset, std::min<Uint32>(table_end, static_cast<Uint32>(rom.m_buffer.size())));
+		return rom_data;
+	}
+
 }
\ No newline at end of file
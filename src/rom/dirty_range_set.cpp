@@ -0,0 +1,73 @@
+#include "rom/dirty_range_set.h"
+
+#include <algorithm>
+
+namespace spintool::rom
+{
+	bool RangesOverlap(const std::vector<DirtyRange>& ranges, Uint32 begin, Uint32 end)
+	{
+		return std::any_of(ranges.begin(), ranges.end(), [begin, end](const DirtyRange& range)
+			{
+				return range.begin < end && begin < range.end;
+			});
+	}
+
+	void DirtyRangeSet::Add(Uint32 begin, Uint32 end)
+	{
+		if (begin >= end)
+		{
+			return;
+		}
+
+		// Step back to the range that starts before us, in case it touches or overlaps.
+		auto it = m_ranges.upper_bound(begin);
+		if (it != m_ranges.begin() && std::prev(it)->second >= begin)
+		{
+			--it;
+		}
+
+		while (it != m_ranges.end() && it->first <= end)
+		{
+			begin = std::min(begin, it->first);
+			end = std::max(end, it->second);
+			m_total_bytes -= it->second - it->first;
+			it = m_ranges.erase(it);
+		}
+
+		m_ranges.emplace_hint(it, begin, end);
+		m_total_bytes += end - begin;
+	}
+
+	void DirtyRangeSet::Clear()
+	{
+		m_ranges.clear();
+		m_total_bytes = 0;
+	}
+
+	bool DirtyRangeSet::Overlaps(Uint32 begin, Uint32 end) const
+	{
+		if (begin >= end)
+		{
+			return false;
+		}
+
+		auto it = m_ranges.lower_bound(end);
+		if (it == m_ranges.begin())
+		{
+			return false;
+		}
+		--it;
+		return it->second > begin;
+	}
+
+	std::vector<DirtyRange> DirtyRangeSet::GetRanges() const
+	{
+		std::vector<DirtyRange> ranges;
+		ranges.reserve(m_ranges.size());
+		for (const auto& [begin, end] : m_ranges)
+		{
+			ranges.emplace_back(DirtyRange{ begin, end });
+		}
+		return ranges;
+	}
+}
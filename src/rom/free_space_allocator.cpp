@@ -0,0 +1,348 @@
+#include "rom/free_space_allocator.h"
+
+#include "rom/dirty_range_set.h"
+#include "rom/rom_asset_index.h"
+#include "rom/spinball_rom.h"
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+
+namespace spintool::rom
+{
+	namespace
+	{
+		// Header field holding the address of the last byte of the cartridge.
+		constexpr Uint32 kHeaderROMEndOffset = 0x1A4;
+		constexpr Uint32 kHeaderEnd = 0x200;
+		// The image grows in steps of this size rather than byte by byte.
+		constexpr Uint32 kGrowthGranularity = 0x10000;
+		// Assets can legitimately end in a few padding-valued bytes, so never hand out the
+		// start of a padding run.
+		constexpr Uint32 kPaddingRunGuard = 0x20;
+
+		constexpr Uint32 AlignUp(Uint32 value, Uint32 alignment)
+		{
+			return alignment <= 1 ? value : ((value + alignment - 1) / alignment) * alignment;
+		}
+	}
+
+	void FreeSpaceAllocator::Clear()
+	{
+		m_ranges.clear();
+		m_by_size.clear();
+		m_total_free = 0;
+	}
+
+	void FreeSpaceAllocator::Insert(Uint32 begin, Uint32 end)
+	{
+		m_ranges.emplace(begin, end);
+		m_by_size.emplace(end - begin, begin);
+		m_total_free += end - begin;
+	}
+
+	std::map<Uint32, Uint32>::iterator FreeSpaceAllocator::Erase(std::map<Uint32, Uint32>::iterator it)
+	{
+		m_by_size.erase({ it->second - it->first, it->first });
+		m_total_free -= it->second - it->first;
+		return m_ranges.erase(it);
+	}
+
+	void FreeSpaceAllocator::Release(Uint32 begin, Uint32 end)
+	{
+		if (begin >= end)
+		{
+			return;
+		}
+
+		auto it = m_ranges.upper_bound(begin);
+		if (it != m_ranges.begin() && std::prev(it)->second >= begin)
+		{
+			--it;
+		}
+
+		while (it != m_ranges.end() && it->first <= end)
+		{
+			begin = std::min(begin, it->first);
+			end = std::max(end, it->second);
+			it = Erase(it);
+		}
+
+		Insert(begin, end);
+	}
+
+	void FreeSpaceAllocator::Reserve(Uint32 begin, Uint32 end)
+	{
+		if (begin >= end)
+		{
+			return;
+		}
+
+		auto it = m_ranges.upper_bound(begin);
+		if (it != m_ranges.begin() && std::prev(it)->second > begin)
+		{
+			--it;
+		}
+
+		while (it != m_ranges.end() && it->first < end)
+		{
+			const Uint32 range_begin = it->first;
+			const Uint32 range_end = it->second;
+			it = Erase(it);
+
+			if (range_begin < begin)
+			{
+				Insert(range_begin, begin);
+			}
+			if (range_end > end)
+			{
+				Insert(end, range_end);
+				break;
+			}
+		}
+	}
+
+	std::optional<Uint32> FreeSpaceAllocator::Allocate(Uint32 size, Uint32 alignment)
+	{
+		if (size == 0)
+		{
+			return std::nullopt;
+		}
+
+		// The best fit by size only works if its start is already aligned. A range with
+		// alignment - 1 spare bytes always fits, so that is the fallback.
+		auto candidate = m_by_size.lower_bound({ size, 0 });
+		if (candidate != m_by_size.end() && AlignUp(candidate->second, alignment) + size > candidate->second + candidate->first)
+		{
+			candidate = m_by_size.lower_bound({ size + alignment - 1, 0 });
+		}
+		if (candidate == m_by_size.end())
+		{
+			return std::nullopt;
+		}
+
+		const Uint32 offset = AlignUp(candidate->second, alignment);
+		Reserve(offset, offset + size);
+		return offset;
+	}
+
+	bool FreeSpaceAllocator::IsFree(Uint32 begin, Uint32 end) const
+	{
+		if (begin >= end)
+		{
+			return true;
+		}
+
+		auto it = m_ranges.upper_bound(begin);
+		if (it == m_ranges.begin())
+		{
+			return false;
+		}
+		--it;
+		return it->first <= begin && it->second >= end;
+	}
+
+	Uint32 FreeSpaceAllocator::LargestFree() const
+	{
+		return m_by_size.empty() ? 0 : m_by_size.rbegin()->first;
+	}
+
+	AssetRelocator::AssetRelocator(SpinballROM& rom, const std::vector<ROMData>& known_assets)
+		: m_rom(rom)
+	{
+		const FreeSpaceSettings& settings = m_rom.m_free_space_settings;
+		const Uint32 image_size = static_cast<Uint32>(m_rom.m_buffer.size());
+		const Uint8* const image = m_rom.m_buffer.data();
+
+		// Interior padding runs are left alone: uncompressed art and tables the session has
+		// not decoded can hold long runs of the padding byte too. Only the run that pads the
+		// image out to its end is known to be unused.
+		Uint32 tail_begin = image_size;
+		while (tail_begin > kHeaderEnd && image[tail_begin - 1] == settings.padding_byte)
+		{
+			--tail_begin;
+		}
+
+		if (image_size - tail_begin >= std::max(settings.min_padding_run, kPaddingRunGuard + 1))
+		{
+			m_allocator.Release(tail_begin + kPaddingRunGuard, image_size);
+		}
+
+		const Uint32 expanded_size = std::min(settings.expanded_size, FreeSpaceSettings::s_max_expanded_size);
+		if (expanded_size > image_size)
+		{
+			m_allocator.Release(image_size, expanded_size);
+		}
+
+		m_live_assets = known_assets;
+		for (const ROMAssetRef& asset : m_rom.GetAssetIndex().FindOverlapping(0, std::numeric_limits<Uint32>::max()))
+		{
+			m_live_assets.emplace_back(asset.rom_data);
+		}
+		for (const ROMData& asset : m_live_assets)
+		{
+			m_allocator.Reserve(asset.rom_offset, asset.rom_offset_end);
+		}
+	}
+
+	std::optional<Ptr32> AssetRelocator::SaveAsset(
+		const ROMData& current_extent,
+		Uint32 new_size,
+		const std::vector<Uint32>& pointer_locations,
+		const AssetWriter& writer
+	)
+	{
+		if (new_size <= current_extent.real_size)
+		{
+			writer(m_rom, current_extent.rom_offset);
+			ROMData trimmed_extent;
+			trimmed_extent.SetROMData(current_extent.rom_offset, current_extent.rom_offset + new_size);
+			MoveLiveAsset(current_extent, trimmed_extent);
+			Release(trimmed_extent.rom_offset_end, current_extent.rom_offset_end);
+			return current_extent.rom_offset;
+		}
+
+		if (!CanRepoint(pointer_locations, current_extent.rom_offset))
+		{
+			return std::nullopt;
+		}
+
+		const std::optional<Ptr32> new_offset = Allocate(new_size);
+		if (!new_offset)
+		{
+			std::cerr << "No free space for a 0x" << std::hex << new_size
+				<< " byte asset (largest free block 0x" << m_allocator.LargestFree()
+				<< ")\n" << std::dec;
+			return std::nullopt;
+		}
+
+		writer(m_rom, *new_offset);
+		Repoint(pointer_locations, *new_offset);
+
+		ROMData new_extent;
+		new_extent.SetROMData(*new_offset, *new_offset + new_size);
+		MoveLiveAsset(current_extent, new_extent);
+		Release(current_extent.rom_offset, current_extent.rom_offset_end);
+		m_rom.GetAssetIndex().Relocate(current_extent, new_extent);
+		return new_offset;
+	}
+
+	std::optional<Ptr32> AssetRelocator::Allocate(Uint32 size, Uint32 alignment)
+	{
+		const std::optional<Uint32> offset = m_allocator.Allocate(size, alignment);
+		if (!offset)
+		{
+			return std::nullopt;
+		}
+
+		if (!GrowImageToFit(*offset + size))
+		{
+			m_allocator.Release(*offset, *offset + size);
+			return std::nullopt;
+		}
+		return offset;
+	}
+
+	void AssetRelocator::Release(Uint32 begin, Uint32 end)
+	{
+		if (begin >= end || end > m_rom.m_buffer.size())
+		{
+			return;
+		}
+
+		m_live_assets.erase(
+			std::remove_if(m_live_assets.begin(), m_live_assets.end(), [begin, end](const ROMData& asset)
+				{
+					return asset.rom_offset >= begin && asset.rom_offset_end <= end;
+				}),
+			m_live_assets.end());
+
+		// Another level or table can still be reading part of the range.
+		DirtyRangeSet live;
+		for (const ROMData& asset : m_live_assets)
+		{
+			if (asset.rom_offset < end && begin < asset.rom_offset_end)
+			{
+				live.Add(std::max(asset.rom_offset, begin), std::min(asset.rom_offset_end, end));
+			}
+		}
+
+		Uint32 free_begin = begin;
+		std::vector<DirtyRange> live_ranges = live.GetRanges();
+		live_ranges.emplace_back(DirtyRange{ end, end });
+		for (const DirtyRange& live_range : live_ranges)
+		{
+			if (free_begin < live_range.begin)
+			{
+				m_rom.FillBytes(free_begin, m_rom.m_free_space_settings.padding_byte, live_range.begin - free_begin);
+				m_allocator.Release(free_begin, live_range.begin);
+			}
+			free_begin = std::max(free_begin, live_range.end);
+		}
+	}
+
+	void AssetRelocator::MoveLiveAsset(const ROMData& from, const ROMData& to)
+	{
+		m_live_assets.erase(
+			std::remove_if(m_live_assets.begin(), m_live_assets.end(), [&from](const ROMData& asset)
+				{
+					return asset.rom_offset >= from.rom_offset && asset.rom_offset_end <= from.rom_offset_end;
+				}),
+			m_live_assets.end());
+		m_live_assets.emplace_back(to);
+	}
+
+	bool AssetRelocator::CanRepoint(const std::vector<Uint32>& pointer_locations, Ptr32 old_offset) const
+	{
+		if (pointer_locations.empty())
+		{
+			std::cerr << "Cannot move the asset at 0x" << std::hex << old_offset
+				<< ": nothing is known to point at it\n" << std::dec;
+			return false;
+		}
+
+		for (const Uint32 location : pointer_locations)
+		{
+			if (m_rom.ReadUint32(location) != old_offset)
+			{
+				std::cerr << "Cannot move the asset at 0x" << std::hex << old_offset
+					<< ": the pointer at 0x" << location << " holds 0x"
+					<< m_rom.ReadUint32(location) << '\n' << std::dec;
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void AssetRelocator::Repoint(const std::vector<Uint32>& pointer_locations, Ptr32 new_offset)
+	{
+		for (const Uint32 location : pointer_locations)
+		{
+			m_rom.WriteUint32(location, new_offset);
+		}
+	}
+
+	bool AssetRelocator::GrowImageToFit(Uint32 end)
+	{
+		const Uint32 image_size = static_cast<Uint32>(m_rom.m_buffer.size());
+		if (end <= image_size)
+		{
+			return true;
+		}
+
+		const FreeSpaceSettings& settings = m_rom.m_free_space_settings;
+		const Uint32 expanded_size = std::min(settings.expanded_size, FreeSpaceSettings::s_max_expanded_size);
+		if (end > expanded_size)
+		{
+			return false;
+		}
+
+		const Uint32 new_size = std::min(AlignUp(end, kGrowthGranularity), expanded_size);
+		m_rom.Resize(new_size, settings.padding_byte);
+		if (new_size >= kHeaderROMEndOffset + sizeof(Uint32))
+		{
+			m_rom.WriteUint32(kHeaderROMEndOffset, new_size - 1);
+		}
+		return true;
+	}
+}
@@ -1,6 +1,7 @@
 #include "rom/game_objects/game_object_flipper.h"
 
 #include "rom/spinball_rom.h"
+#include "rom/rom_cursor.h"
 
 namespace spintool::rom
 {
@@ -8,40 +9,35 @@ namespace spintool::rom
 	{
 		FlipperInstance new_instance;
 
-		Uint32 current_offset = offset;
-
-		new_instance.animated_obj_ptr = rom.ReadUint32(current_offset);
-		current_offset += 4;
-		new_instance.x_pos = rom.ReadUint16(current_offset);
-		current_offset += 2;
-		new_instance.y_pos = rom.ReadUint16(current_offset);
-		current_offset += 2;
-		new_instance.flags = rom.ReadUint16(current_offset);
-		current_offset += 2;
+		ROMCursor cursor = rom.GetCursor(offset, 10);
+		new_instance.animated_obj_ptr = cursor.ReadUint32();
+		new_instance.x_pos = cursor.ReadUint16();
+		new_instance.y_pos = cursor.ReadUint16();
+		new_instance.flags = cursor.ReadUint16();
 		if ((new_instance.flags & 0x4000) == 0x4000)
 		{
 			new_instance.is_x_flipped = true;
 		}
-		new_instance.rom_data.SetROMData(offset, current_offset);
+		new_instance.rom_data.SetROMData(offset, offset + 10);
 
 		return new_instance;
 	}
 
 	Uint32 FlipperInstance::SaveToROM(rom::SpinballROM& writeable_rom) const
 	{
-		Uint32 current_offset = rom_data.rom_offset;
+		ROMWriter writer{ rom_data.rom_offset };
 
-		current_offset = writeable_rom.WriteUint32(current_offset, animated_obj_ptr);
-		current_offset = writeable_rom.WriteUint16(current_offset, x_pos);
-		current_offset = writeable_rom.WriteUint16(current_offset, y_pos);
+		writer.WriteUint32(animated_obj_ptr);
+		writer.WriteUint16(x_pos);
+		writer.WriteUint16(y_pos);
 		Uint16 flags = 0;
 		if (is_x_flipped)
 		{
 			flags |= (0x4000);
 		}
-		current_offset = writeable_rom.WriteUint16(current_offset, flags);
+		writer.WriteUint16(flags);
 
-		return current_offset;
+		return writer.Commit(writeable_rom);
 	}
 
 	Point FlipperInstance::GetDrawPosOffset() const
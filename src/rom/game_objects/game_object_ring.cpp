@@ -1,35 +1,41 @@
 #include "rom/game_objects/game_object_ring.h"
 
 #include "rom/spinball_rom.h"
+#include "rom/rom_cursor.h"
 
 namespace spintool::rom
 {
 	RingInstance RingInstance::LoadFromROM(const rom::SpinballROM& rom, Uint32 offset)
 	{
-		RingInstance new_instance;
+		ROMCursor cursor = rom.GetCursor(offset, 6);
+		return LoadFromROM(cursor);
+	}
 
-		Uint32 current_offset = offset;
+	RingInstance RingInstance::LoadFromROM(ROMCursor& cursor)
+	{
+		RingInstance new_instance;
 
-		new_instance.instance_id = rom.ReadUint16(current_offset);
-		current_offset += 2;
-		new_instance.x_pos = rom.ReadUint16(current_offset);
-		current_offset += 2;
-		new_instance.y_pos = rom.ReadUint16(current_offset);
-		current_offset += 2;
+		const Uint32 offset = cursor.GetOffset();
+		new_instance.instance_id = cursor.ReadUint16();
+		new_instance.x_pos = cursor.ReadUint16();
+		new_instance.y_pos = cursor.ReadUint16();
 
-		new_instance.rom_data.SetROMData(offset, current_offset);
+		new_instance.rom_data.SetROMData(offset, offset + 6);
 		return new_instance;
 	}
 
 	Uint32 RingInstance::SaveToROM(rom::SpinballROM& writeable_rom) const
 	{
-		Uint32 current_offset = rom_data.rom_offset;
-
-		current_offset = writeable_rom.WriteUint16(current_offset, instance_id);
-		current_offset = writeable_rom.WriteUint16(current_offset, x_pos);
-		current_offset = writeable_rom.WriteUint16(current_offset, y_pos);
+		ROMWriter writer{ rom_data.rom_offset };
+		SaveToROM(writer);
+		return writer.Commit(writeable_rom);
+	}
 
-		return current_offset;
+	void RingInstance::SaveToROM(ROMWriter& writer) const
+	{
+		writer.WriteUint16(instance_id);
+		writer.WriteUint16(x_pos);
+		writer.WriteUint16(y_pos);
 	}
 
 }
\ No newline at end of file
@@ -2,6 +2,11 @@
 
 #include "rom/rom_asset_definitions.h"
 #include "rom/spinball_rom.h"
+#include "rom/free_space_allocator.h"
+#include "rom/tileset.h"
+#include "rom/ssc_compressor.h"
+#include "rom/tile_brush.h"
+#include "rom/tile_order_optimizer.h"
 #include "rom/culling_tables/spline_culling_table.h"
 #include "rom/culling_tables/game_obj_collision_culling_table.h"
 #include "rom/culling_tables/animated_object_culling_table.h"
@@ -26,6 +31,207 @@ namespace spintool::rom
 			const std::size_t start = static_cast<std::size_t>(offset);
 			return start <= rom_size && length <= (rom_size - start);
 		}
+
+		// Every entry of a per-level pointer table that points at target. Levels can share
+		// assets, and all of them have to follow the asset if it moves.
+		std::vector<Uint32> FindTableReferences(const SpinballROM& rom, const Ptr32 table_offset, const Ptr32 target)
+		{
+			std::vector<Uint32> references;
+			for (int level_index = 0; level_index < level_count; ++level_index)
+			{
+				const Uint32 location = table_offset + static_cast<Uint32>(sizeof(Ptr32) * level_index);
+				if (RangeIsValid(rom, location, sizeof(Ptr32)) && rom.ReadUint32(location) == target)
+				{
+					references.emplace_back(location);
+				}
+			}
+			return references;
+		}
+
+		Uint32 GetLayoutSizeOnROM(const SpinballROM& rom, const LevelDataOffsets& offsets)
+		{
+			constexpr Uint32 brush_width_px = TileBrush::s_default_brush_width * TileSet::s_tile_width;
+			constexpr Uint32 brush_height_px = TileBrush::s_default_brush_height * TileSet::s_tile_height;
+			const Uint32 layout_width = rom.ReadUint16(offsets.tile_layout_width) / brush_width_px;
+			const Uint32 layout_height = rom.ReadUint16(offsets.tile_layout_height) / brush_height_px;
+			return layout_width * layout_height * sizeof(Uint16);
+		}
+
+		constexpr Uint32 brush_size_on_rom = TileBrush::s_default_total_tiles * sizeof(Uint16);
+
+		// Bytes of the brush table at brushes_offset that some layout still indexes. Layers
+		// of several levels can share one table, so this is the most any of their layouts
+		// uses, leaving out the layout at skipped_layout when it is about to be rewritten.
+		Uint32 MeasureBrushTable(const SpinballROM& rom, const Ptr32 brushes_offset, const Ptr32 skipped_layout = std::numeric_limits<Ptr32>::max())
+		{
+			Uint32 brush_count = 0;
+			for (int level_index = 0; level_index < level_count; ++level_index)
+			{
+				const LevelDataOffsets offsets{ level_index };
+				const Uint32 layout_size = GetLayoutSizeOnROM(rom, offsets);
+				const std::pair<Ptr32, Ptr32> layers[] = {
+					{ offsets.background_tile_layout, offsets.background_tile_brushes },
+					{ offsets.foreground_tile_layout, offsets.foreground_tile_brushes }
+				};
+				for (const auto& [layout_pointer, brushes_pointer] : layers)
+				{
+					if (!RangeIsValid(rom, layout_pointer, sizeof(Ptr32)) || !RangeIsValid(rom, brushes_pointer, sizeof(Ptr32)) ||
+						rom.ReadUint32(brushes_pointer) != brushes_offset)
+					{
+						continue;
+					}
+					const Ptr32 layout_offset = rom.ReadUint32(layout_pointer);
+					if (layout_offset != skipped_layout && RangeIsValid(rom, layout_offset, layout_size))
+					{
+						brush_count = std::max(brush_count, TileLayout::CountReferencedBrushes(rom, layout_offset, layout_size));
+					}
+				}
+			}
+			return brush_count * brush_size_on_rom;
+		}
+
+		bool SaveTileLayer(SpinballROM& rom, AssetRelocator& relocator, const TileLayer& layer, const Ptr32 brushes_pointer, const Ptr32 layout_pointer, const Ptr32 brushes_table)
+		{
+			layer.tile_layout->CollapseTilesIntoBrushes(*layer.tileset);
+
+			const Ptr32 brushes_offset = rom.ReadUint32(brushes_pointer);
+			const Ptr32 layout_offset = rom.ReadUint32(layout_pointer);
+			const Uint32 layout_size = static_cast<Uint32>(layer.tile_layout->layout_width * layer.tile_layout->layout_height) * sizeof(Uint16);
+			if (layout_offset > rom.m_buffer.size() || layout_size > rom.m_buffer.size() - layout_offset)
+			{
+				std::cerr << "Not saving tile layout at 0x" << std::hex << layout_offset
+					<< ": it extends past the end of the ROM\n" << std::dec;
+				return false;
+			}
+
+			// The brushes currently on ROM are measured from the layouts currently on ROM, so
+			// this has to happen before the new layout is written. Brushes other layouts still
+			// index past the end of this one's are kept where they are.
+			ROMData brushes_extent;
+			brushes_extent.SetROMData(brushes_offset, brushes_offset + MeasureBrushTable(rom, brushes_offset));
+			const Uint32 brushes_size = std::max(layer.tile_layout->GetBrushesSizeOnROM(), MeasureBrushTable(rom, brushes_offset, layout_offset));
+
+			const std::optional<Ptr32> saved_offset = relocator.SaveAsset(
+				brushes_extent,
+				brushes_size,
+				FindTableReferences(rom, brushes_table, brushes_offset),
+				[&layer](SpinballROM& rom, Ptr32 offset)
+				{
+					return layer.tile_layout->SaveBrushesToROM(rom, offset);
+				});
+			if (!saved_offset)
+			{
+				std::cerr << "Not saving tile layout at 0x" << std::hex << layout_offset
+					<< ": its brushes could not be written\n" << std::dec;
+				return false;
+			}
+
+			layer.tile_layout->SaveLayoutToROM(rom, layout_offset);
+			return true;
+		}
+
+		bool SaveTileLayers(SpinballROM& rom, AssetRelocator& relocator, const Level& level)
+		{
+			const std::vector<TileLayer>& layers = level.m_tile_layers;
+			if (layers.size() < 2 ||
+				!layers[0].tile_layout || !layers[0].tileset ||
+				!layers[1].tile_layout || !layers[1].tileset)
+			{
+				return false;
+			}
+
+			const LevelDataOffsets& offsets = level.m_data_offsets;
+			bool success = SaveTileLayer(rom, relocator, layers[0], offsets.background_tile_brushes, offsets.background_tile_layout, offsets.table_offsets.background_tile_brushes);
+			success &= SaveTileLayer(rom, relocator, layers[1], offsets.foreground_tile_brushes, offsets.foreground_tile_layout, offsets.table_offsets.foreground_tile_brushes);
+			return success;
+		}
+	}
+
+	std::vector<rom::ROMData> Level::CollectAssetExtents(const rom::SpinballROM& rom)
+	{
+		std::vector<rom::ROMData> extents;
+		for (int level_index = 0; level_index < level_count; ++level_index)
+		{
+			const std::vector<rom::ROMData> level_extents = CollectAssetExtents(rom, level_index);
+			extents.insert(extents.end(), level_extents.begin(), level_extents.end());
+		}
+		return extents;
+	}
+
+	std::vector<rom::ROMData> Level::CollectAssetExtents(const rom::SpinballROM& rom, int level_index)
+	{
+		std::vector<rom::ROMData> extents;
+		if (level_index < 0 || level_index >= level_count)
+		{
+			return extents;
+		}
+
+		auto add_extent = [&extents](const Uint32 begin, const Uint32 end)
+			{
+				if (begin < end)
+				{
+					extents.emplace_back().SetROMData(begin, end);
+				}
+			};
+
+		const rom::LevelDataOffsets offsets{ level_index };
+
+		for (const Ptr32 tileset_pointer : { offsets.background_tileset, offsets.foreground_tileset })
+		{
+			const TilesetEntry entry = TileSet::LoadFromROM_SSCCompression(rom, rom.ReadUint32(tileset_pointer));
+			if (!entry.result.error_msg.has_value() && entry.tileset)
+			{
+				extents.emplace_back(entry.tileset->rom_data);
+			}
+		}
+
+		const Uint32 layout_size = GetLayoutSizeOnROM(rom, offsets);
+		const std::pair<Ptr32, Ptr32> layers[] = {
+			{ offsets.background_tile_layout, offsets.background_tile_brushes },
+			{ offsets.foreground_tile_layout, offsets.foreground_tile_brushes }
+		};
+		for (const auto& [layout_pointer, brushes_pointer] : layers)
+		{
+			const Ptr32 layout_offset = rom.ReadUint32(layout_pointer);
+			if (RangeIsValid(rom, layout_offset, layout_size))
+			{
+				add_extent(layout_offset, layout_offset + layout_size);
+				const Ptr32 brushes_offset = rom.ReadUint32(brushes_pointer);
+				add_extent(brushes_offset, brushes_offset + MeasureBrushTable(rom, brushes_offset));
+			}
+		}
+
+		const Ptr32 spline_offset = rom.ReadUint32(offsets.collision_data_terrain);
+		if (RangeIsValid(rom, spline_offset, 2))
+		{
+			extents.emplace_back(SplineCullingTable::MeasureOnROM(rom, spline_offset));
+		}
+
+		add_extent(offsets.ring_instances.offset, offsets.ring_instances.offset + offsets.ring_instances.count * static_cast<Uint32>(ring_instance_size));
+		add_extent(offsets.object_instances.offset, offsets.object_instances.offset + offsets.object_instances.count * static_cast<Uint32>(GameObjectDefinition::s_size_on_rom));
+
+		if (RangeIsValid(rom, offsets.flipper_data, sizeof(Ptr32)) && RangeIsValid(rom, offsets.flipper_count, sizeof(Uint16)))
+		{
+			const Ptr32 flippers_offset = rom.ReadUint32(offsets.flipper_data);
+			add_extent(flippers_offset, flippers_offset + rom.ReadUint16(offsets.flipper_count) * static_cast<Uint32>(FlipperInstance::s_size_on_rom));
+		}
+
+		if (offsets.collision_tile_obj_ids.offset != 0 && RangeIsValid(rom, offsets.collision_tile_obj_ids.offset, GameObjectCullingTable::cells_count * sizeof(Uint16)))
+		{
+			const Ptr32 culling_offset = offsets.collision_tile_obj_ids.offset;
+			// CalculateTableSize leaves out the per-cell counts and the trailing word SaveToROM writes.
+			add_extent(culling_offset, culling_offset + GameObjectCullingTable::LoadFromROM(rom, culling_offset).CalculateTableSize() + GameObjectCullingTable::cells_count * sizeof(Uint16) + sizeof(Uint16));
+		}
+		if (RangeIsValid(rom, offsets.camera_activation_sector_anim_obj_ids, sizeof(Ptr32)))
+		{
+			const Ptr32 culling_offset = rom.ReadUint32(offsets.camera_activation_sector_anim_obj_ids);
+			if (RangeIsValid(rom, culling_offset, AnimatedObjectCullingTable::cells_count))
+			{
+				add_extent(culling_offset, culling_offset + AnimatedObjectCullingTable::LoadFromROM(rom, culling_offset).CalculateTableSize() + AnimatedObjectCullingTable::cells_count + 1);
+			}
+		}
+
+		return extents;
 	}
 
 	Level Level::LoadFromROM(const rom::SpinballROM& target_rom, int level_index)
@@ -96,21 +302,12 @@ namespace spintool::rom
 		}
 		else
 		{
+			// The whole table was validated above, so decode it without per-ring checks.
+			rom::ROMCursor cursor = target_rom.GetCursor(level_data_offsets.ring_instances.offset, static_cast<Uint32>(requested_ring_bytes));
 			new_level.m_ring_instances.reserve(level_data_offsets.ring_instances.count);
-			Uint32 current_table_offset = level_data_offsets.ring_instances.offset;
-
 			for (Uint32 i = 0; i < level_data_offsets.ring_instances.count; ++i)
 			{
-				if (!RangeIsValid(target_rom, current_table_offset, ring_instance_size))
-				{
-					std::cerr << "Stopping ring loading at item " << i
-						<< ": offset is outside ROM\n";
-					break;
-				}
-
-				new_level.m_ring_instances.emplace_back(
-					rom::RingInstance::LoadFromROM(target_rom, current_table_offset));
-				current_table_offset += static_cast<Uint32>(ring_instance_size);
+				new_level.m_ring_instances.emplace_back(rom::RingInstance::LoadFromROM(cursor));
 			}
 		}
 
@@ -136,16 +333,30 @@ namespace spintool::rom
 
 	rom::Ptr32 Level::SaveToROM(rom::SpinballROM& target_rom) const
 	{
-		if (m_tile_layers.size() >= 2 &&
-			m_tile_layers[0].tile_layout && m_tile_layers[0].tileset &&
-			m_tile_layers[1].tile_layout && m_tile_layers[1].tileset)
-		{
-			m_tile_layers[0].tile_layout->SaveToROM(target_rom, *m_tile_layers[0].tileset, target_rom.ReadUint32(m_data_offsets.background_tile_brushes), target_rom.ReadUint32(m_data_offsets.background_tile_layout));
-			m_tile_layers[1].tile_layout->SaveToROM(target_rom, *m_tile_layers[1].tileset, target_rom.ReadUint32(m_data_offsets.foreground_tile_brushes), target_rom.ReadUint32(m_data_offsets.foreground_tile_layout));
-		}
+		rom::AssetRelocator relocator{ target_rom, CollectAssetExtents(target_rom) };
+
+		SaveTileLayers(target_rom, relocator, *this);
 
 		if (m_spline_culling_table)
-			m_spline_culling_table->SaveToROM(target_rom, target_rom.ReadUint32(m_data_offsets.collision_data_terrain));
+		{
+			const rom::Ptr32 spline_offset = target_rom.ReadUint32(m_data_offsets.collision_data_terrain);
+			const rom::ROMData spline_extent = rom::SplineCullingTable::MeasureOnROM(target_rom, spline_offset);
+			if (spline_extent.real_size == 0)
+			{
+				m_spline_culling_table->SaveToROM(target_rom, spline_offset);
+			}
+			else
+			{
+				relocator.SaveAsset(
+					spline_extent,
+					m_spline_culling_table->GetSizeOnROM(),
+					FindTableReferences(target_rom, m_data_offsets.table_offsets.collision_data_terrain, spline_offset),
+					[this](rom::SpinballROM& rom, rom::Ptr32 offset)
+					{
+						return m_spline_culling_table->SaveToROM(rom, offset);
+					});
+			}
+		}
 		if (m_data_offsets.collision_tile_obj_ids.offset != 0 && m_game_object_culling_table)
 		{
 			const rom::Ptr32 obj_end = m_game_object_culling_table->SaveToROM(target_rom, m_data_offsets.collision_tile_obj_ids.offset);
@@ -169,4 +380,107 @@ namespace spintool::rom
 
 		return 0;
 	}
+
+	bool Level::SaveTilesetsToROM(rom::SpinballROM& target_rom, std::vector<TilesetSaveStats>* out_stats) const
+	{
+		if (m_tile_layers.size() < 2)
+		{
+			return false;
+		}
+
+		rom::AssetRelocator relocator{ target_rom, CollectAssetExtents(target_rom) };
+		const std::pair<rom::Ptr32, rom::Ptr32> tileset_pointers[] = {
+			{ m_data_offsets.background_tileset, m_data_offsets.table_offsets.background_tileset },
+			{ m_data_offsets.foreground_tileset, m_data_offsets.table_offsets.foreground_tileset }
+		};
+
+		bool success = true;
+		for (size_t layer_index = 0; layer_index < std::size(tileset_pointers); ++layer_index)
+		{
+			const std::shared_ptr<const rom::TileSet>& tileset = m_tile_layers[layer_index].tileset;
+			if (!tileset || tileset->tiles.empty())
+			{
+				continue;
+			}
+
+			const auto& [tileset_pointer, tileset_table] = tileset_pointers[layer_index];
+			const rom::Ptr32 tileset_offset = target_rom.ReadUint32(tileset_pointer);
+			const TilesetEntry current = rom::TileSet::LoadFromROM_SSCCompression(target_rom, tileset_offset);
+			if (current.result.error_msg.has_value() || !current.tileset)
+			{
+				std::cerr << "Cannot save tileset at 0x" << std::hex << tileset_offset
+					<< ": the tileset currently there does not decode\n" << std::dec;
+				success = false;
+				continue;
+			}
+
+			rom::SSCCompressionStats compression_stats;
+			const std::vector<Uint8> encoded = tileset->EncodeSSCCompression(&compression_stats);
+			if (out_stats != nullptr)
+			{
+				out_stats->emplace_back(TilesetSaveStats{ tileset_offset, current.tileset->rom_data.real_size, compression_stats });
+			}
+			success &= relocator.SaveAsset(
+				current.tileset->rom_data,
+				static_cast<Uint32>(encoded.size()),
+				FindTableReferences(target_rom, tileset_table, tileset_offset),
+				[&encoded](rom::SpinballROM& rom, rom::Ptr32 offset)
+				{
+					return rom.WriteBytes(offset, encoded);
+				}).has_value();
+		}
+
+		return success;
+	}
+
+	bool Level::SaveTileLayersToROM(rom::SpinballROM& target_rom) const
+	{
+		rom::AssetRelocator relocator{ target_rom, CollectAssetExtents(target_rom) };
+		return SaveTileLayers(target_rom, relocator, *this);
+	}
+
+	std::size_t Level::OptimiseTileOrder(const rom::SpinballROM& rom)
+	{
+		if (m_tile_layers.size() < 2)
+		{
+			return 0;
+		}
+
+		const std::pair<rom::Ptr32, rom::Ptr32> shared_assets[][2] = {
+			{ { m_data_offsets.background_tileset, m_data_offsets.table_offsets.background_tileset }, { m_data_offsets.background_tile_brushes, m_data_offsets.table_offsets.background_tile_brushes } },
+			{ { m_data_offsets.foreground_tileset, m_data_offsets.table_offsets.foreground_tileset }, { m_data_offsets.foreground_tile_brushes, m_data_offsets.table_offsets.foreground_tile_brushes } }
+		};
+
+		std::size_t bytes_saved = 0;
+		for (size_t layer_index = 0; layer_index < std::size(shared_assets); ++layer_index)
+		{
+			rom::TileLayer& layer = m_tile_layers[layer_index];
+			if (!layer.tileset || !layer.tile_layout || layer.tileset->tiles.empty())
+			{
+				continue;
+			}
+
+			// Another level's brushes would still point at the old tile order.
+			const bool is_shared = std::any_of(std::begin(shared_assets[layer_index]), std::end(shared_assets[layer_index]),
+				[&rom](const std::pair<rom::Ptr32, rom::Ptr32>& asset)
+				{
+					return FindTableReferences(rom, asset.second, rom.ReadUint32(asset.first)).size() > 1;
+				});
+			if (is_shared)
+			{
+				continue;
+			}
+
+			const rom::TileOrder order = rom::TileOrderOptimizer::Optimise(layer.tileset->uncompressed_data, CompressionAlgorithm::SSC);
+			if (order.IsIdentity())
+			{
+				continue;
+			}
+
+			layer.tileset = layer.tileset->CreateReordered(order.new_to_old);
+			layer.tile_layout->RemapTileIndices(order.old_to_new);
+			bytes_saved += order.original_size - order.optimised_size;
+		}
+		return bytes_saved;
+	}
 }
@@ -1,7 +1,10 @@
 #include "rom/lzss_decompressor.h"
 
+#include "rom/compressed2_decoder.h"
+
 #include "SDL3/SDL_stdinc.h"
 #include <array>
+#include <utility>
 
 namespace spintool::rom
 {
@@ -22,7 +25,7 @@ namespace spintool::rom
 		return std::nullopt;
 	}
 
-	LZSSDecompressionResult LZSSDecompressor::DecompressData(const std::vector<Uint8>& in_data, const Uint32 offset)
+	LZSSDecompressionResult LZSSDecompressor::DecompressData(ByteSpan in_data, const Uint32 offset)
 	{
 		const Uint32 start_offset = 0;
 
@@ -221,7 +224,7 @@ loc_F5B6A:  // CODE XREF : DoLoadCompressed2Tiles:loc_F5B7A
 		}
 	}
 
-	LZSSDecompressionResult LZSSDecompressor::DecompressDataRefactored(const std::vector<Uint8>& in_data, const Uint32 offset)
+	LZSSDecompressionResult LZSSDecompressor::DecompressDataRefactored(ByteSpan in_data, const Uint32 offset)
 	{
 		LZSSDecompressionResult failure;
 		if (offset >= in_data.size())
@@ -484,4 +487,29 @@ loc_F5B6A:  // CODE XREF : DoLoadCompressed2Tiles:loc_F5B7A
 			// End of function DoLoadCompressed2Tiles
 		}
 	}
+
+	LZSSDecompressionResult LZSSDecompressor::DecompressDataFast(ByteSpan in_data, const Uint32 offset)
+	{
+		LZSSDecompressionResult results;
+		if (offset >= in_data.size())
+		{
+			results.error_msg = "LZSS start offset is outside the input buffer";
+			return results;
+		}
+
+		Compressed2DecodeResult decoded = Compressed2Decoder::Decode(in_data, offset);
+		results.uncompressed_data = std::move(decoded.output);
+		results.uncompressed_data.resize(results.uncompressed_data.size() & ~static_cast<size_t>(1));
+		results.uncompressed_data.insert(results.uncompressed_data.begin(), 2, 0);
+		results.uncompressed_size = results.uncompressed_data.size();
+		if (decoded.error_msg.has_value())
+		{
+			results.error_msg = std::move(decoded.error_msg);
+			return results;
+		}
+
+		// The game's end pointer counts whole bytes consumed, so a partial final byte is left out.
+		results.rom_data.SetROMData(offset, offset + static_cast<Uint32>(decoded.consumed_bits >> 3));
+		return results;
+	}
 }
@@ -5,13 +5,52 @@
 #include "json.hpp"
 
 #include <algorithm>
+#include <iostream>
 
 namespace spintool::rom
 {
+    namespace
+    {
+        constexpr size_t kHeaderRegionOffset = 0x1F0;
+        constexpr size_t kHeaderRegionSize = 3;
+
+        std::string_view GetVersionFromHeader(ByteSpan image)
+        {
+            const ByteSpan region = image.subspan(kHeaderRegionOffset, kHeaderRegionSize);
+            const auto has_region = [&region](char code)
+            {
+                return std::find(std::begin(region), std::end(region), static_cast<Uint8>(code)) != std::end(region);
+            };
+
+            // Only a cartridge locked to a single market says anything about the version.
+            // Multi-region carts such as "JUE" fall back to the USA metadata like unknown ones.
+            const bool usa = has_region('U');
+            const bool eur = has_region('E');
+            const bool jp = has_region('J');
+            if (usa + eur + jp != 1)
+            {
+                return "usa";
+            }
+            if (eur)
+            {
+                return "eur";
+            }
+            if (jp)
+            {
+                return "jp";
+            }
+            return "usa";
+        }
+    }
+
     void ROMMetadata::Serialise(nlohmann::json& writer)
     {
         writer["version"] = version_id;
         writer["path"] = location_on_disk.string();
+        if (content_hash)
+        {
+            writer["hash"] = content_hash->ToString();
+        }
         level_data_table_offsets.Serialise(writer["data_tables"]);
 
         {
@@ -54,6 +93,13 @@ namespace spintool::rom
                 std::filesystem::path{path_it->get<std::string>()};
         }
 
+        content_hash.reset();
+        if (const auto hash_it = reader.find("hash");
+            hash_it != reader.end() && hash_it->is_string())
+        {
+            content_hash = ROMHash::FromString(hash_it->get<std::string>());
+        }
+
         if (const auto tables_it = reader.find("data_tables");
             tables_it != reader.end() && tables_it->is_object())
         {
@@ -104,6 +150,44 @@ namespace spintool::rom
         return nullptr;
     }
 
+    ROMMetadata* Metadata::GetROMMetadataFor(const ROMHash& content_hash)
+    {
+        auto result_it = std::find_if(std::begin(rom_metadatas), std::end(rom_metadatas), [&content_hash](const ROMMetadata& entry)
+        {
+            return entry.content_hash == content_hash;
+        });
+
+        if (result_it != std::end(rom_metadatas))
+        {
+            return &(*result_it);
+        }
+
+        return nullptr;
+    }
+
+    ROMMetadata* Metadata::IdentifyROM(ByteSpan image, const ROMHash& content_hash)
+    {
+        if (ROMMetadata* known = GetROMMetadataFor(content_hash))
+        {
+            return known;
+        }
+
+        ROMMetadata* metadata = GetROMMetadataFor(GetVersionFromHeader(image));
+        if (metadata == nullptr)
+        {
+            return nullptr;
+        }
+
+        if (metadata->content_hash)
+        {
+            std::cerr << "ROM " << content_hash.ToString() << " replaces "
+                << metadata->content_hash->ToString() << " as version "
+                << metadata->version_id << '\n';
+        }
+        metadata->content_hash = content_hash;
+        return metadata;
+    }
+
     Metadata::Metadata()
     {
         rom_metadatas.emplace_back().version_id = "usa";
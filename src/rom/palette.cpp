@@ -22,6 +22,10 @@ namespace spintool::rom
 
 		new_palette->offset = offset;
 
+		ROMData rom_data;
+		rom_data.SetROMData(offset, offset + s_palette_size_on_rom);
+		src_rom.GetAssetIndex().Register(ROMAssetType::Palette, rom_data);
+
 		for (Swatch& palette_swatch : new_palette->palette_swatches)
 		{
 			palette_swatch.packed_value = src_rom.ReadUint16(offset);
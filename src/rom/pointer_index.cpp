@@ -0,0 +1,285 @@
+#include "rom/pointer_index.h"
+
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <thread>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#endif
+
+namespace spintool::rom
+{
+	namespace
+	{
+		constexpr std::size_t kPointerBytes = 4;
+		// A block reads the whole longword at its last offset.
+		constexpr std::size_t kBlockReadBytes = PointerIndex::s_block_size + kPointerBytes - 1;
+		// Lanes of a block that start on an even offset, for blocks that do.
+		constexpr Uint32 kEvenLanes = 0x5555;
+
+		Uint16 ReadBE16(const Uint8* bytes)
+		{
+			return static_cast<Uint16>((static_cast<Uint16>(bytes[0]) << 8) | bytes[1]);
+		}
+
+		Uint32 ReadBE32(const Uint8* bytes)
+		{
+			return (static_cast<Uint32>(ReadBE16(bytes)) << 16) | ReadBE16(bytes + 2);
+		}
+
+		bool BySource(const PointerReference& lhs, const PointerReference& rhs)
+		{
+			return lhs.source < rhs.source;
+		}
+
+		bool ByTarget(const PointerReference& lhs, const PointerReference& rhs)
+		{
+			return lhs.target < rhs.target || (lhs.target == rhs.target && lhs.source < rhs.source);
+		}
+
+		// targets must be sorted and disjoint, as DirtyRangeSet hands them out.
+		bool IsTarget(const std::vector<DirtyRange>& targets, Uint32 value)
+		{
+			auto it = std::upper_bound(targets.begin(), targets.end(), value, [](Uint32 lhs, const DirtyRange& rhs)
+				{
+					return lhs < rhs.begin;
+				});
+			return it != targets.begin() && value < std::prev(it)->end;
+		}
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+		// Bit i is set when the big-endian word at first + i is in [high_min, high_max].
+		Uint32 PrefilterBlock(const Uint8* first, Uint16 high_min, Uint16 high_max)
+		{
+			const __m128i b0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+			const __m128i b1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first + 1));
+			// Interleaving each byte with the one after it puts the big-endian word at every
+			// offset into a little-endian 16-bit lane.
+			const __m128i words_low = _mm_unpacklo_epi8(b1, b0);
+			const __m128i words_high = _mm_unpackhi_epi8(b1, b0);
+
+			// SSE2 only compares signed words, so flip the sign bit on both sides.
+			const __m128i bias = _mm_set1_epi16(static_cast<short>(0x8000));
+			const __m128i min = _mm_set1_epi16(static_cast<short>(high_min ^ 0x8000));
+			const __m128i max = _mm_set1_epi16(static_cast<short>(high_max ^ 0x8000));
+			auto outside = [&](__m128i words)
+			{
+				words = _mm_xor_si128(words, bias);
+				return _mm_or_si128(_mm_cmpgt_epi16(min, words), _mm_cmpgt_epi16(words, max));
+			};
+
+			const __m128i rejected = _mm_packs_epi16(outside(words_low), outside(words_high));
+			return ~static_cast<Uint32>(_mm_movemask_epi8(rejected)) & 0xFFFFU;
+		}
+#else
+		Uint32 PrefilterBlock(const Uint8* first, Uint16 high_min, Uint16 high_max)
+		{
+			Uint32 mask = 0;
+			for (Uint32 lane = 0; lane < PointerIndex::s_block_size; ++lane)
+			{
+				const Uint16 high = ReadBE16(first + lane);
+				mask |= static_cast<Uint32>(high >= high_min && high <= high_max) << lane;
+			}
+			return mask;
+		}
+#endif
+	}
+
+	void PointerIndex::SetTargets(const std::vector<DirtyRange>& targets, PointerAlignment alignment)
+	{
+		DirtyRangeSet merged;
+		for (const DirtyRange& target : targets)
+		{
+			merged.Add(target.begin, target.end);
+		}
+		m_targets = merged.GetRanges();
+		m_alignment = alignment;
+		Clear();
+	}
+
+	void PointerIndex::Clear()
+	{
+		m_built = false;
+		m_stale.Clear();
+		m_by_source.clear();
+		m_by_target.clear();
+	}
+
+	void PointerIndex::Scan(ByteSpan image, Uint32 begin, Uint32 end, const std::vector<DirtyRange>& targets, PointerAlignment alignment, std::vector<PointerReference>& references)
+	{
+		const std::size_t image_size = image.size();
+		if (targets.empty() || image_size < kPointerBytes)
+		{
+			return;
+		}
+		const std::size_t scan_end = std::min<std::size_t>(end, image_size - kPointerBytes + 1U);
+		const std::size_t step = alignment == PointerAlignment::Even ? 2U : 1U;
+		std::size_t offset = alignment == PointerAlignment::Even ? begin + (begin & 1U) : begin;
+
+		// Every target shares its high word with something between the lowest and highest one.
+		const Uint16 high_min = static_cast<Uint16>(targets.front().begin >> 16);
+		const Uint16 high_max = static_cast<Uint16>((targets.back().end - 1U) >> 16);
+		const Uint32 lanes = alignment == PointerAlignment::Even ? kEvenLanes : 0xFFFFU;
+		const Uint8* const bytes = image.data();
+
+		for (; offset + s_block_size <= scan_end && offset + kBlockReadBytes <= image_size; offset += s_block_size)
+		{
+			Uint32 passed = PrefilterBlock(bytes + offset, high_min, high_max) & lanes;
+			for (std::size_t lane = 0; passed != 0; ++lane, passed >>= 1)
+			{
+				if ((passed & 1U) == 0)
+				{
+					continue;
+				}
+				const Uint32 value = ReadBE32(bytes + offset + lane);
+				if (IsTarget(targets, value))
+				{
+					references.emplace_back(PointerReference{ static_cast<Uint32>(offset + lane), value });
+				}
+			}
+		}
+
+		for (; offset < scan_end; offset += step)
+		{
+			const Uint32 value = ReadBE32(bytes + offset);
+			if (IsTarget(targets, value))
+			{
+				references.emplace_back(PointerReference{ static_cast<Uint32>(offset), value });
+			}
+		}
+	}
+
+	void PointerIndex::Build(ByteSpan image)
+	{
+		Clear();
+		m_built = true;
+		if (image.empty())
+		{
+			return;
+		}
+
+		// Workers pull chunks from a shared counter; s_chunk_bytes is even, so every chunk
+		// starts on an even offset.
+		const std::size_t num_chunks = (image.size() + s_chunk_bytes - 1U) / s_chunk_bytes;
+		std::vector<std::vector<PointerReference>> chunk_references(num_chunks);
+		std::atomic<std::size_t> next_chunk{ 0 };
+		auto run_worker = [&]()
+		{
+			for (std::size_t chunk_index = next_chunk++; chunk_index < num_chunks; chunk_index = next_chunk++)
+			{
+				const std::size_t chunk_begin = chunk_index * s_chunk_bytes;
+				const std::size_t chunk_end = std::min<std::size_t>(chunk_begin + s_chunk_bytes, image.size());
+				Scan(image, static_cast<Uint32>(chunk_begin), static_cast<Uint32>(chunk_end), m_targets, m_alignment, chunk_references[chunk_index]);
+			}
+		};
+
+		// This thread is worker 0.
+		const std::size_t num_threads = std::min<std::size_t>(num_chunks, std::max(1u, std::thread::hardware_concurrency()));
+		std::vector<std::thread> workers;
+		workers.reserve(num_threads - 1U);
+		for (std::size_t worker = 1; worker < num_threads; ++worker)
+		{
+			workers.emplace_back(run_worker);
+		}
+		run_worker();
+		for (std::thread& worker : workers)
+		{
+			worker.join();
+		}
+
+		// Chunks come back in source order already.
+		for (const std::vector<PointerReference>& references : chunk_references)
+		{
+			m_by_source.insert(m_by_source.end(), references.begin(), references.end());
+		}
+		m_by_target = m_by_source;
+		std::sort(m_by_target.begin(), m_by_target.end(), ByTarget);
+	}
+
+	void PointerIndex::NotifyWrite(Uint32 begin, Uint32 end)
+	{
+		if (!m_built || begin >= end)
+		{
+			return;
+		}
+		// Longwords starting up to three bytes early overlap the write.
+		m_stale.Add(begin >= kPointerBytes - 1U ? begin - static_cast<Uint32>(kPointerBytes - 1U) : 0U, end);
+	}
+
+	void PointerIndex::Refresh(ByteSpan image)
+	{
+		if (!m_built)
+		{
+			Build(image);
+			return;
+		}
+		if (m_stale.Empty())
+		{
+			return;
+		}
+
+		const std::vector<DirtyRange> stale_ranges = m_stale.GetRanges();
+		std::vector<PointerReference> references;
+		for (const DirtyRange& range : stale_ranges)
+		{
+			Scan(image, range.begin, range.end, m_targets, m_alignment, references);
+		}
+
+		// Walk the source list alongside the stale ranges, then take exactly what that removed
+		// out of the target list, so neither needs a lookup per reference.
+		std::vector<PointerReference> removed;
+		std::size_t kept = 0;
+		auto stale = stale_ranges.begin();
+		for (std::size_t i = 0; i < m_by_source.size(); ++i)
+		{
+			const PointerReference reference = m_by_source[i];
+			while (stale != stale_ranges.end() && stale->end <= reference.source)
+			{
+				++stale;
+			}
+			if (stale != stale_ranges.end() && stale->begin <= reference.source)
+			{
+				removed.emplace_back(reference);
+			}
+			else
+			{
+				m_by_source[kept++] = reference;
+			}
+		}
+		m_by_source.resize(kept);
+
+		// The stale ranges are disjoint and in order, so the new references already are too.
+		m_by_source.insert(m_by_source.end(), references.begin(), references.end());
+		std::inplace_merge(m_by_source.begin(), m_by_source.begin() + kept, m_by_source.end(), BySource);
+
+		std::sort(removed.begin(), removed.end(), ByTarget);
+		std::vector<PointerReference> still_valid;
+		still_valid.reserve(kept);
+		std::set_difference(m_by_target.begin(), m_by_target.end(), removed.begin(), removed.end(), std::back_inserter(still_valid), ByTarget);
+		std::sort(references.begin(), references.end(), ByTarget);
+		m_by_target.clear();
+		m_by_target.reserve(still_valid.size() + references.size());
+		std::merge(still_valid.begin(), still_valid.end(), references.begin(), references.end(), std::back_inserter(m_by_target), ByTarget);
+		m_stale.Clear();
+	}
+
+	std::vector<Uint32> PointerIndex::FindReferencesTo(Uint32 target) const
+	{
+		std::vector<Uint32> sources;
+		auto it = std::lower_bound(m_by_target.begin(), m_by_target.end(), PointerReference{ 0U, target }, ByTarget);
+		for (; it != m_by_target.end() && it->target == target; ++it)
+		{
+			sources.emplace_back(it->source);
+		}
+		return sources;
+	}
+
+	std::vector<PointerReference> PointerIndex::FindReferencesInto(Uint32 begin, Uint32 end) const
+	{
+		auto first = std::lower_bound(m_by_target.begin(), m_by_target.end(), PointerReference{ 0U, begin }, ByTarget);
+		auto last = std::lower_bound(first, m_by_target.end(), PointerReference{ 0U, end }, ByTarget);
+		return std::vector<PointerReference>(first, last);
+	}
+}
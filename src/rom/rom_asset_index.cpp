@@ -0,0 +1,199 @@
+#include "rom/rom_asset_index.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace spintool::rom
+{
+	const char* GetAssetTypeName(ROMAssetType type)
+	{
+		switch (type)
+		{
+		case ROMAssetType::Sprite:
+			return "Sprite";
+		case ROMAssetType::Tileset:
+			return "Tileset";
+		case ROMAssetType::AnimationSequence:
+			return "Animation";
+		case ROMAssetType::CollisionSpline:
+			return "Collision spline";
+		case ROMAssetType::TileLayout:
+			return "Tile layout";
+		case ROMAssetType::Palette:
+			return "Palette";
+		}
+		return "Unknown";
+	}
+
+	void ROMAssetIndex::Register(ROMAssetType type, const ROMData& rom_data)
+	{
+		if (rom_data.rom_offset_end <= rom_data.rom_offset)
+		{
+			return;
+		}
+
+		std::lock_guard lock{ m_mutex };
+		if (!m_enabled)
+		{
+			return;
+		}
+
+		// The same asset decoded again replaces its previous extent.
+		auto it = m_entries.lower_bound(ROMAssetRef{ ROMAssetType{}, ROMData{ rom_data.rom_offset, 0, 0 } });
+		while (it != m_entries.end() && it->rom_data.rom_offset == rom_data.rom_offset)
+		{
+			if (it->type == type && it->rom_data.rom_offset_end != rom_data.rom_offset_end)
+			{
+				it = m_entries.erase(it);
+				m_tree_dirty = true;
+			}
+			else
+			{
+				++it;
+			}
+		}
+
+		ROMAssetRef entry{ type, {} };
+		entry.rom_data.SetROMData(rom_data.rom_offset, rom_data.rom_offset_end);
+		m_tree_dirty |= m_entries.insert(entry).second;
+	}
+
+	void ROMAssetIndex::Unregister(ROMAssetType type, const ROMData& rom_data)
+	{
+		std::lock_guard lock{ m_mutex };
+		ROMAssetRef entry{ type, {} };
+		entry.rom_data.SetROMData(rom_data.rom_offset, rom_data.rom_offset_end);
+		m_tree_dirty |= m_entries.erase(entry) != 0;
+	}
+
+	std::vector<ROMAssetRef> ROMAssetIndex::Invalidate(Uint32 begin, Uint32 end)
+	{
+		std::lock_guard lock{ m_mutex };
+		std::vector<ROMAssetRef> removed = FindOverlappingLocked(begin, end);
+		for (const ROMAssetRef& entry : removed)
+		{
+			m_entries.erase(entry);
+		}
+		m_tree_dirty |= !removed.empty();
+		return removed;
+	}
+
+	void ROMAssetIndex::Relocate(const ROMData& from, const ROMData& to)
+	{
+		std::lock_guard lock{ m_mutex };
+		std::vector<ROMAssetRef> moved = FindOverlappingLocked(from.rom_offset, from.rom_offset_end);
+		for (ROMAssetRef& entry : moved)
+		{
+			if (entry.rom_data.rom_offset < from.rom_offset || entry.rom_data.rom_offset_end > from.rom_offset_end)
+			{
+				continue;
+			}
+
+			m_entries.erase(entry);
+			const bool whole_asset = entry.rom_data.rom_offset == from.rom_offset && entry.rom_data.rom_offset_end == from.rom_offset_end;
+			const Uint32 new_offset = to.rom_offset + (entry.rom_data.rom_offset - from.rom_offset);
+			entry.rom_data.SetROMData(new_offset, whole_asset ? to.rom_offset_end : new_offset + entry.rom_data.real_size);
+			m_entries.insert(entry);
+			m_tree_dirty = true;
+		}
+	}
+
+	void ROMAssetIndex::Clear()
+	{
+		std::lock_guard lock{ m_mutex };
+		m_entries.clear();
+		m_tree.clear();
+		m_subtree_max_end.clear();
+		m_tree_dirty = false;
+	}
+
+	void ROMAssetIndex::SetEnabled(bool enabled)
+	{
+		std::lock_guard lock{ m_mutex };
+		m_enabled = enabled;
+	}
+
+	std::vector<ROMAssetRef> ROMAssetIndex::FindAt(Uint32 offset) const
+	{
+		return FindOverlapping(offset, offset + 1);
+	}
+
+	std::vector<ROMAssetRef> ROMAssetIndex::FindOverlapping(Uint32 begin, Uint32 end) const
+	{
+		std::lock_guard lock{ m_mutex };
+		return FindOverlappingLocked(begin, end);
+	}
+
+	std::vector<ROMAssetRef> ROMAssetIndex::FindOverlappingLocked(Uint32 begin, Uint32 end) const
+	{
+		std::vector<ROMAssetRef> results;
+		if (begin >= end)
+		{
+			return results;
+		}
+
+		if (m_tree_dirty)
+		{
+			RebuildTree();
+		}
+		QuerySubtree(0, m_tree.size(), begin, end, results);
+		return results;
+	}
+
+	std::size_t ROMAssetIndex::Size() const
+	{
+		std::lock_guard lock{ m_mutex };
+		return m_entries.size();
+	}
+
+	void ROMAssetIndex::RebuildTree() const
+	{
+		m_tree.assign(std::begin(m_entries), std::end(m_entries));
+		m_subtree_max_end.assign(m_tree.size(), 0);
+		BuildSubtree(0, m_tree.size());
+		m_tree_dirty = false;
+	}
+
+	Uint32 ROMAssetIndex::BuildSubtree(std::size_t begin, std::size_t end) const
+	{
+		if (begin >= end)
+		{
+			return 0;
+		}
+
+		const std::size_t node = begin + (end - begin) / 2;
+		const Uint32 left_max = BuildSubtree(begin, node);
+		const Uint32 right_max = BuildSubtree(node + 1, end);
+		m_subtree_max_end[node] = std::max({ m_tree[node].rom_data.rom_offset_end, left_max, right_max });
+		return m_subtree_max_end[node];
+	}
+
+	void ROMAssetIndex::QuerySubtree(std::size_t begin, std::size_t end, Uint32 query_begin, Uint32 query_end, std::vector<ROMAssetRef>& results) const
+	{
+		if (begin >= end)
+		{
+			return;
+		}
+
+		const std::size_t node = begin + (end - begin) / 2;
+		if (m_subtree_max_end[node] <= query_begin)
+		{
+			// Nothing under this node reaches the query.
+			return;
+		}
+
+		QuerySubtree(begin, node, query_begin, query_end, results);
+
+		// Entries to the right start no earlier than this one.
+		const ROMAssetRef& entry = m_tree[node];
+		if (entry.rom_data.rom_offset >= query_end)
+		{
+			return;
+		}
+		if (entry.rom_data.rom_offset_end > query_begin)
+		{
+			results.emplace_back(entry);
+		}
+		QuerySubtree(node + 1, end, query_begin, query_end, results);
+	}
+}
@@ -0,0 +1,286 @@
+#include "rom/rom_buffer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace spintool::rom
+{
+	ROMBuffer::~ROMBuffer()
+	{
+		Unmap();
+	}
+
+	ROMBuffer::ROMBuffer(ROMBuffer&& other) noexcept
+	{
+		*this = std::move(other);
+	}
+
+	ROMBuffer& ROMBuffer::operator=(ROMBuffer&& other) noexcept
+	{
+		if (this == &other)
+		{
+			return *this;
+		}
+
+		Unmap();
+		const bool other_owned = other.m_mapping == nullptr;
+		m_owned = std::move(other.m_owned);
+		m_size = other.m_size;
+		m_view = other_owned ? m_owned.data() : other.m_view;
+		m_mapping = other.m_mapping;
+		m_mapping_handle = other.m_mapping_handle;
+		m_overlay_pages = std::move(other.m_overlay_pages);
+		m_overlay_page_count = other.m_overlay_page_count;
+
+		other.m_view = nullptr;
+		other.m_size = 0;
+		other.m_mapping = nullptr;
+		other.m_mapping_handle = nullptr;
+		other.m_overlay_pages.clear();
+		other.m_overlay_page_count = 0;
+		return *this;
+	}
+
+	std::size_t ROMBuffer::GetPageSize()
+	{
+#if defined(_WIN32)
+		static const std::size_t s_page_size = []()
+			{
+				SYSTEM_INFO info{};
+				GetSystemInfo(&info);
+				return static_cast<std::size_t>(info.dwPageSize);
+			}();
+#else
+		static const std::size_t s_page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+#endif
+		return s_page_size;
+	}
+
+	bool ROMBuffer::MapFile(const std::filesystem::path& path)
+	{
+		Clear();
+
+#if defined(_WIN32)
+		HANDLE file = CreateFileW(path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file != INVALID_HANDLE_VALUE)
+		{
+			LARGE_INTEGER file_size{};
+			if (GetFileSizeEx(file, &file_size) && file_size.QuadPart > 0)
+			{
+				HANDLE mapping_handle = CreateFileMappingW(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+				if (mapping_handle != nullptr)
+				{
+					void* view = MapViewOfFile(mapping_handle, FILE_MAP_COPY, 0, 0, 0);
+					if (view != nullptr)
+					{
+						// Start every page read-only so stray writes fault instead of silently
+						// diverging, and so promotion is explicit like on POSIX.
+						DWORD old_protect = 0;
+						VirtualProtect(view, static_cast<SIZE_T>(file_size.QuadPart), PAGE_READONLY, &old_protect);
+						m_mapping = view;
+						m_mapping_handle = mapping_handle;
+						m_size = static_cast<std::size_t>(file_size.QuadPart);
+					}
+					else
+					{
+						CloseHandle(mapping_handle);
+					}
+				}
+			}
+			CloseHandle(file);
+		}
+#else
+		const int fd = open(path.c_str(), O_RDONLY);
+		if (fd >= 0)
+		{
+			struct stat file_stat {};
+			if (fstat(fd, &file_stat) == 0 && file_stat.st_size > 0)
+			{
+				void* view = mmap(nullptr, static_cast<std::size_t>(file_stat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+				if (view != MAP_FAILED)
+				{
+					m_mapping = view;
+					m_size = static_cast<std::size_t>(file_stat.st_size);
+				}
+			}
+			close(fd);
+		}
+#endif
+
+		if (m_mapping != nullptr)
+		{
+			m_view = static_cast<const Uint8*>(m_mapping);
+			m_overlay_pages.assign((m_size + GetPageSize() - 1) / GetPageSize(), false);
+			m_overlay_page_count = 0;
+			return true;
+		}
+
+		// Mapping is unavailable (or the file is empty); read the whole image in one go.
+		std::ifstream input{ path, std::ios::binary | std::ios::ate };
+		if (!input)
+		{
+			return false;
+		}
+		const std::streamoff file_size = input.tellg();
+		if (file_size <= 0)
+		{
+			return false;
+		}
+		m_owned.resize(static_cast<std::size_t>(file_size));
+		input.seekg(0);
+		input.read(reinterpret_cast<char*>(m_owned.data()), file_size);
+		m_owned.resize(static_cast<std::size_t>(input.gcount()));
+		m_view = m_owned.data();
+		m_size = m_owned.size();
+		return m_size != 0;
+	}
+
+	void ROMBuffer::Assign(ByteSpan bytes)
+	{
+		std::vector<Uint8> copy{ bytes.begin(), bytes.end() };
+		Unmap();
+		m_owned = std::move(copy);
+		m_view = m_owned.data();
+		m_size = m_owned.size();
+	}
+
+	void ROMBuffer::Resize(std::size_t new_size, Uint8 fill_value)
+	{
+		if (new_size == m_size)
+		{
+			return;
+		}
+
+		DetachFromFile();
+		m_owned.resize(new_size, fill_value);
+		m_view = m_owned.data();
+		m_size = m_owned.size();
+	}
+
+	void ROMBuffer::Clear()
+	{
+		Unmap();
+		m_owned.clear();
+		m_owned.shrink_to_fit();
+		m_view = nullptr;
+		m_size = 0;
+	}
+
+	void ROMBuffer::DetachFromFile()
+	{
+		if (m_mapping == nullptr)
+		{
+			return;
+		}
+		Assign(ByteSpan{ m_view, m_size });
+	}
+
+	Uint8* ROMBuffer::GetWritableRange(std::size_t offset, std::size_t count)
+	{
+		if (offset > m_size || count > m_size - offset)
+		{
+			return nullptr;
+		}
+
+		if (m_mapping == nullptr)
+		{
+			return m_owned.data() + offset;
+		}
+
+		if (count != 0)
+		{
+			const std::size_t page_size = GetPageSize();
+			if (!PromotePages(offset / page_size, (offset + count - 1) / page_size))
+			{
+				// The OS refused to make the pages writable; keep going with an owned copy.
+				DetachFromFile();
+				return m_owned.data() + offset;
+			}
+		}
+		return static_cast<Uint8*>(m_mapping) + offset;
+	}
+
+	bool ROMBuffer::PromotePages(std::size_t first_page, std::size_t last_page)
+	{
+		const std::size_t page_size = GetPageSize();
+		std::size_t page = first_page;
+		while (page <= last_page)
+		{
+			if (m_overlay_pages[page])
+			{
+				++page;
+				continue;
+			}
+
+			// Promote each contiguous run of read-only pages with a single protection change.
+			std::size_t run_end = page;
+			while (run_end + 1 <= last_page && !m_overlay_pages[run_end + 1])
+			{
+				++run_end;
+			}
+
+			Uint8* run_start = static_cast<Uint8*>(m_mapping) + page * page_size;
+			const std::size_t run_bytes = std::min((run_end + 1) * page_size, m_size) - page * page_size;
+#if defined(_WIN32)
+			DWORD old_protect = 0;
+			if (!VirtualProtect(run_start, run_bytes, PAGE_WRITECOPY, &old_protect))
+			{
+				return false;
+			}
+#else
+			if (mprotect(run_start, run_bytes, PROT_READ | PROT_WRITE) != 0)
+			{
+				return false;
+			}
+#endif
+			for (std::size_t p = page; p <= run_end; ++p)
+			{
+				m_overlay_pages[p] = true;
+			}
+			m_overlay_page_count += run_end + 1 - page;
+			page = run_end + 1;
+		}
+		return true;
+	}
+
+	void ROMBuffer::Unmap()
+	{
+		if (m_mapping == nullptr)
+		{
+			return;
+		}
+
+#if defined(_WIN32)
+		UnmapViewOfFile(m_mapping);
+		CloseHandle(static_cast<HANDLE>(m_mapping_handle));
+#else
+		munmap(m_mapping, m_size);
+#endif
+		m_mapping = nullptr;
+		m_mapping_handle = nullptr;
+		m_overlay_pages.clear();
+		m_overlay_page_count = 0;
+		m_view = nullptr;
+		m_size = 0;
+	}
+
+	bool operator==(const ROMBuffer& lhs, const std::vector<Uint8>& rhs)
+	{
+		return lhs.size() == rhs.size() && (lhs.empty() || std::memcmp(lhs.data(), rhs.data(), lhs.size()) == 0);
+	}
+
+	bool operator!=(const ROMBuffer& lhs, const std::vector<Uint8>& rhs)
+	{
+		return !(lhs == rhs);
+	}
+}
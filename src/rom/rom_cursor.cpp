@@ -0,0 +1,59 @@
+#include "rom/rom_cursor.h"
+
+#include "rom/spinball_rom.h"
+
+namespace spintool::rom
+{
+	ROMSpan::ROMSpan(ByteSpan image, Uint32 offset, Uint32 size)
+		: m_offset(offset)
+	{
+		if (offset <= image.size() && size <= image.size() - offset)
+		{
+			m_bytes = image.subspan(offset, size);
+			m_valid = true;
+		}
+	}
+
+	ROMCursor::ROMCursor(const ROMSpan& span)
+		: m_span(span)
+		, m_failed(!span.IsValid())
+	{
+	}
+
+	ROMWriter::ROMWriter(Uint32 offset)
+		: m_offset(offset)
+	{
+	}
+
+	void ROMWriter::WriteUint8(Uint8 value)
+	{
+		m_bytes.emplace_back(value);
+	}
+
+	void ROMWriter::WriteUint16(Uint16 value)
+	{
+		m_bytes.emplace_back(static_cast<Uint8>(value >> 8));
+		m_bytes.emplace_back(static_cast<Uint8>(value & 0xFF));
+	}
+
+	void ROMWriter::WriteUint32(Uint32 value)
+	{
+		m_bytes.emplace_back(static_cast<Uint8>(value >> 24));
+		m_bytes.emplace_back(static_cast<Uint8>((value >> 16) & 0xFF));
+		m_bytes.emplace_back(static_cast<Uint8>((value >> 8) & 0xFF));
+		m_bytes.emplace_back(static_cast<Uint8>(value & 0xFF));
+	}
+
+	void ROMWriter::WriteBytes(ByteSpan bytes)
+	{
+		m_bytes.insert(m_bytes.end(), bytes.begin(), bytes.end());
+	}
+
+	Uint32 ROMWriter::Commit(SpinballROM& rom)
+	{
+		const Uint32 end = rom.WriteBytes(m_offset, m_bytes);
+		m_offset = end;
+		m_bytes.clear();
+		return end;
+	}
+}
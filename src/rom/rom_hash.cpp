@@ -0,0 +1,213 @@
+#include "rom/rom_hash.h"
+
+#include "SDL3/SDL_endian.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace spintool::rom
+{
+	namespace
+	{
+		constexpr std::size_t kChunkSize = 256 * 1024;
+
+		constexpr Uint64 kPrime1 = 0x9E3779B185EBCA87ULL;
+		constexpr Uint64 kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+		constexpr Uint64 kPrime3 = 0x165667B19E3779F9ULL;
+		constexpr Uint64 kPrime4 = 0x85EBCA77C2B2AE63ULL;
+		constexpr Uint64 kPrime5 = 0x27D4EB2F165667C5ULL;
+
+		constexpr Uint64 RotateLeft(Uint64 value, int bits)
+		{
+			return (value << bits) | (value >> (64 - bits));
+		}
+
+		// The reference XXH64 reads little-endian words whatever the host is.
+		Uint64 ReadLE64(const Uint8* bytes)
+		{
+			Uint64 value = 0;
+			std::memcpy(&value, bytes, sizeof(value));
+			return SDL_Swap64LE(value);
+		}
+
+		Uint32 ReadLE32(const Uint8* bytes)
+		{
+			Uint32 value = 0;
+			std::memcpy(&value, bytes, sizeof(value));
+			return SDL_Swap32LE(value);
+		}
+
+		Uint64 Round(Uint64 accumulator, Uint64 input)
+		{
+			accumulator += input * kPrime2;
+			accumulator = RotateLeft(accumulator, 31);
+			return accumulator * kPrime1;
+		}
+
+		Uint64 MergeRound(Uint64 accumulator, Uint64 value)
+		{
+			accumulator ^= Round(0, value);
+			return accumulator * kPrime1 + kPrime4;
+		}
+
+		Uint64 XXH64(const Uint8* data, std::size_t size, Uint64 seed)
+		{
+			const Uint8* current = data;
+			const Uint8* const end = data + size;
+			Uint64 hash = 0;
+
+			if (size >= 32)
+			{
+				Uint64 v1 = seed + kPrime1 + kPrime2;
+				Uint64 v2 = seed + kPrime2;
+				Uint64 v3 = seed;
+				Uint64 v4 = seed - kPrime1;
+				const Uint8* const limit = end - 32;
+				do
+				{
+					v1 = Round(v1, ReadLE64(current));
+					v2 = Round(v2, ReadLE64(current + 8));
+					v3 = Round(v3, ReadLE64(current + 16));
+					v4 = Round(v4, ReadLE64(current + 24));
+					current += 32;
+				} while (current <= limit);
+
+				hash = RotateLeft(v1, 1) + RotateLeft(v2, 7) + RotateLeft(v3, 12) + RotateLeft(v4, 18);
+				hash = MergeRound(hash, v1);
+				hash = MergeRound(hash, v2);
+				hash = MergeRound(hash, v3);
+				hash = MergeRound(hash, v4);
+			}
+			else
+			{
+				hash = seed + kPrime5;
+			}
+
+			hash += static_cast<Uint64>(size);
+
+			while (current + 8 <= end)
+			{
+				hash ^= Round(0, ReadLE64(current));
+				hash = RotateLeft(hash, 27) * kPrime1 + kPrime4;
+				current += 8;
+			}
+			if (current + 4 <= end)
+			{
+				hash ^= static_cast<Uint64>(ReadLE32(current)) * kPrime1;
+				hash = RotateLeft(hash, 23) * kPrime2 + kPrime3;
+				current += 4;
+			}
+			while (current < end)
+			{
+				hash ^= static_cast<Uint64>(*current) * kPrime5;
+				hash = RotateLeft(hash, 11) * kPrime1;
+				++current;
+			}
+
+			hash ^= hash >> 33;
+			hash *= kPrime2;
+			hash ^= hash >> 29;
+			hash *= kPrime3;
+			hash ^= hash >> 32;
+			return hash;
+		}
+	}
+
+	std::string ROMHash::ToString() const
+	{
+		char text[17];
+		std::snprintf(text, sizeof(text), "%016llx", static_cast<unsigned long long>(value));
+		return text;
+	}
+
+	std::optional<ROMHash> ROMHash::FromString(std::string_view text)
+	{
+		if (text.size() != 16)
+		{
+			return std::nullopt;
+		}
+
+		ROMHash hash;
+		for (const char c : text)
+		{
+			Uint64 digit = 0;
+			if (c >= '0' && c <= '9')
+			{
+				digit = static_cast<Uint64>(c - '0');
+			}
+			else if (c >= 'a' && c <= 'f')
+			{
+				digit = static_cast<Uint64>(c - 'a' + 10);
+			}
+			else if (c >= 'A' && c <= 'F')
+			{
+				digit = static_cast<Uint64>(c - 'A' + 10);
+			}
+			else
+			{
+				return std::nullopt;
+			}
+			hash.value = (hash.value << 4) | digit;
+		}
+		return hash;
+	}
+
+	Uint64 HashBytes(ByteSpan bytes, Uint64 seed)
+	{
+		return XXH64(bytes.data(), bytes.size(), seed);
+	}
+
+	ROMHash ComputeROMHash(ByteSpan image)
+	{
+		const std::size_t num_chunks = std::max<std::size_t>(1, (image.size() + kChunkSize - 1) / kChunkSize);
+		std::vector<Uint8> chunk_digests(num_chunks * sizeof(Uint64));
+
+		auto hash_chunk = [&image, &chunk_digests](std::size_t chunk_index)
+			{
+				const ByteSpan chunk = image.subspan(chunk_index * kChunkSize, kChunkSize);
+				const Uint64 digest = XXH64(chunk.data(), chunk.size(), 0);
+				for (std::size_t i = 0; i < sizeof(Uint64); ++i)
+				{
+					chunk_digests[chunk_index * sizeof(Uint64) + i] = static_cast<Uint8>(digest >> (i * 8));
+				}
+			};
+
+		const std::size_t num_threads = std::min<std::size_t>(num_chunks, std::max(1u, std::thread::hardware_concurrency()));
+		if (num_threads <= 1)
+		{
+			for (std::size_t i = 0; i < num_chunks; ++i)
+			{
+				hash_chunk(i);
+			}
+		}
+		else
+		{
+			// Each worker takes every num_threads-th chunk; the calling thread is worker 0.
+			std::vector<std::thread> workers;
+			workers.reserve(num_threads - 1);
+			for (std::size_t worker = 1; worker < num_threads; ++worker)
+			{
+				workers.emplace_back([&hash_chunk, worker, num_threads, num_chunks]()
+					{
+						for (std::size_t i = worker; i < num_chunks; i += num_threads)
+						{
+							hash_chunk(i);
+						}
+					});
+			}
+			for (std::size_t i = 0; i < num_chunks; i += num_threads)
+			{
+				hash_chunk(i);
+			}
+			for (std::thread& worker : workers)
+			{
+				worker.join();
+			}
+		}
+
+		return ROMHash{ XXH64(chunk_digests.data(), chunk_digests.size(), static_cast<Uint64>(image.size())) };
+	}
+}
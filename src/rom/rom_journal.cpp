@@ -0,0 +1,407 @@
+#include "rom/rom_journal.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace spintool::rom
+{
+	namespace
+	{
+		const std::string s_empty_name;
+		const std::string s_implicit_transaction_name = "Edit";
+
+		// PackBits-style run-length coding. A control byte below 0x80 is followed by
+		// control + 1 literal bytes; otherwise the next byte repeats control - 0x7D times.
+		constexpr size_t kMaxLiteralRun = 0x80;
+		constexpr size_t kMinRepeatRun = 3;
+		constexpr size_t kMaxRepeatRun = 0xFF - 0x7D;
+
+		std::vector<Uint8> PackRuns(const std::vector<Uint8>& bytes)
+		{
+			std::vector<Uint8> packed;
+			packed.reserve(bytes.size() / 2 + 2);
+
+			size_t i = 0;
+			size_t literal_start = 0;
+			auto flush_literals = [&](size_t end)
+				{
+					while (literal_start < end)
+					{
+						const size_t count = std::min(end - literal_start, kMaxLiteralRun);
+						packed.emplace_back(static_cast<Uint8>(count - 1));
+						packed.insert(packed.end(), bytes.begin() + literal_start, bytes.begin() + literal_start + count);
+						literal_start += count;
+					}
+				};
+
+			while (i < bytes.size())
+			{
+				size_t run = 1;
+				while (i + run < bytes.size() && run < kMaxRepeatRun && bytes[i + run] == bytes[i])
+				{
+					++run;
+				}
+
+				if (run >= kMinRepeatRun)
+				{
+					flush_literals(i);
+					packed.emplace_back(static_cast<Uint8>(run + 0x7D));
+					packed.emplace_back(bytes[i]);
+					i += run;
+					literal_start = i;
+				}
+				else
+				{
+					i += run;
+				}
+			}
+			flush_literals(bytes.size());
+			packed.shrink_to_fit();
+			return packed;
+		}
+
+		std::vector<Uint8> UnpackRuns(const std::vector<Uint8>& packed, size_t unpacked_size)
+		{
+			std::vector<Uint8> bytes;
+			bytes.reserve(unpacked_size);
+
+			size_t i = 0;
+			while (i < packed.size())
+			{
+				const Uint8 control = packed[i++];
+				if (control < 0x80)
+				{
+					const size_t count = std::min<size_t>(control + 1, packed.size() - i);
+					bytes.insert(bytes.end(), packed.begin() + i, packed.begin() + i + count);
+					i += count;
+				}
+				else if (i < packed.size())
+				{
+					bytes.insert(bytes.end(), static_cast<size_t>(control - 0x7D), packed[i++]);
+				}
+			}
+			return bytes;
+		}
+	}
+
+	std::vector<Uint8> JournalDelta::GetOldBytes() const
+	{
+		return packed ? UnpackRuns(old_bytes, size) : old_bytes;
+	}
+
+	std::vector<Uint8> JournalDelta::GetNewBytes() const
+	{
+		return packed ? UnpackRuns(new_bytes, size) : new_bytes;
+	}
+
+	size_t JournalDelta::GetMemoryUsage() const
+	{
+		return sizeof(JournalDelta) + old_bytes.capacity() + new_bytes.capacity();
+	}
+
+	std::vector<DirtyRange> JournalTransaction::GetRanges() const
+	{
+		DirtyRangeSet ranges;
+		for (const JournalDelta& delta : deltas)
+		{
+			ranges.Add(delta.offset, delta.offset + delta.size);
+		}
+		return ranges.GetRanges();
+	}
+
+	size_t JournalTransaction::GetMemoryUsage() const
+	{
+		size_t usage = sizeof(JournalTransaction) + name.capacity();
+		for (const JournalDelta& delta : deltas)
+		{
+			usage += delta.GetMemoryUsage();
+		}
+		return usage;
+	}
+
+	void ROMJournal::BeginTransaction(std::string name)
+	{
+		if (m_transaction_depth++ == 0)
+		{
+			SealImplicitTransaction();
+			m_open_name = std::move(name);
+			m_explicit_open = false;
+		}
+	}
+
+	void ROMJournal::EndTransaction()
+	{
+		if (m_transaction_depth == 0)
+		{
+			return;
+		}
+
+		if (--m_transaction_depth == 0 && m_explicit_open)
+		{
+			m_explicit_open = false;
+			Seal(m_undo_stack.back());
+			TrimHistory();
+		}
+	}
+
+	void ROMJournal::SealImplicitTransaction()
+	{
+		if (m_implicit_open)
+		{
+			m_implicit_open = false;
+			Seal(m_undo_stack.back());
+			TrimHistory();
+		}
+	}
+
+	JournalTransaction& ROMJournal::OpenTransactionForWrite()
+	{
+		const auto now = std::chrono::steady_clock::now();
+
+		// Transactions are only created once they actually change something, so an
+		// empty transaction never shows up in the history or discards the redo stack.
+		if (m_transaction_depth > 0 && !m_explicit_open)
+		{
+			const bool continues_previous = !m_undo_stack.empty() &&
+				m_redo_stack.empty() &&
+				!m_undo_stack.back().implicit &&
+				m_undo_stack.back().name == m_open_name &&
+				now - m_undo_stack.back().last_write_time <= m_coalesce_window;
+			if (!continues_previous)
+			{
+				ClearRedo();
+				m_undo_stack.emplace_back().name = m_open_name;
+			}
+			m_open_delta_start = m_undo_stack.back().deltas.size();
+			m_explicit_open = true;
+		}
+		else if (m_transaction_depth == 0 && !m_implicit_open)
+		{
+			ClearRedo();
+			JournalTransaction& transaction = m_undo_stack.emplace_back();
+			transaction.name = s_implicit_transaction_name;
+			transaction.implicit = true;
+			m_open_delta_start = 0;
+			m_implicit_open = true;
+		}
+
+		JournalTransaction& transaction = m_undo_stack.back();
+		transaction.last_write_time = now;
+		return transaction;
+	}
+
+	void ROMJournal::Record(Uint32 offset, ByteSpan old_bytes, ByteSpan new_bytes)
+	{
+		JournalTransaction& transaction = OpenTransactionForWrite();
+
+		const Uint32 end = offset + static_cast<Uint32>(new_bytes.size());
+		// Never merge into a delta of the step this transaction continues, or discarding the
+		// open writes would take part of that step with them.
+		if (transaction.deltas.size() > m_open_delta_start && !transaction.deltas.back().packed && !transaction.deltas.back().IsResize())
+		{
+			JournalDelta& last = transaction.deltas.back();
+			const Uint32 last_end = last.offset + last.size;
+			if (offset <= last_end && end >= last.offset)
+			{
+				// Sequential writes (e.g. one byte at a time) collapse into a single delta.
+				// The existing delta's old bytes predate this write, so they win; the
+				// incoming new bytes are the latest, so they win.
+				const Uint32 merged_begin = std::min(offset, last.offset);
+				const Uint32 merged_end = std::max(end, last_end);
+				std::vector<Uint8> merged_old(merged_end - merged_begin);
+				std::vector<Uint8> merged_new(merged_end - merged_begin);
+
+				std::copy(old_bytes.begin(), old_bytes.end(), merged_old.begin() + (offset - merged_begin));
+				std::copy(last.old_bytes.begin(), last.old_bytes.end(), merged_old.begin() + (last.offset - merged_begin));
+				std::copy(last.new_bytes.begin(), last.new_bytes.end(), merged_new.begin() + (last.offset - merged_begin));
+				std::copy(new_bytes.begin(), new_bytes.end(), merged_new.begin() + (offset - merged_begin));
+
+				m_memory_usage += merged_old.size() + merged_new.size() - last.old_bytes.size() - last.new_bytes.size();
+				last.offset = merged_begin;
+				last.size = merged_end - merged_begin;
+				last.old_bytes = std::move(merged_old);
+				last.new_bytes = std::move(merged_new);
+				return;
+			}
+		}
+
+		JournalDelta& delta = transaction.deltas.emplace_back();
+		delta.offset = offset;
+		delta.size = static_cast<Uint32>(new_bytes.size());
+		delta.old_bytes.assign(old_bytes.begin(), old_bytes.end());
+		delta.new_bytes.assign(new_bytes.begin(), new_bytes.end());
+		m_memory_usage += delta.GetMemoryUsage();
+	}
+
+	void ROMJournal::RecordResize(Uint32 old_size, Uint32 new_size, ByteSpan removed_tail, ByteSpan added_tail)
+	{
+		if (old_size == new_size)
+		{
+			return;
+		}
+
+		JournalTransaction& transaction = OpenTransactionForWrite();
+		JournalDelta& delta = transaction.deltas.emplace_back();
+		delta.offset = std::min(old_size, new_size);
+		delta.size = std::max(old_size, new_size) - delta.offset;
+		delta.old_bytes.assign(removed_tail.begin(), removed_tail.end());
+		delta.new_bytes.assign(added_tail.begin(), added_tail.end());
+		delta.old_image_size = old_size;
+		delta.new_image_size = new_size;
+		m_memory_usage += delta.GetMemoryUsage();
+	}
+
+	std::vector<JournalDelta> ROMJournal::DiscardOpenWrites()
+	{
+		if (m_transaction_depth == 0 || !m_explicit_open)
+		{
+			return {};
+		}
+
+		JournalTransaction& transaction = m_undo_stack.back();
+		const auto first = transaction.deltas.begin() + static_cast<std::ptrdiff_t>(m_open_delta_start);
+		std::vector<JournalDelta> discarded{ std::make_move_iterator(first), std::make_move_iterator(transaction.deltas.end()) };
+		transaction.deltas.erase(first, transaction.deltas.end());
+		for (const JournalDelta& delta : discarded)
+		{
+			m_memory_usage -= std::min(m_memory_usage, delta.GetMemoryUsage());
+		}
+
+		if (transaction.deltas.empty())
+		{
+			m_undo_stack.pop_back();
+		}
+		m_explicit_open = false;
+		return discarded;
+	}
+
+	void ROMJournal::Clear()
+	{
+		m_undo_stack.clear();
+		m_redo_stack.clear();
+		m_transaction_depth = 0;
+		m_implicit_open = false;
+		m_explicit_open = false;
+		m_open_delta_start = 0;
+		m_memory_usage = 0;
+	}
+
+	bool ROMJournal::CanUndo() const
+	{
+		return PeekUndo() != nullptr;
+	}
+
+	bool ROMJournal::CanRedo() const
+	{
+		return PeekRedo() != nullptr;
+	}
+
+	const std::string& ROMJournal::GetUndoName() const
+	{
+		const JournalTransaction* transaction = PeekUndo();
+		return transaction ? transaction->name : s_empty_name;
+	}
+
+	const std::string& ROMJournal::GetRedoName() const
+	{
+		const JournalTransaction* transaction = PeekRedo();
+		return transaction ? transaction->name : s_empty_name;
+	}
+
+	const JournalTransaction* ROMJournal::PeekUndo() const
+	{
+		// History can't move while an explicit transaction is still collecting writes.
+		if (m_transaction_depth > 0 || m_undo_stack.empty())
+		{
+			return nullptr;
+		}
+		return &m_undo_stack.back();
+	}
+
+	const JournalTransaction* ROMJournal::PeekRedo() const
+	{
+		if (m_transaction_depth > 0 || m_redo_stack.empty())
+		{
+			return nullptr;
+		}
+		return &m_redo_stack.back();
+	}
+
+	void ROMJournal::CommitUndo()
+	{
+		SealImplicitTransaction();
+		if (PeekUndo() == nullptr)
+		{
+			return;
+		}
+		m_redo_stack.emplace_back(std::move(m_undo_stack.back()));
+		m_undo_stack.pop_back();
+	}
+
+	void ROMJournal::CommitRedo()
+	{
+		if (PeekRedo() == nullptr)
+		{
+			return;
+		}
+		m_undo_stack.emplace_back(std::move(m_redo_stack.back()));
+		m_redo_stack.pop_back();
+		// Never merge a later edit into a step that was just redone.
+		m_undo_stack.back().last_write_time = {};
+	}
+
+	void ROMJournal::Seal(JournalTransaction& transaction)
+	{
+		for (JournalDelta& delta : transaction.deltas)
+		{
+			if (delta.packed)
+			{
+				continue;
+			}
+
+			std::vector<Uint8> packed_old = PackRuns(delta.old_bytes);
+			std::vector<Uint8> packed_new = PackRuns(delta.new_bytes);
+			if (packed_old.size() + packed_new.size() < delta.old_bytes.size() + delta.new_bytes.size())
+			{
+				delta.old_bytes = std::move(packed_old);
+				delta.new_bytes = std::move(packed_new);
+				delta.packed = true;
+			}
+			else
+			{
+				delta.old_bytes.shrink_to_fit();
+				delta.new_bytes.shrink_to_fit();
+			}
+		}
+	}
+
+	void ROMJournal::TrimHistory()
+	{
+		m_memory_usage = 0;
+		for (const JournalTransaction& transaction : m_undo_stack)
+		{
+			m_memory_usage += transaction.GetMemoryUsage();
+		}
+		for (const JournalTransaction& transaction : m_redo_stack)
+		{
+			m_memory_usage += transaction.GetMemoryUsage();
+		}
+
+		// Always keep the most recent step, even if it alone exceeds the budget.
+		while (m_undo_stack.size() > 1 &&
+			(m_undo_stack.size() > m_max_transactions || m_memory_usage > m_max_memory_usage))
+		{
+			m_memory_usage -= m_undo_stack.front().GetMemoryUsage();
+			m_undo_stack.pop_front();
+		}
+	}
+
+	void ROMJournal::ClearRedo()
+	{
+		for (const JournalTransaction& transaction : m_redo_stack)
+		{
+			m_memory_usage -= std::min(m_memory_usage, transaction.GetMemoryUsage());
+		}
+		m_redo_stack.clear();
+	}
+}
@@ -0,0 +1,13 @@
+#include "rom/rom_snapshot.h"
+
+namespace spintool::rom
+{
+	ROMSnapshot::ROMSnapshot(const SpinballROM& source, Uint64 version)
+		: m_version(version)
+	{
+		m_rom.m_buffer.Assign(ByteSpan{ source.m_buffer.data(), source.m_buffer.size() });
+		m_rom.m_filepath = source.m_filepath;
+		// Jobs decode speculatively; only the live ROM tracks which assets exist.
+		m_rom.GetAssetIndex().SetEnabled(false);
+	}
+}
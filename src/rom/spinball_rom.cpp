@@ -3,29 +3,265 @@
 
 #include "rom/sprite.h"
 #include "rom/palette.h"
+#include "rom/rom_snapshot.h"
 #include "types/sdl_handle_defs.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <fstream>
+#include <iostream>
 #include "SDL3/SDL_stdinc.h"
 #include "SDL3/SDL_surface.h"
+#include "SDL3/SDL_endian.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#endif
+
+#if !defined(_WIN32)
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__)
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#elif defined(__APPLE__)
+#include <sys/clonefile.h>
+#endif
 
 
 namespace spintool
 {
+	namespace
+	{
+		// Writes each range of image into the file at the same offset. With truncate set the
+		// file is created/emptied first, which is how a full image is written.
+		bool WriteRangesToFile(const std::filesystem::path& path, const rom::ROMBuffer& image, const std::vector<rom::DirtyRange>& ranges, bool truncate)
+		{
+#if defined(_WIN32)
+			std::ios::openmode mode = std::ios::binary | std::ios::out;
+			mode |= truncate ? std::ios::trunc : std::ios::in;
+			std::fstream output{ path, mode };
+			for (const rom::DirtyRange& range : ranges)
+			{
+				output.seekp(range.begin);
+				output.write(reinterpret_cast<const char*>(image.data() + range.begin), range.Size());
+			}
+			output.flush();
+			return static_cast<bool>(output);
+#else
+			const int fd = open(path.c_str(), truncate ? (O_WRONLY | O_CREAT | O_TRUNC) : O_WRONLY, 0644);
+			if (fd < 0)
+			{
+				return false;
+			}
+
+			bool success = true;
+			for (const rom::DirtyRange& range : ranges)
+			{
+				size_t written = 0;
+				while (success && written < range.Size())
+				{
+					const ssize_t result = pwrite(fd, image.data() + range.begin + written, range.Size() - written, static_cast<off_t>(range.begin + written));
+					if (result < 0 && errno == EINTR)
+					{
+						continue;
+					}
+					success = result > 0;
+					written += success ? static_cast<size_t>(result) : 0;
+				}
+			}
+
+			// Make sure the data is on disk before the caller renames the file into place.
+			success = fsync(fd) == 0 && success;
+			success = close(fd) == 0 && success;
+			return success;
+#endif
+		}
+
+		// A rename is only durable once the directory entry pointing at the new file is.
+		bool SyncParentDirectory(const std::filesystem::path& path)
+		{
+#if defined(_WIN32)
+			(void)path;
+			return true;
+#else
+			std::filesystem::path directory = path.parent_path();
+			if (directory.empty())
+			{
+				directory = ".";
+			}
+			const int fd = open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+			if (fd < 0)
+			{
+				return false;
+			}
+			bool success = fsync(fd) == 0;
+			success = close(fd) == 0 && success;
+			return success;
+#endif
+		}
+
+		// Creates to as a reflink of from: the two share blocks until one is written, so an
+		// atomic save only writes the blocks it patches. False where the filesystem can't.
+		bool CloneFile(const std::filesystem::path& from, const std::filesystem::path& to)
+		{
+#if defined(__linux__) && defined(FICLONE)
+			const int source_fd = open(from.c_str(), O_RDONLY);
+			if (source_fd < 0)
+			{
+				return false;
+			}
+			const int target_fd = open(to.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+			bool success = target_fd >= 0 && ioctl(target_fd, FICLONE, source_fd) == 0;
+			success = (target_fd < 0 || close(target_fd) == 0) && success;
+			close(source_fd);
+			return success;
+#elif defined(__APPLE__)
+			std::error_code remove_error;
+			std::filesystem::remove(to, remove_error);
+			return clonefile(from.c_str(), to.c_str(), 0) == 0;
+#else
+			(void)from;
+			(void)to;
+			return false;
+#endif
+		}
+	}
+
 	bool rom::SpinballROM::LoadROMFromPath(const std::filesystem::path& path)
 	{
-		std::ifstream input = std::ifstream{ path, std::ios::binary };
 		m_filepath = path;
-		m_buffer = std::vector<unsigned char>{ std::istreambuf_iterator<char>(input), {} };
+		m_saved_filepath = path;
+		m_buffer.MapFile(path);
+		m_dirty_ranges.Clear();
+		m_changed_ranges.Clear();
+		m_requires_full_save = false;
+		m_checksum = ComputeChecksum(m_buffer);
+		m_journal.Clear();
+		m_asset_index.Clear();
+		m_pointer_index.SetTargets({ DirtyRange{ s_pointer_targets_start, s_cartridge_address_end } }, PointerAlignment::Even);
+		++m_version;
 		m_palettes = LoadPalettes(48);
 
 		return m_buffer.empty() == false;
 	}
 
-	void rom::SpinballROM::SaveROM()
+	bool rom::SpinballROM::SaveROM()
+	{
+		const auto start_time = std::chrono::steady_clock::now();
+		m_journal.SealImplicitTransaction();
+		ROMSaveStats stats;
+
+		std::error_code size_error;
+		const std::uintmax_t size_on_disk = std::filesystem::file_size(m_filepath, size_error);
+		stats.incremental = m_requires_full_save == false &&
+			m_filepath == m_saved_filepath &&
+			!size_error &&
+			size_on_disk == m_buffer.size();
+
+		const std::vector<DirtyRange> ranges = stats.incremental
+			? m_dirty_ranges.GetRanges()
+			: std::vector<DirtyRange>{ DirtyRange{ 0, static_cast<Uint32>(m_buffer.size()) } };
+
+		if (stats.incremental && ranges.empty())
+		{
+			stats.success = true;
+		}
+		else if (stats.incremental && m_save_strategy == ROMSaveStrategy::PatchInPlace)
+		{
+			// Dirty pages are already private to the mapping, so patching the file under it is safe.
+			stats.success = WriteRangesToFile(m_filepath, m_buffer, ranges, false);
+		}
+		else
+		{
+			// Never truncate a file that may be mapped. Build the new image in a sibling file,
+			// either from a copy of the current file plus the dirty ranges or from scratch,
+			// and swap it in once it is complete. A reflink saves copying the whole file.
+			std::filesystem::path temp_path = m_filepath;
+			temp_path += ".tmp";
+
+			std::error_code copy_error;
+			if (stats.incremental && !CloneFile(m_filepath, temp_path))
+			{
+				std::filesystem::copy_file(m_filepath, temp_path, std::filesystem::copy_options::overwrite_existing, copy_error);
+				stats.bytes_copied = static_cast<size_t>(size_on_disk);
+			}
+
+			stats.success = !copy_error && WriteRangesToFile(temp_path, m_buffer, ranges, stats.incremental == false);
+			if (stats.success)
+			{
+#if defined(_WIN32)
+				// Windows refuses to replace a file that still has a view mapped.
+				m_buffer.DetachFromFile();
+#endif
+				std::error_code rename_error;
+				std::filesystem::rename(temp_path, m_filepath, rename_error);
+				stats.success = !rename_error;
+				if (stats.success && !SyncParentDirectory(m_filepath))
+				{
+					// The new image is in place; only its durability across a crash is in doubt.
+					std::cerr << "Could not sync the directory of " << m_filepath << '\n';
+				}
+			}
+
+			if (!stats.success)
+			{
+				std::error_code remove_error;
+				std::filesystem::remove(temp_path, remove_error);
+			}
+		}
+
+		if (stats.success)
+		{
+			stats.bytes_written = stats.bytes_copied;
+			for (const DirtyRange& range : ranges)
+			{
+				stats.bytes_written += range.Size();
+			}
+			stats.ranges_written = ranges.size();
+			m_saved_filepath = m_filepath;
+			m_dirty_ranges.Clear();
+			m_requires_full_save = false;
+		}
+		else
+		{
+			std::cerr << "Failed to save ROM to " << m_filepath << '\n';
+		}
+
+		stats.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count();
+		m_last_save_stats = stats;
+		return stats.success;
+	}
+
+	void rom::SpinballROM::SetSaveStrategy(ROMSaveStrategy strategy)
+	{
+		m_save_strategy = strategy;
+	}
+
+	rom::ROMSaveStrategy rom::SpinballROM::GetSaveStrategy() const
+	{
+		return m_save_strategy;
+	}
+
+	const rom::DirtyRangeSet& rom::SpinballROM::GetDirtyRanges() const
 	{
-		std::ofstream output = std::ofstream{ m_filepath, std::ios::binary };
-		output.write(reinterpret_cast<const char*>(m_buffer.data()), m_buffer.size());
+		return m_dirty_ranges;
+	}
+
+	std::vector<rom::DirtyRange> rom::SpinballROM::TakeChangedRanges()
+	{
+		std::vector<DirtyRange> ranges = m_changed_ranges.GetRanges();
+		m_changed_ranges.Clear();
+		return ranges;
+	}
+
+	const rom::ROMSaveStats& rom::SpinballROM::GetLastSaveStats() const
+	{
+		return m_last_save_stats;
 	}
 
 	Uint32 rom::SpinballROM::GetOffsetForNextSprite(const rom::Sprite& current_sprite) const
@@ -257,16 +493,62 @@ namespace spintool
 		return 0;
 	}
 
+	rom::ROMSpan rom::SpinballROM::GetSpan(Uint32 offset, Uint32 size) const
+	{
+		return ROMSpan{ ByteSpan{ m_buffer.data(), m_buffer.size() }, offset, size };
+	}
+
+	rom::ROMCursor rom::SpinballROM::GetCursor(Uint32 offset, Uint32 size) const
+	{
+		return ROMCursor{ GetSpan(offset, size) };
+	}
+
+	rom::ROMCursor rom::SpinballROM::GetCursor(Uint32 offset) const
+	{
+		const Uint32 remaining = offset < m_buffer.size() ? static_cast<Uint32>(m_buffer.size()) - offset : 0;
+		return ROMCursor{ GetSpan(offset, remaining) };
+	}
+
 	const std::vector<std::shared_ptr<spintool::rom::Palette>>& rom::SpinballROM::GetGlobalPalettes() const
 	{
 		return m_palettes;
 	}
 
+	void rom::SpinballROM::ApplyWrite(Uint32 offset, ByteSpan bytes)
+	{
+		if (bytes.empty() || std::memcmp(m_buffer.data() + offset, bytes.data(), bytes.size()) == 0)
+		{
+			return;
+		}
+
+		if (Uint8* dest = m_buffer.GetWritableRange(offset, bytes.size()))
+		{
+			// Even addresses are the high byte of their checksum word, odd ones the low byte.
+			for (Uint32 address = std::max(offset, s_checksum_range_start); address < offset + bytes.size(); ++address)
+			{
+				const int delta = static_cast<int>(bytes[address - offset]) - static_cast<int>(dest[address - offset]);
+				m_checksum = static_cast<Uint16>(m_checksum + ((address & 1) != 0 ? delta : delta * 0x100));
+			}
+
+			if (!m_applying_history)
+			{
+				m_journal.Record(offset, ByteSpan{ dest, bytes.size() }, bytes);
+			}
+
+			std::memcpy(dest, bytes.data(), bytes.size());
+			m_dirty_ranges.Add(offset, offset + static_cast<Uint32>(bytes.size()));
+			m_changed_ranges.Add(offset, offset + static_cast<Uint32>(bytes.size()));
+			m_pointer_index.NotifyWrite(offset, offset + static_cast<Uint32>(bytes.size()));
+			++m_version;
+		}
+	}
+
 	Uint32 rom::SpinballROM::WriteUint8(Uint32 offset, Uint8 value)
 	{
 		if (offset + 1 <= m_buffer.size())
 		{
-			m_buffer[offset] = value;
+			const Uint8 bytes[1] = { value };
+			ApplyWrite(offset, ByteSpan{ bytes, sizeof(bytes) });
 		}
 		return offset + 1;
 	}
@@ -275,8 +557,12 @@ namespace spintool
 	{
 		if ((offset + 2) <= m_buffer.size())
 		{
-			m_buffer[offset] = (value & 0x0000FF00) >> 8;
-			m_buffer[offset+1] = (value & 0x000000FF);
+			const Uint8 bytes[2] =
+			{
+				static_cast<Uint8>((value & 0x0000FF00) >> 8),
+				static_cast<Uint8>(value & 0x000000FF)
+			};
+			ApplyWrite(offset, ByteSpan{ bytes, sizeof(bytes) });
 		}
 
 		return offset + 2;
@@ -286,13 +572,360 @@ namespace spintool
 	{
 		if ((offset + 4) <= m_buffer.size())
 		{
-			m_buffer[offset] = (value & 0xFF000000) >> 24;
-			m_buffer[offset + 1] = (value & 0x00FF0000) >> 16;
-			m_buffer[offset + 2] = (value & 0x0000FF00) >> 8;
-			m_buffer[offset + 3] = (value & 0x000000FF);
-
+			const Uint8 bytes[4] =
+			{
+				static_cast<Uint8>((value & 0xFF000000) >> 24),
+				static_cast<Uint8>((value & 0x00FF0000) >> 16),
+				static_cast<Uint8>((value & 0x0000FF00) >> 8),
+				static_cast<Uint8>(value & 0x000000FF)
+			};
+			ApplyWrite(offset, ByteSpan{ bytes, sizeof(bytes) });
 		}
 		return offset + 4;
 	}
 
-}
+	Uint32 rom::SpinballROM::WriteBytes(Uint32 offset, ByteSpan bytes)
+	{
+		const Uint32 end_offset = offset + static_cast<Uint32>(bytes.size());
+		if (offset > m_buffer.size() || bytes.size() > m_buffer.size() - offset)
+		{
+			return end_offset;
+		}
+
+		// Only touch the runs that actually change, so restoring a large snapshot
+		// doesn't pull every page of the image into the copy-on-write overlay
+		// or mark untouched bytes as dirty. Runs separated by a short stretch of
+		// unchanged bytes are written together; otherwise a buffer where every
+		// other byte changes turns into one journal entry per byte.
+		constexpr size_t max_unchanged_gap = 32;
+		size_t i = 0;
+		while (i < bytes.size())
+		{
+			if (m_buffer[offset + i] == bytes[i])
+			{
+				++i;
+				continue;
+			}
+
+			size_t run_end = i + 1;
+			size_t unchanged = 0;
+			for (size_t next = run_end; next < bytes.size() && unchanged <= max_unchanged_gap; ++next)
+			{
+				if (m_buffer[offset + next] != bytes[next])
+				{
+					run_end = next + 1;
+					unchanged = 0;
+				}
+				else
+				{
+					++unchanged;
+				}
+			}
+
+			ApplyWrite(offset + static_cast<Uint32>(i), bytes.subspan(i, run_end - i));
+			i = run_end;
+		}
+		return end_offset;
+	}
+
+	Uint32 rom::SpinballROM::FillBytes(Uint32 offset, Uint8 value, Uint32 count)
+	{
+		const std::vector<Uint8> fill(count, value);
+		return WriteBytes(offset, fill);
+	}
+
+	void rom::SpinballROM::Resize(Uint32 new_size, Uint8 fill_value)
+	{
+		if (new_size != m_buffer.size())
+		{
+			// Bytes past the shorter of the two sizes either appeared or went away.
+			const Uint32 old_size = static_cast<Uint32>(m_buffer.size());
+			const Uint32 changed_begin = std::min<Uint32>(new_size, old_size);
+			const Uint32 changed_end = std::max<Uint32>(new_size, old_size);
+			if (!m_applying_history)
+			{
+				const std::vector<Uint8> added_tail(new_size > old_size ? new_size - old_size : 0, fill_value);
+				const ByteSpan removed_tail = new_size < old_size ? ByteSpan{ m_buffer.data() + new_size, old_size - new_size } : ByteSpan{};
+				m_journal.RecordResize(old_size, new_size, removed_tail, added_tail);
+			}
+			m_changed_ranges.Add(changed_begin, changed_end);
+			m_pointer_index.NotifyWrite(changed_begin, changed_end);
+			m_buffer.Resize(new_size, fill_value);
+			++m_version;
+			m_requires_full_save = true;
+			m_checksum = ComputeChecksum(m_buffer);
+		}
+	}
+
+	Uint64 rom::SpinballROM::GetVersion() const
+	{
+		return m_version;
+	}
+
+	std::shared_ptr<const rom::ROMSnapshot> rom::SpinballROM::GetSnapshot()
+	{
+		if (m_published_snapshot == nullptr || m_published_snapshot->GetVersion() != m_version)
+		{
+			// Readers holding the previous snapshot keep it alive until they let go.
+			m_published_snapshot = std::make_shared<const ROMSnapshot>(*this, m_version);
+		}
+		return m_published_snapshot;
+	}
+
+	rom::ROMAssetIndex& rom::SpinballROM::GetAssetIndex() const
+	{
+		return m_asset_index;
+	}
+
+	const rom::PointerIndex& rom::SpinballROM::GetPointerIndex()
+	{
+		m_pointer_index.Refresh(m_buffer);
+		return m_pointer_index;
+	}
+
+	rom::AssetCache& rom::SpinballROM::GetAssetCache() const
+	{
+		return m_asset_cache;
+	}
+
+	void rom::SpinballROM::RefreshChecksum()
+	{
+		if (m_buffer.size() < s_checksum_offset + 2)
+		{
+			return;
+		}
+		WriteUint16(s_checksum_offset, m_checksum);
+	}
+
+	Uint16 rom::SpinballROM::GetChecksum() const
+	{
+		return m_checksum;
+	}
+
+	Uint16 rom::SpinballROM::ComputeChecksum(ByteSpan image)
+	{
+		if (image.size() <= s_checksum_range_start)
+		{
+			return 0;
+		}
+
+		// Sum(word) == (Sum(high bytes) << 8) + Sum(low bytes) modulo 2^16, so the even and
+		// odd addressed bytes are summed separately and combined at the end.
+		const Uint8* current = image.data() + s_checksum_range_start;
+		const Uint8* const end = image.data() + image.size();
+		Uint64 high_sum = 0;
+		Uint64 low_sum = 0;
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+		const __m128i low_byte_mask = _mm_set1_epi16(0x00FF);
+		const __m128i zero = _mm_setzero_si128();
+		__m128i high_acc = _mm_setzero_si128();
+		__m128i low_acc = _mm_setzero_si128();
+		for (; end - current >= 16; current += 16)
+		{
+			const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(current));
+			// Little-endian lanes: the even (high) byte of each word sits in the low half.
+			high_acc = _mm_add_epi64(high_acc, _mm_sad_epu8(_mm_and_si128(chunk, low_byte_mask), zero));
+			low_acc = _mm_add_epi64(low_acc, _mm_sad_epu8(_mm_srli_epi16(chunk, 8), zero));
+		}
+		alignas(16) Uint64 lanes[2];
+		_mm_store_si128(reinterpret_cast<__m128i*>(lanes), high_acc);
+		high_sum += lanes[0] + lanes[1];
+		_mm_store_si128(reinterpret_cast<__m128i*>(lanes), low_acc);
+		low_sum += lanes[0] + lanes[1];
+#else
+		// SWAR: add four words per step into 16-bit lanes, folding before a lane can overflow.
+		constexpr Uint64 lane_mask = 0x00FF00FF00FF00FFULL;
+		constexpr size_t steps_per_fold = 0x100;
+		while (end - current >= 8)
+		{
+			Uint64 even_lanes = 0;
+			Uint64 odd_lanes = 0;
+			for (size_t step = 0; step < steps_per_fold && end - current >= 8; ++step, current += 8)
+			{
+				Uint64 chunk;
+				std::memcpy(&chunk, current, sizeof(chunk));
+				even_lanes += chunk & lane_mask;
+				odd_lanes += (chunk >> 8) & lane_mask;
+			}
+			const Uint64 even_total = (even_lanes & 0xFFFF) + ((even_lanes >> 16) & 0xFFFF) + ((even_lanes >> 32) & 0xFFFF) + (even_lanes >> 48);
+			const Uint64 odd_total = (odd_lanes & 0xFFFF) + ((odd_lanes >> 16) & 0xFFFF) + ((odd_lanes >> 32) & 0xFFFF) + (odd_lanes >> 48);
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+			high_sum += even_total;
+			low_sum += odd_total;
+#else
+			high_sum += odd_total;
+			low_sum += even_total;
+#endif
+		}
+#endif
+
+		// The loops above always consume an even number of bytes, so parity is preserved.
+		for (; current < end; ++current)
+		{
+			if (((current - image.data()) & 1) == 0)
+			{
+				high_sum += *current;
+			}
+			else
+			{
+				low_sum += *current;
+			}
+		}
+
+		return static_cast<Uint16>((high_sum << 8) + low_sum);
+	}
+
+	void rom::SpinballROM::BeginTransaction(std::string name)
+	{
+		m_journal.BeginTransaction(std::move(name));
+	}
+
+	void rom::SpinballROM::EndTransaction()
+	{
+		m_journal.EndTransaction();
+	}
+
+	void rom::SpinballROM::RollbackTransaction()
+	{
+		const std::vector<JournalDelta> deltas = m_journal.DiscardOpenWrites();
+		m_applying_history = true;
+		for (auto it = deltas.rbegin(); it != deltas.rend(); ++it)
+		{
+			ApplyHistoryDelta(*it, true);
+		}
+		m_applying_history = false;
+	}
+
+	std::vector<rom::DirtyRange> rom::SpinballROM::Undo()
+	{
+		m_journal.SealImplicitTransaction();
+		const JournalTransaction* transaction = m_journal.PeekUndo();
+		if (transaction == nullptr)
+		{
+			return {};
+		}
+
+		std::vector<DirtyRange> ranges = ApplyHistory(*transaction, true);
+		if (ranges.empty() == false)
+		{
+			m_journal.CommitUndo();
+		}
+		return ranges;
+	}
+
+	std::vector<rom::DirtyRange> rom::SpinballROM::Redo()
+	{
+		m_journal.SealImplicitTransaction();
+		const JournalTransaction* transaction = m_journal.PeekRedo();
+		if (transaction == nullptr)
+		{
+			return {};
+		}
+
+		std::vector<DirtyRange> ranges = ApplyHistory(*transaction, false);
+		if (ranges.empty() == false)
+		{
+			m_journal.CommitRedo();
+		}
+		return ranges;
+	}
+
+	const rom::ROMJournal& rom::SpinballROM::GetJournal() const
+	{
+		return m_journal;
+	}
+
+	rom::ROMJournal& rom::SpinballROM::GetJournal()
+	{
+		return m_journal;
+	}
+
+	bool rom::SpinballROM::HistoryDeltaMatches(const JournalDelta& delta, bool undo) const
+	{
+		// The image must hold what the delta left behind (undo) or what it found (redo).
+		const Uint32 expected_image_size = undo ? delta.new_image_size : delta.old_image_size;
+		if (delta.IsResize() && m_buffer.size() != expected_image_size)
+		{
+			return false;
+		}
+
+		const std::vector<Uint8> expected = undo ? delta.GetNewBytes() : delta.GetOldBytes();
+		if (delta.IsResize() && expected.empty())
+		{
+			return true;
+		}
+		return expected.size() == delta.size &&
+			delta.offset <= m_buffer.size() &&
+			delta.size <= m_buffer.size() - delta.offset &&
+			std::memcmp(m_buffer.data() + delta.offset, expected.data(), delta.size) == 0;
+	}
+
+	void rom::SpinballROM::ApplyHistoryDelta(const JournalDelta& delta, bool undo)
+	{
+		if (delta.IsResize())
+		{
+			// Growing back restores the tail the resize removed or added.
+			const Uint32 target_size = undo ? delta.old_image_size : delta.new_image_size;
+			Resize(target_size);
+			if (target_size > delta.offset)
+			{
+				ApplyWrite(delta.offset, undo ? delta.GetOldBytes() : delta.GetNewBytes());
+			}
+			return;
+		}
+		ApplyWrite(delta.offset, undo ? delta.GetOldBytes() : delta.GetNewBytes());
+	}
+
+	std::vector<rom::DirtyRange> rom::SpinballROM::ApplyHistory(const JournalTransaction& transaction, bool undo)
+	{
+		// Each delta must find the bytes it expects, otherwise something wrote around the
+		// journal. Deltas may overlap or resize the image, so check each one against the
+		// image as it is at that point and roll back the ones already applied on a mismatch.
+		bool consistent = true;
+		size_t applied = 0;
+		m_applying_history = true;
+		for (; applied < transaction.deltas.size(); ++applied)
+		{
+			const JournalDelta& delta = transaction.deltas[undo ? transaction.deltas.size() - 1 - applied : applied];
+			if (!HistoryDeltaMatches(delta, undo))
+			{
+				consistent = false;
+				break;
+			}
+			ApplyHistoryDelta(delta, undo);
+		}
+
+		if (!consistent)
+		{
+			while (applied-- > 0)
+			{
+				ApplyHistoryDelta(transaction.deltas[undo ? transaction.deltas.size() - 1 - applied : applied], !undo);
+			}
+			m_applying_history = false;
+			std::cerr << "ROM contents no longer match the undo history; discarding it\n";
+			m_journal.Clear();
+			return {};
+		}
+		m_applying_history = false;
+
+		return transaction.GetRanges();
+	}
+
+	rom::ROMTransaction::ROMTransaction(SpinballROM& rom, std::string name)
+		: m_rom(rom)
+	{
+		m_rom.BeginTransaction(std::move(name));
+	}
+
+	rom::ROMTransaction::~ROMTransaction()
+	{
+		m_rom.EndTransaction();
+	}
+
+	void rom::ROMTransaction::Rollback()
+	{
+		m_rom.RollbackTransaction();
+	}
+
+}
\ No newline at end of file
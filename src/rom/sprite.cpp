@@ -167,6 +167,7 @@ namespace spintool::rom
 			offset
 		);
 		new_sprite->is_valid = true;
+		src_rom.GetAssetIndex().Register(ROMAssetType::Sprite, new_sprite->rom_data);
 
 		return new_sprite;
 	}
@@ -0,0 +1,273 @@
+#include "rom/sprite_header_filter.h"
+
+#include "SDL3/SDL_endian.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#endif
+
+namespace spintool::rom
+{
+	namespace
+	{
+		constexpr Uint16 kMaxTiles = 0x80;
+		constexpr Uint32 kMaxVDPTiles = 1024;
+		constexpr Uint8 kMaxPieceSize = 32;
+		constexpr std::size_t kHeaderBytes = 4;
+		constexpr std::size_t kPieceHeaderBytes = 6;
+		// A block also reads the header words of its last offset.
+		constexpr std::size_t kBlockReadBytes = SpriteHeaderFilter::s_block_size + kHeaderBytes - 1;
+
+		Uint16 ReadBE16(const Uint8* bytes)
+		{
+			return static_cast<Uint16>((static_cast<Uint16>(bytes[0]) << 8) | bytes[1]);
+		}
+
+		// num_tiles and num_vdp_tiles, the only tests that need no more than the first four bytes.
+		SpriteHeaderRejection CheckHeaderWords(const Uint8* header)
+		{
+			const Uint16 num_tiles = ReadBE16(header);
+			if (num_tiles == 0 || num_tiles > kMaxTiles)
+			{
+				return SpriteHeaderRejection::TileCount;
+			}
+			const Uint16 num_vdp_tiles = ReadBE16(header + 2);
+			if (num_vdp_tiles == 0 || num_vdp_tiles > kMaxVDPTiles)
+			{
+				return SpriteHeaderRejection::VDPTileCount;
+			}
+			return SpriteHeaderRejection::None;
+		}
+
+		// The rest of Sprite::LoadFromROM for a header whose words already passed. available
+		// counts the bytes from the header to the end of the image.
+		SpriteHeaderRejection CheckPieces(const Uint8* header, std::size_t available)
+		{
+			const std::size_t num_tiles = ReadBE16(header);
+			const std::size_t piece_header_bytes = num_tiles * kPieceHeaderBytes;
+			if (piece_header_bytes > available - kHeaderBytes)
+			{
+				return SpriteHeaderRejection::TruncatedPieceHeaders;
+			}
+
+			Uint32 vdp_tiles = 0;
+			std::size_t pixel_bytes = 0;
+			const Uint8* piece = header + kHeaderBytes;
+			for (std::size_t i = 0; i < num_tiles; ++i, piece += kPieceHeaderBytes)
+			{
+				// Widths are stored halved and doubled into a Uint8, wrapping as SpriteTileHeader does.
+				const Uint8 y_size = piece[4];
+				const Uint8 x_size = static_cast<Uint8>(piece[5] * 2);
+				if (x_size == 0 || x_size > kMaxPieceSize || y_size == 0 || y_size > kMaxPieceSize)
+				{
+					return SpriteHeaderRejection::PieceSize;
+				}
+				vdp_tiles += (static_cast<Uint32>(x_size) / 8U) * (static_cast<Uint32>(y_size) / 8U);
+				pixel_bytes += (static_cast<std::size_t>(x_size) * y_size) / 2U;
+			}
+
+			if (vdp_tiles == 0 || vdp_tiles > kMaxVDPTiles)
+			{
+				return SpriteHeaderRejection::PieceVDPTileCount;
+			}
+			if (pixel_bytes > available - kHeaderBytes - piece_header_bytes)
+			{
+				return SpriteHeaderRejection::TruncatedPixelData;
+			}
+			return SpriteHeaderRejection::None;
+		}
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+		// Bit i is set when the header words at first + i pass CheckHeaderWords.
+		Uint32 PrefilterBlock(const Uint8* first)
+		{
+			const __m128i b0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+			const __m128i b1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first + 1));
+			const __m128i b2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first + 2));
+			const __m128i b3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first + 3));
+			const __m128i zero = _mm_setzero_si128();
+
+			// num_tiles 0x0001..0x0080: a zero high byte and a low byte that stays below 0x80
+			// once one is taken off, which also turns zero into 0xFF.
+			const __m128i low_minus_one = _mm_sub_epi8(b1, _mm_set1_epi8(1));
+			const __m128i tiles_ok = _mm_and_si128(
+				_mm_cmpeq_epi8(b0, zero),
+				_mm_cmpeq_epi8(_mm_min_epu8(low_minus_one, _mm_set1_epi8(0x7F)), low_minus_one));
+
+			// num_vdp_tiles 0x0001..0x0400: a high byte of 0..3 without both bytes zero, or 0x0400.
+			const __m128i b3_zero = _mm_cmpeq_epi8(b3, zero);
+			const __m128i high_below_four = _mm_cmpeq_epi8(_mm_min_epu8(b2, _mm_set1_epi8(3)), b2);
+			const __m128i both_zero = _mm_and_si128(_mm_cmpeq_epi8(b2, zero), b3_zero);
+			const __m128i vdp_ok = _mm_or_si128(
+				_mm_andnot_si128(both_zero, high_below_four),
+				_mm_and_si128(_mm_cmpeq_epi8(b2, _mm_set1_epi8(4)), b3_zero));
+
+			return static_cast<Uint32>(_mm_movemask_epi8(_mm_and_si128(tiles_ok, vdp_ok)));
+		}
+#else
+		// SWAR: eight offsets per 64-bit word, one per byte lane, each test leaving its
+		// answer in the lane's high bit. No lane ever carries into the next.
+		constexpr Uint64 kLaneOnes = 0x0101010101010101ULL;
+		constexpr Uint64 kLaneHighBits = 0x8080808080808080ULL;
+		constexpr Uint64 kLaneLowBits = 0x7F7F7F7F7F7F7F7FULL;
+
+		Uint64 LoadLanes(const Uint8* bytes)
+		{
+			Uint64 lanes;
+			std::memcpy(&lanes, bytes, sizeof(lanes));
+			return lanes;
+		}
+
+		Uint64 ZeroLanes(Uint64 lanes)
+		{
+			return ~(((lanes & kLaneLowBits) + kLaneLowBits) | lanes) & kLaneHighBits;
+		}
+
+		// limit must be below 0x80.
+		Uint64 LanesAbove(Uint64 lanes, Uint8 limit)
+		{
+			return (((lanes & kLaneLowBits) + (0x7FU - limit) * kLaneOnes) | lanes) & kLaneHighBits;
+		}
+
+		Uint32 PrefilterLanes(const Uint8* first)
+		{
+			const Uint64 b0 = LoadLanes(first);
+			const Uint64 b1 = LoadLanes(first + 1);
+			const Uint64 b2 = LoadLanes(first + 2);
+			const Uint64 b3 = LoadLanes(first + 3);
+
+			// Lane-wise b1 - 1; see the SSE2 path for why it must stay below 0x80.
+			const Uint64 low_minus_one = ((b1 | kLaneHighBits) - kLaneOnes) ^ (~b1 & kLaneHighBits);
+			const Uint64 tiles_ok = ZeroLanes(b0) & ~low_minus_one;
+
+			const Uint64 b3_zero = ZeroLanes(b3);
+			const Uint64 vdp_ok = (~LanesAbove(b2, 3) & ~(ZeroLanes(b2) & b3_zero) & kLaneHighBits)
+				| (ZeroLanes(b2 ^ (4U * kLaneOnes)) & b3_zero);
+
+			const Uint64 passed = tiles_ok & vdp_ok & kLaneHighBits;
+			Uint32 mask = 0;
+			for (Uint32 lane = 0; lane < 8; ++lane)
+			{
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+				const Uint32 shift = lane * 8U + 7U;
+#else
+				const Uint32 shift = (7U - lane) * 8U + 7U;
+#endif
+				mask |= static_cast<Uint32>((passed >> shift) & 1U) << lane;
+			}
+			return mask;
+		}
+
+		Uint32 PrefilterBlock(const Uint8* first)
+		{
+			return PrefilterLanes(first) | (PrefilterLanes(first + 8) << 8);
+		}
+#endif
+	}
+
+	const char* GetSpriteHeaderRejectionName(SpriteHeaderRejection rejection)
+	{
+		switch (rejection)
+		{
+		case SpriteHeaderRejection::None:
+			return "Candidate";
+		case SpriteHeaderRejection::OutOfBounds:
+			return "Out of bounds";
+		case SpriteHeaderRejection::TileCount:
+			return "Tile count";
+		case SpriteHeaderRejection::VDPTileCount:
+			return "VDP tile count";
+		case SpriteHeaderRejection::TruncatedPieceHeaders:
+			return "Truncated piece headers";
+		case SpriteHeaderRejection::PieceSize:
+			return "Piece size";
+		case SpriteHeaderRejection::PieceVDPTileCount:
+			return "Piece VDP tile count";
+		case SpriteHeaderRejection::TruncatedPixelData:
+			return "Truncated pixel data";
+		}
+		return "Unknown";
+	}
+
+	SpriteHeaderRejection SpriteHeaderFilter::Check(ByteSpan image, Uint32 offset)
+	{
+		const std::size_t image_size = image.size();
+		if (offset > image_size || image_size - offset < kHeaderBytes)
+		{
+			return SpriteHeaderRejection::OutOfBounds;
+		}
+
+		const Uint8* header = image.data() + offset;
+		const SpriteHeaderRejection rejection = CheckHeaderWords(header);
+		if (rejection != SpriteHeaderRejection::None)
+		{
+			return rejection;
+		}
+		return CheckPieces(header, image_size - offset);
+	}
+
+	void SpriteHeaderFilter::FindCandidates(ByteSpan image, Uint32 begin, Uint32 end, std::vector<Uint32>& candidates)
+	{
+		const std::size_t image_size = image.size();
+		if (begin > end || begin >= image_size)
+		{
+			return;
+		}
+		const std::size_t last = std::min<std::size_t>(end, image_size - 1);
+
+		std::size_t offset = begin;
+		for (; offset + s_block_size - 1 <= last && offset + kBlockReadBytes <= image_size; offset += s_block_size)
+		{
+			Uint32 passed = PrefilterBlock(image.data() + offset);
+			for (std::size_t lane = 0; passed != 0; ++lane, passed >>= 1)
+			{
+				if ((passed & 1U) != 0 && CheckPieces(image.data() + offset + lane, image_size - offset - lane) == SpriteHeaderRejection::None)
+				{
+					candidates.emplace_back(static_cast<Uint32>(offset + lane));
+				}
+			}
+		}
+
+		for (; offset <= last; ++offset)
+		{
+			if (Check(image, static_cast<Uint32>(offset)) == SpriteHeaderRejection::None)
+			{
+				candidates.emplace_back(static_cast<Uint32>(offset));
+			}
+		}
+	}
+
+	std::vector<SpriteHeaderRejection> SpriteHeaderFilter::Classify(ByteSpan image, Uint32 begin, Uint32 end)
+	{
+		std::vector<SpriteHeaderRejection> rejections;
+		if (begin > end)
+		{
+			return rejections;
+		}
+		rejections.resize(static_cast<std::size_t>(end - begin) + 1U, SpriteHeaderRejection::OutOfBounds);
+
+		const std::size_t image_size = image.size();
+		const std::size_t last = std::min<std::size_t>(end, image_size == 0 ? 0 : image_size - 1);
+		std::size_t offset = begin;
+		for (; offset + s_block_size - 1 <= last && offset + kBlockReadBytes <= image_size; offset += s_block_size)
+		{
+			const Uint32 passed = PrefilterBlock(image.data() + offset);
+			for (std::size_t lane = 0; lane < s_block_size; ++lane)
+			{
+				const Uint8* header = image.data() + offset + lane;
+				rejections[offset + lane - begin] = (passed >> lane) & 1U
+					? CheckPieces(header, image_size - offset - lane)
+					: CheckHeaderWords(header);
+			}
+		}
+
+		for (; offset <= last && offset < image_size; ++offset)
+		{
+			rejections[offset - begin] = Check(image, static_cast<Uint32>(offset));
+		}
+		return rejections;
+	}
+}
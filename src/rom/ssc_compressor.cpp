@@ -1,54 +1,290 @@
 #include "rom/ssc_compressor.h"
-#include <cassert>
+
+#include "rom/ssc_decompressor.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <limits>
 
 namespace spintool::rom
 {
-	SSCCompressionResult SSCCompressor::CompressData(const std::vector<Uint8>& in_data, Uint32 offset, Uint32 working_data_size_hint)
+	namespace
 	{
-		// Initial implementation will just push uncompressed data entirely
+		constexpr std::size_t kRingSize = 0x1000;
+		constexpr std::size_t kMinMatch = 2;
+		constexpr std::size_t kMaxMatch = 0x0F + kMinMatch;
+		constexpr std::size_t kNoPosition = std::numeric_limits<std::size_t>::max();
+
+		// Each token also costs one flag bit.
+		constexpr std::size_t kLiteralBits = 9;
+		constexpr std::size_t kCopyBits = 17;
+
+		struct Match
+		{
+			std::size_t length = 0;
+			Uint16 source = 0;
+		};
+
+		// Output byte n is stored at ring position n + 1, so a copy of it reads from there.
+		Uint16 GetRingPosition(std::size_t output_index)
+		{
+			return static_cast<Uint16>((output_index + 1) & (kRingSize - 1));
+		}
+
+		// Hash chains keyed on the two bytes at each position. Two bytes is already the
+		// minimum match, so the key is exact and needs no collision check.
+		class MatchFinder
+		{
+		public:
+			MatchFinder(const std::vector<Uint8>& data, Uint32 max_chain_length)
+				: m_data(data)
+				, m_head(0x10000, kNoPosition)
+				, m_prev(data.size(), kNoPosition)
+				, m_max_chain_length(std::max<Uint32>(1, max_chain_length))
+			{
+			}
+
+			Match FindLongest(std::size_t position) const
+			{
+				Match best;
+				if (position + kMinMatch > m_data.size())
+				{
+					return best;
+				}
+
+				const std::size_t max_length = std::min(kMaxMatch, m_data.size() - position);
+				std::size_t candidate = m_head[GetKey(position)];
+				for (Uint32 steps = 0; candidate != kNoPosition && steps < m_max_chain_length; ++steps, candidate = m_prev[candidate])
+				{
+					// The ring holds the last 4 KB, and position zero is the end marker.
+					if (position - candidate > kRingSize)
+					{
+						break;
+					}
+					const Uint16 source = GetRingPosition(candidate);
+					if (source == 0)
+					{
+						continue;
+					}
+
+					// A candidate can only win if it also matches the byte the best one failed on.
+					if (best.length >= kMinMatch && m_data[candidate + best.length] != m_data[position + best.length])
+					{
+						continue;
+					}
+
+					// Copies run byte by byte, so a source overlapping the output repeats it.
+					std::size_t length = kMinMatch;
+					while (length < max_length && m_data[candidate + length] == m_data[position + length])
+					{
+						++length;
+					}
+					if (length > best.length)
+					{
+						best.length = length;
+						best.source = source;
+						if (length == max_length)
+						{
+							break;
+						}
+					}
+				}
+				return best;
+			}
+
+			void Insert(std::size_t position)
+			{
+				if (position + kMinMatch > m_data.size())
+				{
+					return;
+				}
+				const std::size_t key = GetKey(position);
+				m_prev[position] = m_head[key];
+				m_head[key] = position;
+			}
+
+		private:
+			std::size_t GetKey(std::size_t position) const
+			{
+				return (static_cast<std::size_t>(m_data[position]) << 8) | m_data[position + 1];
+			}
+
+			const std::vector<Uint8>& m_data;
+			std::vector<std::size_t> m_head;
+			std::vector<std::size_t> m_prev;
+			Uint32 m_max_chain_length;
+		};
+
+		class TokenWriter
+		{
+		public:
+			void WriteLiteral(Uint8 value)
+			{
+				BeginToken(true);
+				m_out.emplace_back(value);
+			}
 
-		std::vector<Uint8> out_data;
+			void WriteCopy(Uint16 source, std::size_t length)
+			{
+				BeginToken(false);
+				m_out.emplace_back(static_cast<Uint8>(source & 0xFF));
+				m_out.emplace_back(static_cast<Uint8>(((source >> 8) << 4) | (length - kMinMatch)));
+			}
+
+			SSCCompressionResult Finish()
+			{
+				WriteCopy(0, kMinMatch);
+				return std::move(m_out);
+			}
+
+		private:
+			void BeginToken(bool is_literal)
+			{
+				if (m_num_flags == 8)
+				{
+					m_num_flags = 0;
+				}
+				if (m_num_flags == 0)
+				{
+					m_flags_index = m_out.size();
+					m_out.emplace_back(0);
+				}
+				if (is_literal)
+				{
+					m_out[m_flags_index] |= static_cast<Uint8>(1 << m_num_flags);
+				}
+				++m_num_flags;
+			}
 
-		size_t current_data_index = 0u;
+			SSCCompressionResult m_out;
+			std::size_t m_flags_index = 0;
+			int m_num_flags = 0;
+		};
 
-		while (current_data_index < in_data.size())
+		SSCCompressionResult EncodeLiterals(const std::vector<Uint8>& in_data)
 		{
-			const size_t size_diff = std::min<size_t>(in_data.size() - current_data_index, 8ull);
-			Uint8 fragment_header = 0x00;
-			switch (size_diff)
+			TokenWriter writer;
+			for (const Uint8 value : in_data)
 			{
-				case 8: fragment_header |= 0x80;
-				case 7: fragment_header |= 0x40;
-				case 6: fragment_header |= 0x20;
-				case 5: fragment_header |= 0x10;
-				case 4: fragment_header |= 0x08;
-				case 3: fragment_header |= 0x04;
-				case 2: fragment_header |= 0x02;
-				case 1: fragment_header |= 0x01;
+				writer.WriteLiteral(value);
 			}
-			out_data.emplace_back(fragment_header);
+			return writer.Finish();
+		}
+
+		SSCCompressionResult Encode(const std::vector<Uint8>& in_data, const SSCCompressionSettings& settings, SSCCompressionStats& stats)
+		{
+			const std::size_t size = in_data.size();
+			MatchFinder finder{ in_data, settings.max_chain_length };
+			TokenWriter writer;
 
-			for (size_t fragments_remaining = size_diff; fragments_remaining > 0; --fragments_remaining)
+			if (!settings.optimal_parse)
 			{
-				const size_t read_index = (current_data_index + size_diff) - fragments_remaining;
-				assert(read_index < in_data.size());
-				out_data.emplace_back(in_data.at(read_index));
+				std::size_t position = 0;
+				while (position < size)
+				{
+					const Match match = finder.FindLongest(position);
+					const std::size_t advance = match.length >= kMinMatch ? match.length : 1;
+					if (match.length >= kMinMatch)
+					{
+						writer.WriteCopy(match.source, match.length);
+						++stats.num_copies;
+					}
+					else
+					{
+						writer.WriteLiteral(in_data[position]);
+						++stats.num_literals;
+					}
+					for (std::size_t i = 0; i < advance; ++i)
+					{
+						finder.Insert(position + i);
+					}
+					position += advance;
+				}
+				return writer.Finish();
 			}
 
-			if (current_data_index + size_diff == in_data.size())
+			// Any prefix of the longest match is also a valid copy, so the longest one per
+			// position is all the shortest-path search below needs.
+			std::vector<Match> longest(size);
+			for (std::size_t position = 0; position < size; ++position)
 			{
-				out_data.emplace_back(0u);
-				out_data.emplace_back(0u);
-				out_data.emplace_back(0u);
-				break;
+				longest[position] = finder.FindLongest(position);
+				finder.Insert(position);
 			}
-			else
+
+			std::vector<std::size_t> cost(size + 1, 0);
+			std::vector<Uint8> step(size, 1);
+			for (std::size_t position = size; position-- > 0;)
+			{
+				cost[position] = kLiteralBits + cost[position + 1];
+				step[position] = 1;
+				for (std::size_t length = kMinMatch; length <= longest[position].length; ++length)
+				{
+					const std::size_t copy_cost = kCopyBits + cost[position + length];
+					if (copy_cost < cost[position])
+					{
+						cost[position] = copy_cost;
+						step[position] = static_cast<Uint8>(length);
+					}
+				}
+			}
+
+			for (std::size_t position = 0; position < size; position += step[position])
 			{
-				current_data_index += 8u;
+				if (step[position] == 1)
+				{
+					writer.WriteLiteral(in_data[position]);
+					++stats.num_literals;
+				}
+				else
+				{
+					writer.WriteCopy(longest[position].source, step[position]);
+					++stats.num_copies;
+				}
 			}
+			return writer.Finish();
 		}
+	}
 
-		return out_data;
+	double SSCCompressionStats::GetRatio() const
+	{
+		return input_size > 0 ? static_cast<double>(output_size) / static_cast<double>(input_size) : 0.0;
 	}
 
+	double SSCCompressionStats::GetMegabytesPerSecond() const
+	{
+		return milliseconds > 0.0 ? (static_cast<double>(input_size) / (1024.0 * 1024.0)) / (milliseconds / 1000.0) : 0.0;
+	}
+
+	SSCCompressionResult SSCCompressor::CompressData(
+		const std::vector<Uint8>& in_data,
+		const SSCCompressionSettings& settings,
+		SSCCompressionStats* stats
+	)
+	{
+		SSCCompressionStats local_stats;
+		SSCCompressionStats& result_stats = stats ? *stats : local_stats;
+		result_stats = {};
+		result_stats.input_size = in_data.size();
+
+		const auto start = std::chrono::steady_clock::now();
+		SSCCompressionResult out_data = Encode(in_data, settings, result_stats);
+		result_stats.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		const SSCDecompressionResult round_trip = SSCDecompressor::DecompressData(out_data, 0, static_cast<Uint32>(in_data.size()));
+		result_stats.verified = !round_trip.error_msg.has_value()
+			&& round_trip.uncompressed_data == in_data
+			&& round_trip.rom_data.rom_offset_end == out_data.size();
+		if (!result_stats.verified)
+		{
+			std::cerr << "SSC round trip failed for " << in_data.size() << " bytes; storing them uncompressed\n";
+			out_data = EncodeLiterals(in_data);
+			result_stats.num_literals = in_data.size();
+			result_stats.num_copies = 0;
+		}
+
+		result_stats.output_size = out_data.size();
+		return out_data;
+	}
 }
@@ -1,5 +1,46 @@
 #include "rom/ssc_decompressor.h"
 
+#include <algorithm>
+#include <cstring>
+
+namespace spintool::rom
+{
+    namespace
+    {
+        constexpr size_t kRingMask = 0xFFFU;
+        constexpr size_t kMaxGroupInput = 1U + 8U * 2U;
+        constexpr size_t kMaxCopyLength = 0x0FU + 2U;
+        constexpr size_t kMaxGroupOutput = 8U * kMaxCopyLength;
+
+        // Output byte n sits at ring position n + 1, so a copy from ring position source
+        // with pos bytes already written always reads distance bytes back, where distance
+        // is in [1, 0x1000]. Ring slots that were never written still hold their initial zero.
+        void CopyFromWindow(Uint8* out, size_t pos, size_t source, size_t count)
+        {
+            const size_t distance = 1U + ((pos - source) & kRingMask);
+            if (pos >= distance && distance >= count)
+            {
+                std::memcpy(out + pos, out + pos - distance, count);
+            }
+            else if (pos >= distance)
+            {
+                // Overlapping copies repeat the last distance bytes.
+                for (size_t i = 0; i < count; ++i)
+                {
+                    out[pos + i] = out[pos + i - distance];
+                }
+            }
+            else
+            {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    out[pos + i] = pos + i >= distance ? out[pos + i - distance] : 0;
+                }
+            }
+        }
+    }
+}
+
 namespace spintool::rom
 {
     SSCDecompressionResult SSCDecompressor::IsValidSSCCompressedData(const Uint8* in_data, const Uint32 starting_offset)
@@ -27,7 +68,7 @@ namespace spintool::rom
     }
 
     SSCDecompressionResult SSCDecompressor::DecompressData(
-        const std::vector<Uint8>& in_data,
+        ByteSpan in_data,
         const Uint32 offset,
         const Uint32 working_data_size_hint)
     {
@@ -40,10 +81,10 @@ namespace spintool::rom
 
         std::vector<Uint8> working_data(0x1000, 0);
         auto& out_data = results.uncompressed_data;
-        out_data.reserve(std::min<size_t>(working_data_size_hint, 16U * 1024U * 1024U));
+        out_data.reserve(std::min<size_t>(working_data_size_hint, s_max_output_size));
 
         size_t current = offset;
-        constexpr size_t max_output_size = 16U * 1024U * 1024U;
+        constexpr size_t max_output_size = s_max_output_size;
         constexpr size_t max_fragments = 32U * 1024U * 1024U;
         size_t processed_fragments = 0;
         bool end_reached = false;
@@ -131,4 +172,164 @@ namespace spintool::rom
         results.uncompressed_size = out_data.size();
         return results;
     }
+
+    SSCDecompressionResult SSCDecompressor::DecompressDataFast(
+        ByteSpan in_data,
+        const Uint32 offset,
+        const Uint32 working_data_size_hint,
+        const size_t output_limit)
+    {
+        SSCStreamDecoder decoder{ in_data, offset, working_data_size_hint, output_limit };
+        decoder.DecodeAll();
+        return decoder.TakeResult();
+    }
+
+    SSCStreamDecoder::SSCStreamDecoder(
+        ByteSpan in_data,
+        const Uint32 offset,
+        const Uint32 working_data_size_hint,
+        const size_t output_limit)
+        : m_in_data(in_data)
+        , m_offset(offset)
+        , m_max_output_size(std::min(output_limit, SSCDecompressor::s_max_output_size))
+        , m_current(offset)
+    {
+        if (offset >= in_data.size())
+        {
+            m_error_msg = "SSC offset is outside the input buffer";
+            m_finished = true;
+            return;
+        }
+
+        // Slack past the limit lets a whole group run unchecked; it is trimmed at the end.
+        m_out_data.resize(std::min<size_t>(working_data_size_hint, m_max_output_size) + kMaxGroupOutput);
+    }
+
+    bool SSCStreamDecoder::DecodeAll()
+    {
+        return DecodeUntil(m_max_output_size + kMaxGroupOutput + 1U);
+    }
+
+    bool SSCStreamDecoder::DecodeUntil(const size_t output_size)
+    {
+        const size_t max_output_size = m_max_output_size;
+        const Uint8* const in = m_in_data.data();
+        const size_t in_size = m_in_data.size();
+        std::vector<Uint8>& out_data = m_out_data;
+        size_t pos = m_pos;
+        size_t current = m_current;
+        bool end_reached = m_finished;
+
+        while (!end_reached && pos < output_size)
+        {
+            if (out_data.size() - pos < kMaxGroupOutput)
+            {
+                out_data.resize(std::min(out_data.size() * 2, max_output_size + kMaxGroupOutput + 1U));
+            }
+
+            // Enough input for eight copy tokens and enough room for eight full copies: no
+            // check can fail inside this group, so none are made.
+            if (in_size - current >= kMaxGroupInput && max_output_size - std::min(pos, max_output_size) >= kMaxGroupOutput)
+            {
+                Uint8 fragment_header = in[current++];
+                for (int fragment = 0; fragment < 8; ++fragment, fragment_header >>= 1U)
+                {
+                    if ((fragment_header & 1U) != 0)
+                    {
+                        out_data[pos++] = in[current++];
+                        continue;
+                    }
+
+                    const size_t source = static_cast<size_t>(in[current]) | (static_cast<size_t>(in[current + 1] & 0xF0U) << 4U);
+                    const size_t copy_count = static_cast<size_t>(in[current + 1] & 0x0FU) + 2U;
+                    current += 2;
+                    if (source == 0)
+                    {
+                        end_reached = true;
+                        break;
+                    }
+                    CopyFromWindow(out_data.data(), pos, source, copy_count);
+                    pos += copy_count;
+                }
+                continue;
+            }
+
+            // Near the end of the input or the output limit, check every token like the reference.
+            if (current >= in_size)
+            {
+                m_error_msg = "Unexpected end of SSC stream while reading a fragment header";
+                break;
+            }
+
+            Uint8 fragment_header = in[current++];
+            for (int fragment = 0; fragment < 8; ++fragment, fragment_header >>= 1U)
+            {
+                if ((fragment_header & 1U) != 0)
+                {
+                    if (current >= in_size)
+                    {
+                        m_error_msg = "Unexpected end of SSC stream while reading raw data";
+                        end_reached = true;
+                        break;
+                    }
+                    out_data[pos++] = in[current++];
+                }
+                else
+                {
+                    if (in_size - current < 2)
+                    {
+                        m_error_msg = "Unexpected end of SSC stream while reading a copy token";
+                        end_reached = true;
+                        break;
+                    }
+
+                    const size_t source = static_cast<size_t>(in[current]) | (static_cast<size_t>(in[current + 1] & 0xF0U) << 4U);
+                    const size_t copy_count = static_cast<size_t>(in[current + 1] & 0x0FU) + 2U;
+                    current += 2;
+                    if (source == 0)
+                    {
+                        end_reached = true;
+                        break;
+                    }
+                    if (pos > max_output_size || copy_count > max_output_size - pos)
+                    {
+                        m_error_msg = "SSC output exceeded the safety limit";
+                        end_reached = true;
+                        break;
+                    }
+                    CopyFromWindow(out_data.data(), pos, source, copy_count);
+                    pos += copy_count;
+                }
+
+                if (pos > max_output_size)
+                {
+                    m_error_msg = "SSC output exceeded the safety limit";
+                    end_reached = true;
+                    break;
+                }
+            }
+        }
+
+        m_pos = pos;
+        m_current = current;
+        m_finished = end_reached || m_error_msg.has_value();
+        return !m_error_msg.has_value();
+    }
+
+    SSCDecompressionResult SSCStreamDecoder::TakeResult()
+    {
+        SSCDecompressionResult results;
+        results.error_msg = std::move(m_error_msg);
+        if (m_offset >= m_in_data.size())
+        {
+            return results;
+        }
+
+        m_out_data.resize(m_pos);
+        results.uncompressed_data = std::move(m_out_data);
+        results.rom_data.SetROMData(m_offset, static_cast<Uint32>(std::min(m_current, m_in_data.size())));
+        results.uncompressed_size = m_pos;
+        m_pos = 0;
+        return results;
+    }
 }
@@ -0,0 +1,479 @@
+#include "rom/stream_discovery.h"
+
+#include "rom/asset_cache.h"
+#include "rom/compressed2_decoder.h"
+#include "rom/rom_cursor.h"
+#include "rom/rom_snapshot.h"
+#include "rom/ssc_decompressor.h"
+#include "rom/tileset.h"
+
+#include <algorithm>
+#include <cmath>
+#include <set>
+
+namespace spintool::rom
+{
+	namespace
+	{
+		constexpr Uint32 kTileBytes = TileSet::s_tile_total_bytes;
+		// Compressed2 tilesets decode to a two-byte prefix ahead of the tiles.
+		constexpr Uint32 kCompressed2PrefixBytes = 2;
+		// Tokens a Compressed2 candidate must get through before it is trial decoded. They are
+		// all nine bits wide, since the dictionary can't reach 0x200 entries this early.
+		constexpr std::size_t kCompressed2PrefilterTokens = 8;
+		constexpr std::size_t kCompressed2PrefilterBytes = (kCompressed2PrefilterTokens * 9 + 7) / 8 + 2;
+		// Payload layout per stream: start, end, uncompressed size, algorithm, confidence.
+		constexpr std::size_t kCachedStreamBytes = 4 + 4 + 4 + 1 + 1;
+
+		// The tile count header holds a plausible number of tiles.
+		bool PrefilterSSC(ByteSpan image, Uint32 offset)
+		{
+			if (offset >= image.size() || image.size() - offset < 3)
+			{
+				return false;
+			}
+			const Uint32 num_tiles = (static_cast<Uint32>(image[offset]) << 8) | image[offset + 1];
+			return num_tiles * kTileBytes >= StreamDiscovery::s_min_uncompressed_size && num_tiles < StreamDiscovery::s_max_ssc_tiles;
+		}
+
+		// The first tokens only use codes the dictionary already holds, with a literal after
+		// every CLEAR and no END. Random bytes pass each token about half the time.
+		bool PrefilterCompressed2(ByteSpan image, Uint32 offset)
+		{
+			if (offset >= image.size() || image.size() - offset < kCompressed2PrefilterBytes)
+			{
+				return false;
+			}
+
+			const Uint8* const bytes = image.data() + offset;
+			// The stream starts as if a zero byte had just been decoded; see Compressed2StreamDecoder.
+			Uint16 next_code = 0x0102;
+			bool expect_literal = false;
+			for (std::size_t token = 0; token < kCompressed2PrefilterTokens; ++token)
+			{
+				const std::size_t bit = token * 9;
+				const Uint32 window = bytes[bit / 8] | (static_cast<Uint32>(bytes[bit / 8 + 1]) << 8) | (static_cast<Uint32>(bytes[bit / 8 + 2]) << 16);
+				const Uint16 code = static_cast<Uint16>((window >> (bit % 8)) & 0x01FFU);
+				if (code == 0x0101)
+				{
+					return false;
+				}
+				if (expect_literal)
+				{
+					if (code > 0x00FF)
+					{
+						return false;
+					}
+					expect_literal = false;
+				}
+				else if (code == 0x0100)
+				{
+					next_code = 0x0102;
+					expect_literal = true;
+				}
+				else if (code > next_code)
+				{
+					return false;
+				}
+				else
+				{
+					++next_code;
+				}
+			}
+			return true;
+		}
+
+		// Decodes to exactly the header's tile count. The game's compressors always open with a
+		// raw byte, and real tile data shrinks.
+		std::optional<DiscoveredStream> TrySSC(ByteSpan image, Uint32 offset)
+		{
+			const Uint32 num_tiles = (static_cast<Uint32>(image[offset]) << 8) | image[offset + 1];
+			const Uint32 expected_size = num_tiles * kTileBytes;
+			const SSCDecompressionResult result = SSCDecompressor::DecompressDataFast(image, offset + 2, expected_size, expected_size);
+			if (result.error_msg.has_value() || result.uncompressed_size != expected_size)
+			{
+				return std::nullopt;
+			}
+
+			DiscoveredStream stream;
+			stream.algorithm = CompressionAlgorithm::SSC;
+			stream.rom_data.SetROMData(offset, result.rom_data.rom_offset_end);
+			stream.uncompressed_size = expected_size;
+			stream.num_tiles = num_tiles;
+			stream.confidence = 0.5f
+				+ ((image[offset + 2] & 1U) != 0 ? 0.25f : 0.0f)
+				+ (stream.rom_data.real_size < expected_size ? 0.25f : 0.0f);
+			return stream;
+		}
+
+		// Ends on its END token inside the VRAM bound. Whole tiles after the prefix and a
+		// stream shorter than its output both point at tile data rather than a lucky decode.
+		std::optional<DiscoveredStream> TryCompressed2(ByteSpan image, Uint32 offset)
+		{
+			Compressed2StreamDecoder decoder{ image, offset };
+			decoder.DecodeUntil(StreamDiscovery::s_max_compressed2_size + 1);
+			const std::size_t output_size = decoder.GetOutput().size();
+			if (!decoder.IsFinished() || decoder.GetError().has_value() ||
+				output_size < kCompressed2PrefixBytes + StreamDiscovery::s_min_uncompressed_size ||
+				output_size > StreamDiscovery::s_max_compressed2_size)
+			{
+				return std::nullopt;
+			}
+
+			const std::size_t tile_bytes = output_size - kCompressed2PrefixBytes;
+			DiscoveredStream stream;
+			stream.algorithm = CompressionAlgorithm::LZSS;
+			// Whole bytes consumed, as the game's end pointer and the LZSS loader count them.
+			stream.rom_data.SetROMData(offset, offset + static_cast<Uint32>(decoder.GetResult().consumed_bits >> 3));
+			stream.uncompressed_size = static_cast<Uint32>(output_size);
+			stream.num_tiles = static_cast<Uint32>(tile_bytes / kTileBytes);
+			stream.confidence = 0.4f
+				+ (tile_bytes % kTileBytes == 0 ? 0.3f : 0.0f)
+				+ (stream.rom_data.real_size < output_size ? 0.3f : 0.0f);
+			return stream;
+		}
+
+		std::vector<Uint8> EncodeStreams(const std::vector<DiscoveredStream>& streams)
+		{
+			ROMWriter writer{ 0 };
+			writer.Reserve(streams.size() * kCachedStreamBytes);
+			for (const DiscoveredStream& stream : streams)
+			{
+				writer.WriteUint32(stream.rom_data.rom_offset);
+				writer.WriteUint32(stream.rom_data.rom_offset_end);
+				writer.WriteUint32(stream.uncompressed_size);
+				writer.WriteUint8(static_cast<Uint8>(stream.algorithm));
+				writer.WriteUint8(static_cast<Uint8>(std::lround(stream.confidence * 255.0f)));
+			}
+			return std::vector<Uint8>(writer.GetBytes().begin(), writer.GetBytes().end());
+		}
+
+		void TrySSCOffset(ByteSpan image, Uint32 offset, std::vector<DiscoveredStream>& streams)
+		{
+			if (PrefilterSSC(image, offset))
+			{
+				if (std::optional<DiscoveredStream> stream = TrySSC(image, offset))
+				{
+					streams.emplace_back(*stream);
+				}
+			}
+		}
+
+		void TryCompressed2Offset(ByteSpan image, Uint32 offset, std::vector<DiscoveredStream>& streams)
+		{
+			if (PrefilterCompressed2(image, offset))
+			{
+				if (std::optional<DiscoveredStream> stream = TryCompressed2(image, offset))
+				{
+					streams.emplace_back(*stream);
+				}
+			}
+		}
+
+		// Both formats at one offset, SSC first, as the search reports them.
+		void TryOffset(ByteSpan image, Uint32 offset, std::vector<DiscoveredStream>& streams)
+		{
+			TrySSCOffset(image, offset, streams);
+			TryCompressed2Offset(image, offset, streams);
+		}
+
+		std::vector<DiscoveredStream> DecodeStreams(const std::vector<Uint8>& payload)
+		{
+			std::vector<DiscoveredStream> streams;
+			ROMCursor cursor{ ROMSpan{ payload, 0, static_cast<Uint32>(payload.size()) } };
+			while (cursor.Remaining() >= kCachedStreamBytes)
+			{
+				DiscoveredStream& stream = streams.emplace_back();
+				const Uint32 begin = cursor.ReadUint32();
+				const Uint32 end = cursor.ReadUint32();
+				stream.rom_data.SetROMData(begin, end);
+				stream.uncompressed_size = cursor.ReadUint32();
+				stream.algorithm = static_cast<CompressionAlgorithm>(cursor.ReadUint8());
+				stream.confidence = static_cast<float>(cursor.ReadUint8()) / 255.0f;
+				const Uint32 prefix_bytes = stream.algorithm == CompressionAlgorithm::LZSS ? kCompressed2PrefixBytes : 0;
+				stream.num_tiles = (stream.uncompressed_size - prefix_bytes) / kTileBytes;
+			}
+			return streams;
+		}
+	}
+
+	StreamDiscovery::StreamDiscovery(std::shared_ptr<const ROMSnapshot> snapshot, AssetCache& asset_cache, Uint32 begin, Uint32 end)
+		: m_snapshot(std::move(snapshot))
+		, m_asset_cache(asset_cache)
+	{
+		SetRange(begin, end);
+		m_thread = std::thread([this]() { Run(); });
+	}
+
+	StreamDiscovery::StreamDiscovery(std::shared_ptr<const ROMSnapshot> snapshot, AssetCache& asset_cache, Uint32 begin, Uint32 end,
+		std::vector<DiscoveredStream> results, std::vector<DirtyRange> ranges)
+		: m_snapshot(std::move(snapshot))
+		, m_asset_cache(asset_cache)
+	{
+		SetRange(begin, end);
+		m_thread = std::thread([this, results = std::move(results), ranges = std::move(ranges)]() mutable { Rescan(std::move(results), ranges); });
+	}
+
+	StreamDiscovery::~StreamDiscovery()
+	{
+		Cancel();
+		if (m_thread.joinable())
+		{
+			m_thread.join();
+		}
+	}
+
+	void StreamDiscovery::Cancel()
+	{
+		m_cancelled = true;
+	}
+
+	void StreamDiscovery::SetRange(Uint32 begin, Uint32 end)
+	{
+		const std::size_t image_size = m_snapshot->GetROM().m_buffer.size();
+		// Streams start on even offsets, like everything else the 68k reads a word at a time.
+		m_begin = begin + (begin & 1U);
+		m_end = image_size > 0 ? static_cast<Uint32>(std::min<std::size_t>(end, image_size - 1)) : 0;
+	}
+
+	bool StreamDiscovery::TakeCachedResults()
+	{
+		const AssetCacheKey cache_key{ AssetCacheKind::StreamDiscovery, m_begin, m_end };
+		std::optional<AssetCacheHit> hit = m_asset_cache.Find(cache_key, m_snapshot->GetROM().m_buffer);
+		if (!hit)
+		{
+			return false;
+		}
+		std::vector<DiscoveredStream> cached = DecodeStreams(hit->payload);
+		std::lock_guard<std::mutex> results_lock(m_results_mutex);
+		m_results = std::move(cached);
+		return true;
+	}
+
+	void StreamDiscovery::CollectResults(std::vector<DiscoveredStream>& results)
+	{
+		std::lock_guard<std::mutex> results_lock(m_results_mutex);
+		results.insert(results.end(), m_results.begin() + static_cast<std::ptrdiff_t>(m_collected_results), m_results.end());
+		m_collected_results = m_results.size();
+	}
+
+	void StreamDiscovery::Run()
+	{
+		const ROMBuffer& buffer = m_snapshot->GetROM().m_buffer;
+		const Uint32 begin = m_begin;
+		const Uint32 end = m_end;
+		if (buffer.size() == 0 || begin > end)
+		{
+			m_progress = 1.0f;
+			m_finished = true;
+			return;
+		}
+		// Nothing past the range is read, so the cached list only depends on the range.
+		const ByteSpan image{ buffer.data(), static_cast<std::size_t>(end) + 1U };
+
+		if (TakeCachedResults())
+		{
+			m_progress = 1.0f;
+			m_finished = true;
+			return;
+		}
+
+		// Workers pull chunks from a shared counter and leave their hits in the chunk's slot.
+		// Finished chunks are published from the front of the range, so results stay in
+		// offset order and the first stream to reach an end offset is the one kept.
+		struct ScanChunk
+		{
+			std::vector<DiscoveredStream> streams;
+			std::atomic<bool> done{ false };
+		};
+
+		const std::size_t scan_length = static_cast<std::size_t>(end - begin) + 1U;
+		const std::size_t num_chunks = (scan_length + s_chunk_bytes - 1U) / s_chunk_bytes;
+		std::vector<ScanChunk> chunks(num_chunks);
+		std::atomic<std::size_t> next_chunk{ 0 };
+		std::atomic<std::size_t> chunks_scanned{ 0 };
+		// Guarded by m_results_mutex.
+		std::size_t next_chunk_to_publish = 0;
+		std::set<Uint32> published_ends;
+
+		auto publish_ready_chunks = [&]()
+		{
+			std::lock_guard<std::mutex> results_lock(m_results_mutex);
+			m_progress = static_cast<float>(chunks_scanned.load()) / static_cast<float>(num_chunks);
+			while (next_chunk_to_publish < num_chunks && chunks[next_chunk_to_publish].done.load(std::memory_order_acquire))
+			{
+				for (DiscoveredStream& stream : chunks[next_chunk_to_publish].streams)
+				{
+					if (published_ends.insert(stream.rom_data.rom_offset_end).second)
+					{
+						m_results.emplace_back(std::move(stream));
+					}
+				}
+				chunks[next_chunk_to_publish].streams.clear();
+				++next_chunk_to_publish;
+			}
+		};
+
+		auto run_worker = [&]()
+		{
+			for (std::size_t chunk_index = next_chunk++; chunk_index < num_chunks; chunk_index = next_chunk++)
+			{
+				ScanChunk& chunk = chunks[chunk_index];
+				// s_chunk_bytes is even, so every chunk starts on an even offset.
+				const std::size_t chunk_begin = begin + chunk_index * s_chunk_bytes;
+				const std::size_t chunk_end = std::min<std::size_t>(chunk_begin + s_chunk_bytes - 1U, end);
+				for (std::size_t offset = chunk_begin; offset <= chunk_end; offset += 2)
+				{
+					if (m_cancelled.load(std::memory_order_relaxed))
+					{
+						return;
+					}
+
+					TryOffset(image, static_cast<Uint32>(offset), chunk.streams);
+				}
+
+				chunk.done.store(true, std::memory_order_release);
+				++chunks_scanned;
+				publish_ready_chunks();
+			}
+		};
+
+		// This thread is worker 0.
+		const std::size_t num_threads = std::min<std::size_t>(num_chunks, std::max(1u, std::thread::hardware_concurrency()));
+		std::vector<std::thread> workers;
+		workers.reserve(num_threads - 1U);
+		for (std::size_t worker = 1; worker < num_threads; ++worker)
+		{
+			workers.emplace_back(run_worker);
+		}
+		run_worker();
+		for (std::thread& worker : workers)
+		{
+			worker.join();
+		}
+
+		if (!m_cancelled.load())
+		{
+			std::vector<Uint8> payload;
+			{
+				std::lock_guard<std::mutex> results_lock(m_results_mutex);
+				payload = EncodeStreams(m_results);
+			}
+			m_asset_cache.Store(AssetCacheKey{ AssetCacheKind::StreamDiscovery, begin, end }, buffer, begin, end + 1U, std::move(payload));
+		}
+		m_progress = 1.0f;
+		m_finished = true;
+	}
+
+	void StreamDiscovery::Rescan(std::vector<DiscoveredStream> results, const std::vector<DirtyRange>& ranges)
+	{
+		const ROMBuffer& buffer = m_snapshot->GetROM().m_buffer;
+		if (buffer.size() == 0 || m_begin > m_end || TakeCachedResults())
+		{
+			m_progress = 1.0f;
+			m_finished = true;
+			return;
+		}
+		// As in the search, nothing past the range is read.
+		const ByteSpan image{ buffer.data(), static_cast<std::size_t>(m_end) + 1U };
+		// A cancelled rescan hands the list back as it came, rather than without the streams it hadn't retried yet.
+		const std::vector<DiscoveredStream> previous_results = results;
+
+		// Only a stream starting less than its longest possible length before a changed byte can reach it.
+		DirtyRangeSet ssc_offsets;
+		DirtyRangeSet compressed2_offsets;
+		auto add_window = [this](DirtyRangeSet& offsets, const DirtyRange& range, Uint32 max_stream_bytes)
+		{
+			const Uint32 window_begin = std::max(m_begin, range.begin >= max_stream_bytes ? range.begin - max_stream_bytes + 1 : 0U);
+			const Uint32 window_last = std::min(m_end, range.end - 1);
+			if (window_begin <= window_last)
+			{
+				offsets.Add(window_begin, window_last + 1);
+			}
+		};
+		for (const DirtyRange& range : ranges)
+		{
+			if (range.end > range.begin)
+			{
+				add_window(ssc_offsets, range, s_max_ssc_stream_bytes);
+				add_window(compressed2_offsets, range, s_max_compressed2_stream_bytes);
+			}
+		}
+
+		// The search kept only the first stream to reach each end offset, so a stream starting
+		// inside a dropped hit and ending with it was never recorded. Every offset a dropped hit
+		// covered is tried again too; hits starting there that no edit reaches come back as
+		// they were, so they don't widen the rescan any further.
+		auto is_retried = [&](const DiscoveredStream& stream)
+		{
+			const DirtyRangeSet& offsets = stream.algorithm == CompressionAlgorithm::SSC ? ssc_offsets : compressed2_offsets;
+			return offsets.Overlaps(stream.rom_data.rom_offset, stream.rom_data.rom_offset + 1);
+		};
+		std::vector<DirtyRange> dropped_hits;
+		for (const DiscoveredStream& stream : results)
+		{
+			if (is_retried(stream))
+			{
+				dropped_hits.emplace_back(DirtyRange{ stream.rom_data.rom_offset, std::min(stream.rom_data.rom_offset_end, m_end + 1) });
+			}
+		}
+		for (const DirtyRange& hit : dropped_hits)
+		{
+			ssc_offsets.Add(hit.begin, hit.end);
+			compressed2_offsets.Add(hit.begin, hit.end);
+		}
+		results.erase(std::remove_if(results.begin(), results.end(), is_retried), results.end());
+
+		const std::vector<DirtyRange> ssc_ranges = ssc_offsets.GetRanges();
+		const std::vector<DirtyRange> compressed2_ranges = compressed2_offsets.GetRanges();
+		const float total_bytes = static_cast<float>(ssc_offsets.TotalBytes() + compressed2_offsets.TotalBytes());
+		std::size_t bytes_tried = 0;
+		auto try_ranges = [&](const std::vector<DirtyRange>& offsets, void (*try_offset)(ByteSpan, Uint32, std::vector<DiscoveredStream>&))
+		{
+			for (const DirtyRange& range : offsets)
+			{
+				for (Uint32 offset = range.begin + (range.begin & 1U); offset < range.end; offset += 2)
+				{
+					if (m_cancelled.load(std::memory_order_relaxed))
+					{
+						return;
+					}
+					try_offset(image, offset, results);
+				}
+				bytes_tried += range.Size();
+				m_progress = static_cast<float>(bytes_tried) / total_bytes;
+			}
+		};
+		try_ranges(ssc_ranges, TrySSCOffset);
+		try_ranges(compressed2_ranges, TryCompressed2Offset);
+
+		std::stable_sort(results.begin(), results.end(), [](const DiscoveredStream& lhs, const DiscoveredStream& rhs)
+			{
+				if (lhs.rom_data.rom_offset != rhs.rom_data.rom_offset)
+				{
+					return lhs.rom_data.rom_offset < rhs.rom_data.rom_offset;
+				}
+				// At one offset the search reports SSC first.
+				return lhs.algorithm == CompressionAlgorithm::SSC && rhs.algorithm != CompressionAlgorithm::SSC;
+			});
+		std::set<Uint32> ends;
+		results.erase(
+			std::remove_if(results.begin(), results.end(), [&ends](const DiscoveredStream& stream)
+				{
+					return !ends.insert(stream.rom_data.rom_offset_end).second;
+				}),
+			results.end());
+
+		const bool cancelled = m_cancelled.load();
+		if (!cancelled)
+		{
+			m_asset_cache.Store(AssetCacheKey{ AssetCacheKind::StreamDiscovery, m_begin, m_end }, buffer, m_begin, m_end + 1U, EncodeStreams(results));
+		}
+		{
+			std::lock_guard<std::mutex> results_lock(m_results_mutex);
+			m_results = cancelled ? previous_results : std::move(results);
+		}
+		m_progress = 1.0f;
+		m_finished = true;
+	}
+}
@@ -137,12 +137,12 @@ namespace spintool::rom
 			[[nodiscard]] int Height() const { return maximum_y - minimum_y; }
 		};
 
-		bool CanRead(const std::vector<Uint8>& data, const Uint32 offset, const std::size_t count)
+		bool CanRead(ByteSpan data, const Uint32 offset, const std::size_t count)
 		{
 			return offset <= data.size() && count <= data.size() - offset;
 		}
 
-		Uint16 ReadBE16(const std::vector<Uint8>& data, const Uint32 offset)
+		Uint16 ReadBE16(ByteSpan data, const Uint32 offset)
 		{
 			return static_cast<Uint16>(
 				(static_cast<Uint16>(data[offset]) << 8U) |
@@ -150,7 +150,7 @@ namespace spintool::rom
 			);
 		}
 
-		Uint32 ReadBE32(const std::vector<Uint8>& data, const Uint32 offset)
+		Uint32 ReadBE32(ByteSpan data, const Uint32 offset)
 		{
 			return
 				(static_cast<Uint32>(data[offset]) << 24U) |
@@ -159,7 +159,7 @@ namespace spintool::rom
 				static_cast<Uint32>(data[offset + 3U]);
 		}
 
-		Sint16 ReadBE16Signed(const std::vector<Uint8>& data, const Uint32 offset)
+		Sint16 ReadBE16Signed(ByteSpan data, const Uint32 offset)
 		{
 			return static_cast<Sint16>(ReadBE16(data, offset));
 		}
@@ -180,7 +180,7 @@ namespace spintool::rom
 		}
 
 		bool ParsePieceDescriptor(
-			const std::vector<Uint8>& rom,
+			ByteSpan rom,
 			const Uint32 offset,
 			PieceDescriptor& output,
 			std::string& error
@@ -203,7 +203,7 @@ namespace spintool::rom
 		}
 
 		bool ApplyObjectTable(
-			const std::vector<Uint8>& rom,
+			ByteSpan rom,
 			const TableUse& table_use,
 			std::map<Uint8, PieceInstance>& slots,
 			std::string& error
@@ -254,7 +254,6 @@ namespace spintool::rom
 			return true;
 		}
 
-
 		struct ScriptObjectState
 		{
 			PieceInstance piece;
@@ -285,7 +284,7 @@ namespace spintool::rom
 			return static_cast<Sint16>(static_cast<Uint16>(lhs) + static_cast<Uint16>(rhs));
 		}
 
-		bool IsRawBlankDescriptor(const std::vector<Uint8>& rom, const Uint32 offset)
+		bool IsRawBlankDescriptor(ByteSpan rom, const Uint32 offset)
 		{
 			if (offset == 0U || offset == kBlankDescriptor)
 			{
@@ -303,7 +302,7 @@ namespace spintool::rom
 		}
 
 		bool ReadObjectTableEntries(
-			const std::vector<Uint8>& rom,
+			ByteSpan rom,
 			const Uint32 table_offset,
 			std::vector<ObjectTableEntry>& entries,
 			std::string& error
@@ -364,7 +363,7 @@ namespace spintool::rom
 		{
 		public:
 			BeforeDemoScriptCollector(
-				const std::vector<Uint8>& rom,
+				ByteSpan rom,
 				std::vector<FrameDefinition>& output
 			)
 				: m_rom(rom), m_output(output)
@@ -762,7 +761,7 @@ namespace spintool::rom
 				return false;
 			}
 
-			const std::vector<Uint8>& m_rom;
+			ByteSpan m_rom;
 			std::vector<FrameDefinition>& m_output;
 			std::map<Uint8, ScriptObjectState> m_slots;
 			std::vector<std::vector<PieceInstance>> m_unique_piece_layouts;
@@ -771,7 +770,7 @@ namespace spintool::rom
 		};
 
 		bool BuildBeforeDemoFrameDefinitions(
-			const std::vector<Uint8>& rom,
+			ByteSpan rom,
 			std::vector<FrameDefinition>& output,
 			std::string& error
 		)
@@ -781,7 +780,7 @@ namespace spintool::rom
 		}
 
 		bool BuildSideFrameDefinition(
-			const std::vector<Uint8>& rom,
+			ByteSpan rom,
 			const std::size_t frame_id,
 			std::string name,
 			std::string usage,
@@ -826,7 +825,7 @@ namespace spintool::rom
 		}
 
 		bool BuildFrontFrameDefinition(
-			const std::vector<Uint8>& rom,
+			ByteSpan rom,
 			const std::size_t frame_id,
 			const std::size_t propeller_frame,
 			FrameDefinition& output,
@@ -885,7 +884,7 @@ namespace spintool::rom
 		}
 
 		bool BuildAllFrameDefinitions(
-			const std::vector<Uint8>& rom,
+			ByteSpan rom,
 			std::vector<FrameDefinition>& output,
 			std::vector<std::string>& warnings
 		)
@@ -1300,26 +1299,6 @@ namespace spintool::rom
 			return image;
 		}
 
-		void UpdateMegaDriveChecksum(SpinballROM& rom)
-		{
-			if (rom.m_buffer.size() < 0x190U)
-			{
-				return;
-			}
-			Uint32 checksum = 0U;
-			for (std::size_t offset = 0x200U; offset < rom.m_buffer.size(); offset += 2U)
-			{
-				Uint16 word = static_cast<Uint16>(rom.m_buffer[offset]) << 8U;
-				if (offset + 1U < rom.m_buffer.size())
-				{
-					word = static_cast<Uint16>(word | rom.m_buffer[offset + 1U]);
-				}
-				checksum = (checksum + word) & 0xFFFFU;
-			}
-			rom.m_buffer[0x18EU] = static_cast<Uint8>((checksum >> 8U) & 0xFFU);
-			rom.m_buffer[0x18FU] = static_cast<Uint8>(checksum & 0xFFU);
-		}
-
 		bool ReadPiecePixel(
 			const PieceInstance& piece,
 			const std::vector<Uint8>& art,
@@ -1614,10 +1593,7 @@ namespace spintool::rom
 		}
 
 		const LZSSDecompressionResult decompressed =
-			LZSSDecompressor::DecompressDataRefactored(
-				rom.m_buffer,
-				kPlaneCompressedStreamOffset
-			);
+			DecompressLZSSCached(rom, kPlaneCompressedStreamOffset);
 		if (decompressed.error_msg.has_value())
 		{
 			result.error = "Could not decompress Tails plane art at 0xA3126: " +
@@ -1818,26 +1794,35 @@ namespace spintool::rom
 			return result;
 		}
 
-		const Compressed2CompressionResult compression =
-			Compressed2Optimizer::Compress(tile_art, original_stream);
-		std::vector<Uint8> verified_art;
-		std::size_t consumed_size = 0U;
-		if (!Compressed2Optimizer::Decode(
-			compression.data,
-			0U,
-			verified_art,
-			error,
-			&consumed_size,
-			nullptr
-		))
+		// Re-encoding only the segments the edit touched is enough whenever the result
+		// still fits; CompressIncremental has already validated what it spliced in.
+		std::optional<Compressed2CompressionResult> incremental =
+			Compressed2Optimizer::CompressIncremental(tile_art, original_stream);
+		const bool use_incremental = incremental.has_value() && incremental->data.size() <= capacity;
+		const Compressed2CompressionResult compression = use_incremental
+			? std::move(*incremental)
+			: Compressed2Optimizer::Compress(tile_art, original_stream);
+		if (!use_incremental)
 		{
-			result.message = "Optimized Compressed2 validation failed: " + error;
-			return result;
-		}
-		if (verified_art != tile_art || consumed_size != compression.data.size())
-		{
-			result.message = "Optimized Compressed2 validation produced different art";
-			return result;
+			std::vector<Uint8> verified_art;
+			std::size_t consumed_size = 0U;
+			if (!Compressed2Optimizer::Decode(
+				compression.data,
+				0U,
+				verified_art,
+				error,
+				&consumed_size,
+				nullptr
+			))
+			{
+				result.message = "Optimized Compressed2 validation failed: " + error;
+				return result;
+			}
+			if (verified_art != tile_art || consumed_size != compression.data.size())
+			{
+				result.message = "Optimized Compressed2 validation produced different art";
+				return result;
+			}
 		}
 
 		if (compression.data.size() > capacity)
@@ -1858,24 +1843,22 @@ namespace spintool::rom
 			return result;
 		}
 
-		std::copy(
-			compression.data.begin(),
-			compression.data.end(),
-			rom.m_buffer.begin() + definition.art_offset
-		);
-		std::fill(
-			rom.m_buffer.begin() + definition.art_offset + compression.data.size(),
-			rom.m_buffer.begin() + definition.art_offset + capacity,
-			0U
+		rom.WriteBytes(definition.art_offset, compression.data);
+		rom.FillBytes(
+			static_cast<Uint32>(definition.art_offset + compression.data.size()),
+			0U,
+			static_cast<Uint32>(capacity - compression.data.size())
 		);
-		UpdateMegaDriveChecksum(rom);
+		rom.RefreshChecksum();
 
 		result.success = true;
 		result.changed = true;
 		std::ostringstream message;
 		message << changed_pixel_count
 			<< " source pixels changed; optimized size " << compression.data.size()
-			<< "/" << capacity << " bytes; strategy " << compression.strategy;
+			<< "/" << capacity << " bytes; strategy " << compression.strategy
+			<< " (" << compression.candidates_tested << " candidates in "
+			<< static_cast<int>(compression.milliseconds) << " ms)";
 		if (compression.baseline_size > compression.data.size())
 		{
 			message << "; saved "
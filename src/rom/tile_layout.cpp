@@ -1,13 +1,36 @@
 #include "rom/tile_layout.h"
 
 #include "rom/spinball_rom.h"
+#include "rom/rom_cursor.h"
 #include "rom/tile.h"
 #include "rom/tile_brush.h"
 
+#include <algorithm>
 #include <memory>
+#include <vector>
 
 namespace spintool::rom
 {
+	namespace
+	{
+		// Decodes a validated span of big-endian tile words in one pass.
+		std::vector<Uint16> ReadTileWords(const ROMSpan& span)
+		{
+			std::vector<Uint16> words(span.Size() / 2);
+			span.ReadUint16Array(0, words.data(), words.size());
+			return words;
+		}
+
+		TileBrushInstance DecodeBrushInstance(const Uint16 word, const Uint16 index_mask)
+		{
+			TileBrushInstance instance;
+			instance.is_flipped_vertically = (0x1000 & word) != 0;
+			instance.is_flipped_horizontally = (0x0800 & word) != 0;
+			instance.tile_brush_index = word & index_mask;
+			return instance;
+		}
+	}
+
 	void TileLayout::BlitTileInstancesFromBrushInstances()
 	{
 		if (tile_brushes.empty() == false && layout_width > 0 && tile_brushes.front() != nullptr)
@@ -81,40 +104,37 @@ namespace spintool::rom
 			return nullptr;
 		}
 		new_layout->tile_brushes.resize(total_brushes);
-		size_t current_offset = brushes_offset;
 
+		const std::vector<Uint16> brush_words = ReadTileWords(src_rom.GetSpan(brushes_offset, static_cast<Uint32>(brush_range)));
+		auto next_word = std::begin(brush_words);
 		for (std::unique_ptr<TileBrush>& current_brush : new_layout->tile_brushes)
 		{
 			current_brush = std::make_unique<TileBrush>(TileBrush::s_default_brush_width, TileBrush::s_default_brush_height);
+			current_brush->tiles.reserve(current_brush->TotalTiles());
 			for (size_t i = 0; i < current_brush->TotalTiles(); ++i)
 			{
-				if (current_offset + 2 > brushes_end) return nullptr;
-				const Uint8 first_byte = src_rom.m_buffer[current_offset++];
-				const Uint8 second_byte = src_rom.m_buffer[current_offset++];
+				const Uint16 word = *next_word++;
 				TileInstance& t = current_brush->tiles.emplace_back();
-				t.is_high_priority = (0x80 & first_byte) != 0;
-				t.palette_line = ((0x40 | 0x20) & first_byte) >> 5;
-				t.is_flipped_vertically = (0x10 & first_byte) != 0;
-				t.is_flipped_horizontally = (0x08 & first_byte) != 0;
-				t.tile_index = (static_cast<Uint16>(first_byte & 0x07) << 8) | second_byte;
+				t.is_high_priority = (0x8000 & word) != 0;
+				t.palette_line = ((0x4000 | 0x2000) & word) >> 13;
+				t.is_flipped_vertically = (0x1000 & word) != 0;
+				t.is_flipped_horizontally = (0x0800 & word) != 0;
+				t.tile_index = word & 0x07FF;
 			}
 		}
 
-		for (size_t off = layout_offset; off + 1 < *layout_end; off += 2)
+		const std::vector<Uint16> layout_words = ReadTileWords(src_rom.GetSpan(layout_offset, static_cast<Uint32>(layout_range)));
+		new_layout->tile_brush_instances.reserve(layout_words.size());
+		for (const Uint16 word : layout_words)
 		{
-			const Uint8 first_byte = src_rom.m_buffer[off];
-			const Uint8 second_byte = src_rom.m_buffer[off + 1];
-			TileBrushInstance instance;
-			instance.is_flipped_vertically = (0x10 & first_byte) != 0;
-			instance.is_flipped_horizontally = (0x08 & first_byte) != 0;
-			instance.tile_brush_index = (static_cast<Uint16>(first_byte & 0x03) << 8) | second_byte;
-			new_layout->tile_brush_instances.emplace_back(instance);
+			new_layout->tile_brush_instances.emplace_back(DecodeBrushInstance(word, 0x03FF));
 		}
 
 		new_layout->layout_width = static_cast<int>(layout_width);
 		new_layout->layout_height = static_cast<int>(new_layout->tile_brush_instances.size() / layout_width);
 		new_layout->BlitTileInstancesFromBrushInstances();
 		new_layout->rom_data.SetROMData(layout_offset, *layout_end);
+		src_rom.GetAssetIndex().Register(ROMAssetType::TileLayout, new_layout->rom_data);
 		return new_layout;
 	}
 
@@ -151,16 +171,12 @@ namespace spintool::rom
 
 		new_layout->layout_width = width;
 		new_layout->layout_height = height;
-		for (size_t off = layout_offset + 4; off + 1 < end_address; off += 2)
+		const std::vector<Uint16> layout_words = ReadTileWords(src_rom.GetSpan(layout_offset + 4, static_cast<Uint32>(end_address - (layout_offset + 4))));
+		new_layout->tile_brush_instances.reserve(layout_words.size());
+		for (const Uint16 word : layout_words)
 		{
-			const Uint8 first_byte = src_rom.m_buffer[off];
-			const Uint8 second_byte = src_rom.m_buffer[off + 1];
-			TileBrushInstance instance;
-			instance.palette_line = ((0x40 | 0x20) & first_byte) >> 5;
-			instance.is_flipped_vertically = (0x10 & first_byte) != 0;
-			instance.is_flipped_horizontally = (0x08 & first_byte) != 0;
-			instance.tile_brush_index = (static_cast<Uint16>(first_byte & 0x07) << 8) | second_byte;
-			new_layout->tile_brush_instances.emplace_back(instance);
+			TileBrushInstance& instance = new_layout->tile_brush_instances.emplace_back(DecodeBrushInstance(word, 0x07FF));
+			instance.palette_line = ((0x4000 | 0x2000) & word) >> 13;
 		}
 
 		const size_t max_instances = static_cast<size_t>(width) * height;
@@ -168,6 +184,7 @@ namespace spintool::rom
 			new_layout->tile_brush_instances.resize(max_instances);
 		new_layout->BlitTileInstancesFromBrushInstances();
 		new_layout->rom_data.SetROMData(layout_offset, static_cast<Uint32>(end_address));
+		src_rom.GetAssetIndex().Register(ROMAssetType::TileLayout, new_layout->rom_data);
 		return new_layout;
 	}
 
@@ -197,23 +214,40 @@ namespace spintool::rom
 
 		new_layout->layout_width = static_cast<int>(layout_width);
 		new_layout->layout_height = static_cast<int>(layout_height);
-		for (size_t off = layout_offset; off + 1 < layout_end; off += 2)
+		const std::vector<Uint16> layout_words = ReadTileWords(src_rom.GetSpan(layout_offset, layout_end - layout_offset));
+		new_layout->tile_brush_instances.reserve(layout_words.size());
+		for (const Uint16 word : layout_words)
 		{
-			const Uint8 first_byte = src_rom.m_buffer[off];
-			const Uint8 second_byte = src_rom.m_buffer[off + 1];
-			TileBrushInstance instance;
-			instance.palette_line = ((0x40 | 0x20) & first_byte) >> 5;
-			instance.is_flipped_vertically = (0x10 & first_byte) != 0;
-			instance.is_flipped_horizontally = (0x08 & first_byte) != 0;
-			instance.tile_brush_index = (static_cast<Uint16>(first_byte & 0x07) << 8) | second_byte;
-			new_layout->tile_brush_instances.emplace_back(instance);
+			TileBrushInstance& instance = new_layout->tile_brush_instances.emplace_back(DecodeBrushInstance(word, 0x07FF));
+			instance.palette_line = ((0x4000 | 0x2000) & word) >> 13;
 		}
 
 		new_layout->BlitTileInstancesFromBrushInstances();
 		new_layout->rom_data.SetROMData(layout_offset, layout_end);
+		src_rom.GetAssetIndex().Register(ROMAssetType::TileLayout, new_layout->rom_data);
 		return new_layout;
 	}
 
+	void TileLayout::RemapTileIndices(const std::vector<Uint32>& old_to_new)
+	{
+		auto remap = [&old_to_new](rom::TileInstance& tile)
+			{
+				if (tile.tile_index >= 0 && static_cast<size_t>(tile.tile_index) < old_to_new.size())
+				{
+					tile.tile_index = static_cast<int>(old_to_new[static_cast<size_t>(tile.tile_index)]);
+				}
+			};
+
+		for (const std::unique_ptr<TileBrush>& brush : tile_brushes)
+		{
+			if (brush != nullptr)
+			{
+				std::for_each(brush->tiles.begin(), brush->tiles.end(), remap);
+			}
+		}
+		std::for_each(tile_instances.begin(), tile_instances.end(), remap);
+	}
+
 	void TileLayout::CollapseTilesIntoBrushes(const rom::TileSet& tile_set)
 	{
 		if (layout_width <= 0 || tile_instances.empty()) return;
@@ -337,11 +371,17 @@ namespace spintool::rom
 
 	void TileLayout::SaveToROM(SpinballROM& src_rom, const rom::TileSet& tile_set, Uint32 brushes_offset, Uint32 layout_offset)
 	{
-		Uint32 current_offset = brushes_offset;
-
 		CollapseTilesIntoBrushes(tile_set);
+		SaveBrushesToROM(src_rom, brushes_offset);
+		SaveLayoutToROM(src_rom, layout_offset);
+	}
 
-		for (std::unique_ptr<TileBrush>& current_brush : tile_brushes)
+	Ptr32 TileLayout::SaveBrushesToROM(SpinballROM& src_rom, Uint32 brushes_offset) const
+	{
+		ROMWriter writer{ brushes_offset };
+		writer.Reserve(GetBrushesSizeOnROM());
+
+		for (const std::unique_ptr<TileBrush>& current_brush : tile_brushes)
 		{
 			for (const TileInstance& tile : current_brush->tiles)
 			{
@@ -355,14 +395,19 @@ namespace spintool::rom
 				first_byte |= tile.is_flipped_horizontally ? 0x08 : 0x00;
 				first_byte |= ((tile.tile_index) & static_cast<Uint16>((0x0100 | 0x0200 | 0x0400))) >> 8;
 
-				current_offset = src_rom.WriteUint8(current_offset, first_byte);
-				current_offset = src_rom.WriteUint8(current_offset, tile.tile_index & 0x00FF);
-
+				writer.WriteUint8(first_byte);
+				writer.WriteUint8(tile.tile_index & 0x00FF);
 			}
 		}
 
-		current_offset = layout_offset;
-		for (TileBrushInstance& brush_instance : tile_brush_instances)
+		return writer.Commit(src_rom);
+	}
+
+	Ptr32 TileLayout::SaveLayoutToROM(SpinballROM& src_rom, Uint32 layout_offset) const
+	{
+		ROMWriter writer{ layout_offset };
+		writer.Reserve(tile_brush_instances.size() * sizeof(Uint16));
+		for (const TileBrushInstance& brush_instance : tile_brush_instances)
 		{
 			//brush_instance.is_high_priority = (0x80 & first_byte) != 0;
 			Uint8 first_byte = 0;
@@ -372,9 +417,33 @@ namespace spintool::rom
 			first_byte |= brush_instance.is_flipped_horizontally ? 0x08 : 0x00;
 			first_byte |= ((brush_instance.tile_brush_index) & static_cast<Uint16>((0x0100 | 0x0200 | 0x0400))) >> 8;
 
-			current_offset = src_rom.WriteUint8(current_offset, first_byte);
-			current_offset = src_rom.WriteUint8(current_offset, brush_instance.tile_brush_index & 0x00FF);
+			writer.WriteUint8(first_byte);
+			writer.WriteUint8(brush_instance.tile_brush_index & 0x00FF);
+		}
+
+		return writer.Commit(src_rom);
+	}
+
+	Uint32 TileLayout::GetBrushesSizeOnROM() const
+	{
+		return static_cast<Uint32>(tile_brushes.size()) * TileBrush::s_default_total_tiles * sizeof(Uint16);
+	}
+
+	Uint32 TileLayout::CountReferencedBrushes(const SpinballROM& src_rom, Uint32 layout_offset, Uint32 layout_size)
+	{
+		const ROMSpan layout = src_rom.GetSpan(layout_offset, layout_size);
+		if (!layout.IsValid())
+		{
+			return 0;
+		}
+
+		Uint16 highest_brush_index = 0;
+		for (Uint32 offset = 0; offset + 1 < layout_size; offset += sizeof(Uint16))
+		{
+			const Uint16 brush_index = layout.Uint16At(offset) & 0x03FF;
+			highest_brush_index = std::max(highest_brush_index, brush_index);
 		}
+		return static_cast<Uint32>(highest_brush_index) + 1;
 	}
 
 	size_t TileLayout::GridCoordinatesToLinearIndex(Point grid_coord) const
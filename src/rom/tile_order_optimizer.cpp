@@ -0,0 +1,265 @@
+#include "rom/tile_order_optimizer.h"
+
+#include "rom/compressed2_optimizer.h"
+#include "rom/ssc_compressor.h"
+#include "rom/tileset.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <numeric>
+
+namespace spintool::rom
+{
+	namespace
+	{
+		constexpr std::size_t kTileBytes = TileSet::s_tile_total_bytes;
+		constexpr std::size_t kRowsPerTile = TileSet::s_tile_height;
+		constexpr std::size_t kRowBytes = kTileBytes / kRowsPerTile;
+
+		// One 8-pixel row is four bytes, the smallest unit that repeats between tiles often
+		// enough to matter. Rows are kept sorted and unique so two tiles compare in one merge.
+		struct TileRows
+		{
+			std::array<Uint32, kRowsPerTile> rows{};
+			std::size_t count = 0;
+		};
+
+		std::vector<TileRows> CollectRows(const std::vector<Uint8>& tile_data, std::size_t num_tiles)
+		{
+			std::vector<TileRows> tile_rows(num_tiles);
+			for (std::size_t tile = 0; tile < num_tiles; ++tile)
+			{
+				TileRows& entry = tile_rows[tile];
+				for (std::size_t row = 0; row < kRowsPerTile; ++row)
+				{
+					std::memcpy(&entry.rows[row], tile_data.data() + tile * kTileBytes + row * kRowBytes, kRowBytes);
+				}
+				std::sort(entry.rows.begin(), entry.rows.end());
+				entry.count = static_cast<std::size_t>(std::unique(entry.rows.begin(), entry.rows.end()) - entry.rows.begin());
+			}
+			return tile_rows;
+		}
+
+		// Rows the two tiles have in common. Symmetric, so scores can be compared either way round.
+		int Similarity(const TileRows& lhs, const TileRows& rhs)
+		{
+			int shared = 0;
+			std::size_t left = 0;
+			std::size_t right = 0;
+			while (left < lhs.count && right < rhs.count)
+			{
+				if (lhs.rows[left] < rhs.rows[right])
+				{
+					++left;
+				}
+				else if (rhs.rows[right] < lhs.rows[left])
+				{
+					++right;
+				}
+				else
+				{
+					++shared;
+					++left;
+					++right;
+				}
+			}
+			return shared;
+		}
+
+		// Starts after the pinned tiles and always moves to the unplaced tile sharing the most
+		// rows with the last one placed. Ties, including tiles sharing nothing at all, go to the
+		// lowest original index, so unrelated tiles keep their original order.
+		std::vector<Uint32> OrderGreedily(const std::vector<TileRows>& tile_rows, Uint32 num_pinned_tiles)
+		{
+			const std::size_t num_tiles = tile_rows.size();
+			std::vector<Uint32> order(num_pinned_tiles);
+			std::iota(order.begin(), order.end(), 0U);
+			order.reserve(num_tiles);
+
+			std::vector<Uint32> unplaced(num_tiles - num_pinned_tiles);
+			std::iota(unplaced.begin(), unplaced.end(), num_pinned_tiles);
+			while (!unplaced.empty())
+			{
+				std::size_t best = 0;
+				if (!order.empty())
+				{
+					const TileRows& previous = tile_rows[order.back()];
+					int best_score = -1;
+					for (std::size_t candidate = 0; candidate < unplaced.size(); ++candidate)
+					{
+						const int score = Similarity(previous, tile_rows[unplaced[candidate]]);
+						if (score > best_score)
+						{
+							best_score = score;
+							best = candidate;
+							if (score == static_cast<int>(previous.count))
+							{
+								break;
+							}
+						}
+					}
+				}
+				order.emplace_back(unplaced[best]);
+				// Erasing keeps the remaining tiles in index order for the tie-break.
+				unplaced.erase(unplaced.begin() + static_cast<std::ptrdiff_t>(best));
+			}
+			return order;
+		}
+
+		// The s_neighbour_count movable tiles sharing the most rows with each tile, best first.
+		std::vector<std::vector<Uint32>> CollectNeighbours(const std::vector<TileRows>& tile_rows, Uint32 num_pinned_tiles)
+		{
+			const std::size_t num_tiles = tile_rows.size();
+			std::vector<std::vector<Uint32>> neighbours(num_tiles);
+			std::vector<std::pair<int, Uint32>> scored;
+			for (std::size_t tile = 0; tile < num_tiles; ++tile)
+			{
+				scored.clear();
+				for (Uint32 other = num_pinned_tiles; other < num_tiles; ++other)
+				{
+					const int score = other != tile ? Similarity(tile_rows[tile], tile_rows[other]) : 0;
+					if (score > 0)
+					{
+						scored.emplace_back(-score, other);
+					}
+				}
+				const std::size_t keep = std::min(scored.size(), TileOrderOptimizer::s_neighbour_count);
+				std::partial_sort(scored.begin(), scored.begin() + static_cast<std::ptrdiff_t>(keep), scored.end());
+				for (std::size_t i = 0; i < keep; ++i)
+				{
+					neighbours[tile].emplace_back(scored[i].second);
+				}
+			}
+			return neighbours;
+		}
+
+		// 2-opt on the open path of movable tiles: reversing order[i..j] makes order[i - 1]
+		// and order[j] neighbours, which pays off whenever it adds more shared rows between
+		// adjacent tiles than it removes. Only reversals that bring one of a tile's closest
+		// neighbours next to it are tried.
+		void RefineOrder(const std::vector<TileRows>& tile_rows, Uint32 num_pinned_tiles, std::vector<Uint32>& order)
+		{
+			const std::size_t num_tiles = order.size();
+			const std::vector<std::vector<Uint32>> neighbours = CollectNeighbours(tile_rows, num_pinned_tiles);
+			std::vector<std::size_t> position(num_tiles);
+			for (std::size_t i = 0; i < num_tiles; ++i)
+			{
+				position[order[i]] = i;
+			}
+
+			auto similarity = [&tile_rows](Uint32 lhs, Uint32 rhs) { return Similarity(tile_rows[lhs], tile_rows[rhs]); };
+			// The first movable tile stays put when nothing is pinned ahead of it.
+			const std::size_t first = std::max<std::size_t>(num_pinned_tiles, 1);
+			for (int pass = 0; pass < TileOrderOptimizer::s_max_refinement_passes; ++pass)
+			{
+				bool improved = false;
+				for (std::size_t i = first; i < num_tiles; ++i)
+				{
+					const Uint32 previous = order[i - 1];
+					for (const Uint32 candidate : neighbours[previous])
+					{
+						const std::size_t j = position[candidate];
+						if (j <= i)
+						{
+							continue;
+						}
+						const Uint32 current = order[i];
+						const bool has_next = j + 1 < num_tiles;
+						const int gain = similarity(previous, candidate) - similarity(previous, current)
+							+ (has_next ? similarity(current, order[j + 1]) - similarity(candidate, order[j + 1]) : 0);
+						if (gain <= 0)
+						{
+							continue;
+						}
+						std::reverse(order.begin() + static_cast<std::ptrdiff_t>(i), order.begin() + static_cast<std::ptrdiff_t>(j) + 1);
+						for (std::size_t k = i; k <= j; ++k)
+						{
+							position[order[k]] = k;
+						}
+						improved = true;
+						break;
+					}
+				}
+				if (!improved)
+				{
+					break;
+				}
+			}
+		}
+	}
+
+	bool TileOrder::IsIdentity() const
+	{
+		for (std::size_t i = 0; i < new_to_old.size(); ++i)
+		{
+			if (new_to_old[i] != i)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	std::vector<Uint8> TileOrderOptimizer::ApplyOrder(const std::vector<Uint8>& tile_data, const std::vector<Uint32>& new_to_old)
+	{
+		std::vector<Uint8> reordered(tile_data);
+		for (std::size_t tile = 0; tile < new_to_old.size(); ++tile)
+		{
+			std::memcpy(reordered.data() + tile * kTileBytes, tile_data.data() + static_cast<std::size_t>(new_to_old[tile]) * kTileBytes, kTileBytes);
+		}
+		return reordered;
+	}
+
+	std::size_t TileOrderOptimizer::MeasureCompressedSize(const std::vector<Uint8>& tile_data, CompressionAlgorithm compression_algorithm)
+	{
+		switch (compression_algorithm)
+		{
+			case CompressionAlgorithm::SSC:
+				return SSCCompressor::CompressData(tile_data).size();
+
+			case CompressionAlgorithm::LZSS:
+				return Compressed2Optimizer::Compress(tile_data).data.size();
+
+			case CompressionAlgorithm::NONE:
+			default:
+				return tile_data.size();
+		}
+	}
+
+	TileOrder TileOrderOptimizer::Optimise(const std::vector<Uint8>& tile_data, CompressionAlgorithm compression_algorithm, Uint32 num_pinned_tiles)
+	{
+		const std::size_t num_tiles = tile_data.size() / kTileBytes;
+		TileOrder result;
+		result.new_to_old.resize(num_tiles);
+		std::iota(result.new_to_old.begin(), result.new_to_old.end(), 0U);
+		result.original_size = MeasureCompressedSize(tile_data, compression_algorithm);
+		result.optimised_size = result.original_size;
+		num_pinned_tiles = static_cast<Uint32>(std::min<std::size_t>(num_pinned_tiles, num_tiles));
+
+		if (num_tiles - num_pinned_tiles >= 2)
+		{
+			const std::vector<TileRows> tile_rows = CollectRows(tile_data, num_tiles);
+			std::vector<Uint32> greedy = OrderGreedily(tile_rows, num_pinned_tiles);
+			std::vector<Uint32> refined = greedy;
+			RefineOrder(tile_rows, num_pinned_tiles, refined);
+
+			for (std::vector<Uint32>* candidate : { &greedy, &refined })
+			{
+				const std::size_t size = MeasureCompressedSize(ApplyOrder(tile_data, *candidate), compression_algorithm);
+				if (size < result.optimised_size)
+				{
+					result.optimised_size = size;
+					result.new_to_old = *candidate;
+				}
+			}
+		}
+
+		result.old_to_new.resize(num_tiles);
+		for (std::size_t i = 0; i < num_tiles; ++i)
+		{
+			result.old_to_new[result.new_to_old[i]] = static_cast<Uint32>(i);
+		}
+		return result;
+	}
+}
@@ -4,9 +4,12 @@
 #include "rom/spinball_rom.h"
 #include "rom/ssc_decompressor.h"
 #include "rom/lzss_decompressor.h"
+#include "rom/compressed2_decoder.h"
 #include "rom/tile.h"
 #include "rom/ssc_compressor.h"
 
+#include <algorithm>
+
 namespace spintool::rom
 {
 	TilesetEntry TileSet::LoadFromROM(const SpinballROM& src_rom, Uint32 rom_offset, CompressionAlgorithm compression_algorithm)
@@ -27,15 +30,18 @@ namespace spintool::rom
 
 	Ptr32 TileSet::SaveToROM_SSCCompression(SpinballROM& src_rom, Uint32 rom_offset) const
 	{
-		Ptr32 current_offset = rom_offset;
-		current_offset = src_rom.WriteUint16(current_offset, num_tiles);
-		const SSCCompressionResult compressed_data = rom::SSCCompressor::CompressData(uncompressed_data, 0, num_tiles * 64);
-		for (size_t i = 0; i < compressed_data.size(); ++i)
-		{
-			current_offset = src_rom.WriteUint8(current_offset, compressed_data.at(i));
-		}
+		return src_rom.WriteBytes(rom_offset, EncodeSSCCompression());
+	}
 
-		return current_offset;
+	std::vector<Uint8> TileSet::EncodeSSCCompression(SSCCompressionStats* stats) const
+	{
+		const SSCCompressionResult compressed_data = rom::SSCCompressor::CompressData(uncompressed_data, {}, stats);
+		std::vector<Uint8> encoded;
+		encoded.reserve(compressed_data.size() + 2);
+		encoded.emplace_back(static_cast<Uint8>(num_tiles >> 8));
+		encoded.emplace_back(static_cast<Uint8>(num_tiles & 0xFF));
+		encoded.insert(encoded.end(), compressed_data.begin(), compressed_data.end());
+		return encoded;
 	}
 
 	TilesetEntry TileSet::LoadFromROM_SSCCompression(const SpinballROM& src_rom, Uint32 rom_offset)
@@ -63,8 +69,8 @@ namespace spintool::rom
 			return { std::move(new_tileset), results };
 		}
 
-		SSCDecompressionResult results = rom::SSCDecompressor::DecompressData(
-			src_rom.m_buffer, rom_offset + 2,
+		SSCDecompressionResult results = rom::DecompressSSCCached(
+			src_rom, rom_offset + 2,
 			static_cast<Uint32>(new_tileset->num_tiles) * s_tile_total_bytes);
 		if (results.error_msg.has_value())
 		{
@@ -130,6 +136,7 @@ namespace spintool::rom
 		}
 
 		new_tileset->rom_data.SetROMData(results.rom_data.rom_offset - 2, results.rom_data.rom_offset_end);
+		src_rom.GetAssetIndex().Register(ROMAssetType::Tileset, new_tileset->rom_data);
 
 		return { std::move(new_tileset), results };
 	}
@@ -148,10 +155,9 @@ namespace spintool::rom
 			return { std::move(new_tileset), results };
 		}
 
-		// Use the portable implementation. The legacy implementation treats
-		// original Mega Drive RAM/ROM addresses as std::vector indices.
-		LZSSDecompressionResult results =
-			rom::LZSSDecompressor::DecompressDataRefactored(src_rom.m_buffer, rom_offset);
+		// Decoded by Compressed2Decoder. The 68k port treats original Mega Drive
+		// RAM/ROM addresses as std::vector indices.
+		LZSSDecompressionResult results = rom::DecompressLZSSCached(src_rom, rom_offset);
 
 		if (results.error_msg.has_value())
 		{
@@ -196,6 +202,7 @@ namespace spintool::rom
 		}
 
 		new_tileset->rom_data.SetROMData(results.rom_data.rom_offset, results.rom_data.rom_offset_end);
+		src_rom.GetAssetIndex().Register(ROMAssetType::Tileset, new_tileset->rom_data);
 
 
 		return { std::move(new_tileset), results };
@@ -359,4 +366,158 @@ namespace spintool::rom
 		return out_surface;
 	}
 
+	std::unique_ptr<TileSet> TileSet::CreateReordered(const std::vector<Uint32>& new_to_old) const
+	{
+		auto reordered = std::make_unique<TileSet>();
+		reordered->rom_data = rom_data;
+		reordered->compressed_size = compressed_size;
+		reordered->uncompressed_size = uncompressed_size;
+		reordered->num_tiles = num_tiles;
+		reordered->uncompressed_data = uncompressed_data;
+		reordered->tiles.reserve(tiles.size());
+
+		for (size_t new_index = 0; new_index < tiles.size(); ++new_index)
+		{
+			const size_t old_index = new_index < new_to_old.size() && new_to_old[new_index] < tiles.size() ? new_to_old[new_index] : new_index;
+			const rom::Tile& old_tile = tiles[old_index];
+			rom::Tile& new_tile = reordered->tiles.emplace_back();
+			new_tile.pixel_data = old_tile.pixel_data;
+			new_tile.tile_index = old_tile.tile_index;
+			new_tile.is_x_symmetrical = old_tile.is_x_symmetrical;
+			new_tile.is_y_symmetrical = old_tile.is_y_symmetrical;
+
+			const size_t new_offset = new_index * s_tile_total_bytes;
+			const size_t old_offset = old_index * s_tile_total_bytes;
+			if (new_offset + s_tile_total_bytes <= uncompressed_data.size() && old_offset + s_tile_total_bytes <= uncompressed_data.size())
+			{
+				std::copy_n(uncompressed_data.begin() + old_offset, s_tile_total_bytes, reordered->uncompressed_data.begin() + new_offset);
+			}
+		}
+
+		return reordered;
+	}
+
+	TileSetStreamDecoder::TileSetStreamDecoder(const SpinballROM& src_rom, Uint32 rom_offset, CompressionAlgorithm compression_algorithm)
+		: m_rom_offset(rom_offset)
+	{
+		const ByteSpan rom_buffer = src_rom.m_buffer;
+		switch (compression_algorithm)
+		{
+			case CompressionAlgorithm::SSC:
+			{
+				// Same header checks and size hint as LoadFromROM_SSCCompression.
+				if (rom_offset > rom_buffer.size() || rom_buffer.size() - rom_offset < 2)
+				{
+					m_error_msg = "SSC tileset header is outside the ROM";
+					return;
+				}
+				const Uint16 num_tiles = static_cast<Uint16>((static_cast<Uint16>(rom_buffer[rom_offset]) << 8) | static_cast<Uint16>(rom_buffer[rom_offset + 1]));
+				if (num_tiles == 0 || num_tiles > 0x1000)
+				{
+					m_error_msg = "Invalid SSC tile count";
+					return;
+				}
+				m_total_tiles = num_tiles;
+				m_ssc_decoder = std::make_unique<SSCStreamDecoder>(rom_buffer, rom_offset + 2, static_cast<Uint32>(num_tiles) * TileSet::s_tile_total_bytes);
+				return;
+			}
+
+			case CompressionAlgorithm::LZSS:
+				m_compressed2_decoder = std::make_unique<Compressed2StreamDecoder>(rom_buffer, rom_offset);
+				return;
+
+			case CompressionAlgorithm::NONE:
+			default:
+				m_error_msg = "Tileset is not compressed";
+				return;
+		}
+	}
+
+	TileSetStreamDecoder::~TileSetStreamDecoder() = default;
+
+	bool TileSetStreamDecoder::DecodeTiles(Uint32 num_tiles)
+	{
+		const std::size_t output_size = static_cast<std::size_t>(num_tiles) * TileSet::s_tile_total_bytes;
+		if (m_ssc_decoder)
+		{
+			return m_ssc_decoder->DecodeUntil(output_size);
+		}
+		if (m_compressed2_decoder)
+		{
+			return m_compressed2_decoder->DecodeUntil(output_size);
+		}
+		return false;
+	}
+
+	ByteSpan TileSetStreamDecoder::GetOutput() const
+	{
+		if (m_ssc_decoder)
+		{
+			return m_ssc_decoder->GetOutput();
+		}
+		if (m_compressed2_decoder)
+		{
+			return m_compressed2_decoder->GetOutput();
+		}
+		return {};
+	}
+
+	Uint32 TileSetStreamDecoder::GetDecodedTileCount() const
+	{
+		// Groups and dictionary strings can run past the tile count in the header; the
+		// loaders ignore those bytes, so the preview does too.
+		const Uint32 decoded_tiles = static_cast<Uint32>(GetOutput().size() / TileSet::s_tile_total_bytes);
+		return m_total_tiles.has_value() ? std::min(decoded_tiles, *m_total_tiles) : decoded_tiles;
+	}
+
+	std::optional<Uint32> TileSetStreamDecoder::GetTotalTileCount() const
+	{
+		if (m_total_tiles.has_value())
+		{
+			return m_total_tiles;
+		}
+		if (IsFinished() && !GetError().has_value())
+		{
+			return GetDecodedTileCount();
+		}
+		return std::nullopt;
+	}
+
+	bool TileSetStreamDecoder::IsFinished() const
+	{
+		if (m_ssc_decoder)
+		{
+			return m_ssc_decoder->IsFinished();
+		}
+		if (m_compressed2_decoder)
+		{
+			return m_compressed2_decoder->IsFinished();
+		}
+		return true;
+	}
+
+	std::optional<std::string> TileSetStreamDecoder::GetError() const
+	{
+		if (m_ssc_decoder)
+		{
+			return m_ssc_decoder->GetError();
+		}
+		if (m_compressed2_decoder)
+		{
+			return m_compressed2_decoder->GetError();
+		}
+		return m_error_msg;
+	}
+
+	std::unique_ptr<TileSet> TileSetStreamDecoder::MakePartialTileSet() const
+	{
+		auto tileset = std::make_unique<TileSet>();
+		const Uint32 decoded_tiles = std::min<Uint32>(GetDecodedTileCount(), 0xFFFF);
+		const ByteSpan output = GetOutput();
+		tileset->num_tiles = static_cast<Uint16>(decoded_tiles);
+		tileset->uncompressed_data.assign(output.begin(), output.begin() + static_cast<std::size_t>(decoded_tiles) * TileSet::s_tile_total_bytes);
+		tileset->uncompressed_size = static_cast<Uint32>(tileset->uncompressed_data.size());
+		tileset->rom_data.SetROMData(m_rom_offset, m_rom_offset);
+		return tileset;
+	}
 }
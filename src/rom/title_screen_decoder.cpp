@@ -87,7 +87,6 @@ namespace spintool::rom
 			Uint32 art_offset = kTitleCompressedStreamOffset;
 		};
 
-
 		struct ObjectTableEntry
 		{
 			Uint8 slot = 0;
@@ -118,12 +117,12 @@ namespace spintool::rom
 			}
 		};
 
-		bool CanRead(const std::vector<Uint8>& data, const Uint32 offset, const std::size_t count)
+		bool CanRead(ByteSpan data, const Uint32 offset, const std::size_t count)
 		{
 			return offset <= data.size() && count <= data.size() - offset;
 		}
 
-		Uint16 ReadBE16(const std::vector<Uint8>& data, const Uint32 offset)
+		Uint16 ReadBE16(ByteSpan data, const Uint32 offset)
 		{
 			return static_cast<Uint16>(
 				(static_cast<Uint16>(data[offset]) << 8U) |
@@ -131,7 +130,7 @@ namespace spintool::rom
 			);
 		}
 
-		Uint32 ReadBE32(const std::vector<Uint8>& data, const Uint32 offset)
+		Uint32 ReadBE32(ByteSpan data, const Uint32 offset)
 		{
 			return
 				(static_cast<Uint32>(data[offset]) << 24U) |
@@ -140,7 +139,7 @@ namespace spintool::rom
 				static_cast<Uint32>(data[offset + 3U]);
 		}
 
-		Sint16 ReadBE16Signed(const std::vector<Uint8>& data, const Uint32 offset)
+		Sint16 ReadBE16Signed(ByteSpan data, const Uint32 offset)
 		{
 			return static_cast<Sint16>(ReadBE16(data, offset));
 		}
@@ -171,7 +170,7 @@ namespace spintool::rom
 		}
 
 		bool ParsePieceDescriptor(
-			const std::vector<Uint8>& rom,
+			ByteSpan rom,
 			const Uint32 offset,
 			PieceDescriptor& output,
 			std::string& error
@@ -193,7 +192,7 @@ namespace spintool::rom
 			return true;
 		}
 
-		bool IsRawBlankDescriptor(const std::vector<Uint8>& rom, const Uint32 offset)
+		bool IsRawBlankDescriptor(ByteSpan rom, const Uint32 offset)
 		{
 			if (offset == 0U || offset == kBlankDescriptor)
 			{
@@ -211,7 +210,7 @@ namespace spintool::rom
 		}
 
 		bool ReadObjectTableEntries(
-			const std::vector<Uint8>& rom,
+			ByteSpan rom,
 			const Uint32 table_offset,
 			std::vector<ObjectTableEntry>& entries,
 			std::string& error
@@ -246,7 +245,7 @@ namespace spintool::rom
 		}
 
 		bool AppendObjectTableFrame(
-			const std::vector<Uint8>& rom,
+			ByteSpan rom,
 			const Uint32 table_offset,
 			const TitleScreenCategory category,
 			std::string name,
@@ -304,7 +303,7 @@ namespace spintool::rom
 		}
 
 		bool AppendTileLayoutFrame(
-			const std::vector<Uint8>& rom,
+			ByteSpan rom,
 			const Uint32 layout_offset,
 			const TitleScreenCategory category,
 			std::string name,
@@ -390,7 +389,7 @@ namespace spintool::rom
 		}
 
 		bool BuildFrameDefinitions(
-			const std::vector<Uint8>& rom,
+			ByteSpan rom,
 			std::vector<FrameDefinition>& output,
 			std::string& error
 		)
@@ -772,23 +771,6 @@ namespace spintool::rom
 			return palette_lines;
 		}
 
-		void UpdateMegaDriveChecksum(SpinballROM& rom)
-		{
-			if (rom.m_buffer.size() < 0x190U) return;
-			Uint32 checksum = 0U;
-			for (std::size_t offset = 0x200U; offset < rom.m_buffer.size(); offset += 2U)
-			{
-				Uint16 word = static_cast<Uint16>(rom.m_buffer[offset]) << 8U;
-				if (offset + 1U < rom.m_buffer.size())
-				{
-					word = static_cast<Uint16>(word | rom.m_buffer[offset + 1U]);
-				}
-				checksum = (checksum + word) & 0xFFFFU;
-			}
-			rom.m_buffer[0x18EU] = static_cast<Uint8>((checksum >> 8U) & 0xFFU);
-			rom.m_buffer[0x18FU] = static_cast<Uint8>(checksum & 0xFFU);
-		}
-
 		bool ReadPiecePixel(
 			const PieceInstance& piece,
 			const std::vector<Uint8>& art,
@@ -983,13 +965,11 @@ namespace spintool::rom
 
 		std::vector<Uint8> art;
 		std::string error;
-		if (!Compressed2Optimizer::Decode(
-			rom.m_buffer,
+		if (!DecodeCompressed2Cached(
+			rom,
 			kTitleCompressedStreamOffset,
 			art,
-			error,
-			nullptr,
-			nullptr
+			error
 		))
 		{
 			result.error = "Could not decompress title-screen art at 0x9D104: " + error;
@@ -1199,26 +1179,35 @@ namespace spintool::rom
 			return result;
 		}
 
-		const Compressed2CompressionResult compression =
-			Compressed2Optimizer::Compress(tile_art, original_stream);
-		std::vector<Uint8> verified_art;
-		std::size_t consumed_size = 0U;
-		if (!Compressed2Optimizer::Decode(
-			compression.data,
-			0U,
-			verified_art,
-			error,
-			&consumed_size,
-			nullptr
-		))
-		{
-			result.message = "Optimized Compressed2 validation failed: " + error;
-			return result;
-		}
-		if (verified_art != tile_art || consumed_size != compression.data.size())
+		// Re-encoding only the segments the edit touched is enough whenever the result
+		// still fits; CompressIncremental has already validated what it spliced in.
+		std::optional<Compressed2CompressionResult> incremental =
+			Compressed2Optimizer::CompressIncremental(tile_art, original_stream);
+		const bool use_incremental = incremental.has_value() && incremental->data.size() <= capacity;
+		const Compressed2CompressionResult compression = use_incremental
+			? std::move(*incremental)
+			: Compressed2Optimizer::Compress(tile_art, original_stream);
+		if (!use_incremental)
 		{
-			result.message = "Optimized Compressed2 validation produced different title art";
-			return result;
+			std::vector<Uint8> verified_art;
+			std::size_t consumed_size = 0U;
+			if (!Compressed2Optimizer::Decode(
+				compression.data,
+				0U,
+				verified_art,
+				error,
+				&consumed_size,
+				nullptr
+			))
+			{
+				result.message = "Optimized Compressed2 validation failed: " + error;
+				return result;
+			}
+			if (verified_art != tile_art || consumed_size != compression.data.size())
+			{
+				result.message = "Optimized Compressed2 validation produced different title art";
+				return result;
+			}
 		}
 		if (compression.data.size() > capacity)
 		{
@@ -1237,23 +1226,22 @@ namespace spintool::rom
 			return result;
 		}
 
-		std::copy(
-			compression.data.begin(), compression.data.end(),
-			rom.m_buffer.begin() + kTitleCompressedStreamOffset
-		);
-		std::fill(
-			rom.m_buffer.begin() + kTitleCompressedStreamOffset + compression.data.size(),
-			rom.m_buffer.begin() + kTitleCompressedStreamOffset + capacity,
-			0U
+		rom.WriteBytes(kTitleCompressedStreamOffset, compression.data);
+		rom.FillBytes(
+			static_cast<Uint32>(kTitleCompressedStreamOffset + compression.data.size()),
+			0U,
+			static_cast<Uint32>(capacity - compression.data.size())
 		);
-		UpdateMegaDriveChecksum(rom);
+		rom.RefreshChecksum();
 
 		result.success = true;
 		result.changed = true;
 		std::ostringstream message;
 		message << changed_pixel_count
 			<< " source pixels changed; optimized size " << compression.data.size()
-			<< "/" << capacity << " bytes; strategy " << compression.strategy;
+			<< "/" << capacity << " bytes; strategy " << compression.strategy
+			<< " (" << compression.candidates_tested << " candidates in "
+			<< static_cast<int>(compression.milliseconds) << " ms)";
 		if (compression.baseline_size > compression.data.size())
 		{
 			message << "; saved "
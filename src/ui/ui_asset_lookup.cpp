@@ -0,0 +1,144 @@
+#include "ui/ui_asset_lookup.h"
+
+#include "ui/ui_editor.h"
+#include "rom/sprite.h"
+
+#include "imgui.h"
+
+#include <cstdio>
+
+namespace spintool
+{
+	void EditorAssetLookup::RunQuery()
+	{
+		const rom::ROMAssetIndex& index = m_owning_ui.GetROM().GetAssetIndex();
+		m_results = index.FindAt(m_offset);
+		m_references = m_owning_ui.GetROM().GetPointerIndex().FindReferencesTo(m_offset);
+
+		char status[128];
+		std::snprintf(
+			status,
+			sizeof(status),
+			"%zu asset(s) at 0x%06X (%zu indexed), %zu longword(s) pointing at it",
+			m_results.size(),
+			m_offset,
+			index.Size(),
+			m_references.size()
+		);
+		m_status = status;
+	}
+
+	void EditorAssetLookup::Update()
+	{
+		if (m_visible == false)
+		{
+			return;
+		}
+
+		if (ImGui::Begin("Find Asset at Offset", &m_visible))
+		{
+			ImGui::TextDisabled("Only assets decoded since the ROM was loaded are known.");
+
+			ImGui::TextUnformatted("Offset :");
+			ImGui::SameLine();
+			ImGui::TextUnformatted("0x");
+			ImGui::SameLine(0.0f, 2.0f);
+			ImGui::SetNextItemWidth(160.0f);
+			const bool submitted = ImGui::InputScalar(
+				"##asset_lookup_offset",
+				ImGuiDataType_U32,
+				&m_offset,
+				nullptr,
+				nullptr,
+				"%06X",
+				ImGuiInputTextFlags_CharsHexadecimal | ImGuiInputTextFlags_EnterReturnsTrue
+			);
+			ImGui::SameLine();
+			if (ImGui::Button("Find") || submitted)
+			{
+				RunQuery();
+			}
+
+			if (!m_status.empty())
+			{
+				ImGui::TextUnformatted(m_status.c_str());
+			}
+			ImGui::Separator();
+
+			if (ImGui::BeginTable("asset_lookup_results", 3, ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV))
+			{
+				ImGui::TableSetupColumn("Type");
+				ImGui::TableSetupColumn("Range");
+				ImGui::TableSetupColumn("##action", ImGuiTableColumnFlags_WidthFixed);
+				ImGui::TableHeadersRow();
+
+				for (std::size_t i = 0; i < m_results.size(); ++i)
+				{
+					const rom::ROMAssetRef& result = m_results[i];
+					ImGui::PushID(static_cast<int>(i));
+					ImGui::TableNextRow();
+					ImGui::TableNextColumn();
+					ImGui::TextUnformatted(rom::GetAssetTypeName(result.type));
+					ImGui::TableNextColumn();
+					ImGui::Text(
+						"0x%06X - 0x%06X (%u bytes)",
+						result.rom_data.rom_offset,
+						result.rom_data.rom_offset_end,
+						result.rom_data.real_size
+					);
+					ImGui::TableNextColumn();
+					if (result.type == rom::ROMAssetType::Sprite)
+					{
+						if (ImGui::SmallButton("Open"))
+						{
+							std::shared_ptr<const rom::Sprite> sprite =
+								rom::Sprite::LoadFromROM(m_owning_ui.GetROM(), result.rom_data.rom_offset);
+							if (sprite)
+							{
+								m_owning_ui.OpenSpriteViewer(sprite);
+							}
+						}
+					}
+					else if (ImGui::SmallButton("Copy offset"))
+					{
+						char offset_text[16];
+						std::snprintf(offset_text, sizeof(offset_text), "0x%06X", result.rom_data.rom_offset);
+						ImGui::SetClipboardText(offset_text);
+					}
+					ImGui::PopID();
+				}
+				ImGui::EndTable();
+			}
+
+			if (!m_references.empty() && ImGui::TreeNode("References"))
+			{
+				ImGui::TextDisabled("Any longword holding the offset, so data can turn up here too.");
+				for (std::size_t i = 0; i < m_references.size(); ++i)
+				{
+					const Uint32 source = m_references[i];
+					ImGui::PushID(static_cast<int>(i));
+					if (ImGui::SmallButton("Go"))
+					{
+						m_offset = source;
+						RunQuery();
+						ImGui::PopID();
+						break;
+					}
+					ImGui::SameLine();
+					const std::vector<rom::ROMAssetRef> owners = m_owning_ui.GetROM().GetAssetIndex().FindAt(source);
+					if (owners.empty())
+					{
+						ImGui::Text("0x%06X", source);
+					}
+					else
+					{
+						ImGui::Text("0x%06X (in %s at 0x%06X)", source, rom::GetAssetTypeName(owners.front().type), owners.front().rom_data.rom_offset);
+					}
+					ImGui::PopID();
+				}
+				ImGui::TreePop();
+			}
+		}
+		ImGui::End();
+	}
+}
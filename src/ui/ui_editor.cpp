@@ -76,6 +76,7 @@ namespace spintool
 		, m_animation_navigator(*this)
 		, m_palette_viewer(*this)
 		, m_sprite_importer(*this)
+		, m_asset_lookup(*this)
 	{
 		LoadROMConfig();
 		LoadUIConfig();
@@ -87,11 +88,17 @@ namespace spintool
 			Serialiser::OpenFile(s_config_path, "roms.json");
 		nlohmann::json& config_json_writer = serialiser->Writer();
 
+		nlohmann::json hashes = nlohmann::json::object();
 		for (const rom::ROMMetadata& metadata : m_metadata.rom_metadatas)
 		{
 			config_json_writer[metadata.version_id] =
 				metadata.location_on_disk.string();
+			if (metadata.content_hash)
+			{
+				hashes[metadata.version_id] = metadata.content_hash->ToString();
+			}
 		}
+		config_json_writer["hashes"] = hashes;
 	}
 
 	void EditorUI::LoadROMConfig()
@@ -137,6 +144,21 @@ namespace spintool
 			return;
 		}
 
+		// Hashes first, so the ROMs loaded below are matched against them.
+		if (const auto hashes = config_json_reader.find("hashes");
+			hashes != config_json_reader.end() && hashes->is_object())
+		{
+			for (auto& rom_metadata : m_metadata.rom_metadatas)
+			{
+				const auto hash = hashes->find(rom_metadata.version_id);
+				if (hash != hashes->end() && hash->is_string())
+				{
+					rom_metadata.content_hash =
+						rom::ROMHash::FromString(hash->get<std::string>());
+				}
+			}
+		}
+
 		for (auto& rom_metadata : m_metadata.rom_metadatas)
 		{
 			if (rom_metadata.version_id.empty())
@@ -192,6 +214,8 @@ namespace spintool
 			nlohmann::json& writer = serialiser->Writer();
 			writer["font_scale_percent"] =
 				static_cast<int>(m_font_scale * 100.0f + 0.5f);
+			writer["expanded_rom_size"] = m_rom.m_free_space_settings.expanded_size;
+			writer["save_in_place"] = m_rom.GetSaveStrategy() == rom::ROMSaveStrategy::PatchInPlace;
 		}
 		catch (const std::exception& error)
 		{
@@ -221,6 +245,23 @@ namespace spintool
 							std::clamp(entry->get<int>(), 50, 250);
 						m_font_scale = static_cast<float>(percent) / 100.0f;
 					}
+
+					auto expanded_size = reader.find("expanded_rom_size");
+					if (expanded_size != reader.end() && expanded_size->is_number_unsigned())
+					{
+						m_rom.m_free_space_settings.expanded_size = std::min(
+							expanded_size->get<Uint32>(),
+							rom::FreeSpaceSettings::s_max_expanded_size
+						);
+					}
+
+					auto save_in_place = reader.find("save_in_place");
+					if (save_in_place != reader.end() && save_in_place->is_boolean())
+					{
+						m_rom.SetSaveStrategy(save_in_place->get<bool>()
+							? rom::ROMSaveStrategy::PatchInPlace
+							: rom::ROMSaveStrategy::AtomicCopy);
+					}
 				}
 			}
 			catch (const std::exception& error)
@@ -282,6 +323,21 @@ namespace spintool
 			return false;
 		}
 
+		// Identify the ROM by content rather than by filename. The reference is
+		// mapped, so hashing reads it straight from the page cache.
+		rom::ROMBuffer reference_image;
+		if (!reference_image.MapFile(reference_path))
+		{
+			std::cerr << "Could not read reference ROM: "
+				<< reference_path << '\n';
+			return false;
+		}
+		const ByteSpan reference_bytes{ reference_image.data(), reference_image.size() };
+		const auto hash_start = std::chrono::steady_clock::now();
+		const rom::ROMHash reference_hash = rom::ComputeROMHash(reference_bytes);
+		const std::chrono::duration<double, std::milli> hash_time =
+			std::chrono::steady_clock::now() - hash_start;
+
 		const std::filesystem::path working_path =
 			s_rom_export_path / reference_path.filename();
 
@@ -319,7 +375,11 @@ namespace spintool
 				<< working_path << '\n';
 		}
 
-		if (!m_rom.LoadROMFromPath(working_path))
+		const bool working_rom_loaded = m_rom.LoadROMFromPath(working_path);
+		// The image was replaced even if it failed to load, so nothing decoded from the old one is valid.
+		m_sprite_navigator.NotifyROMLoaded();
+		m_tileset_navigator.NotifyROMLoaded();
+		if (!working_rom_loaded)
 		{
 			std::cerr << "Could not open working ROM: "
 				<< working_path << '\n';
@@ -328,15 +388,24 @@ namespace spintool
 
 		m_reference_rom_path = reference_path;
 		m_working_rom_path = working_path;
+		m_reference_rom_hash = reference_hash;
 
-		m_current_rom_metadata = m_metadata.GetROMMetadataFor("usa");
+		m_current_rom_metadata = m_metadata.IdentifyROM(reference_bytes, reference_hash);
 		if (m_current_rom_metadata)
 		{
+			std::cout << "Identified ROM " << reference_hash.ToString()
+				<< " as " << m_current_rom_metadata->version_id
+				<< " (hashed in " << hash_time.count() << " ms)\n";
+
 			// Keep the immutable file in config. At the next launch,
 			// AttemptLoadROM() reopens the matching rom_export copy.
 			m_current_rom_metadata->location_on_disk = reference_path;
 		}
 
+		// Entries validate themselves against the bytes they came from, so the
+		// reference hash only has to tell different games apart.
+		m_rom.GetAssetCache().Open(s_projects_path / "cache", reference_hash);
+
 		m_palettes = m_rom.LoadPalettes(48);
 
 		std::cout << "Reference ROM: " << m_reference_rom_path << '\n';
@@ -346,11 +415,18 @@ namespace spintool
 
 	void EditorUI::Initialise()
 	{
-		m_current_rom_metadata = m_metadata.GetROMMetadataFor("usa");
-		if (m_current_rom_metadata &&
-			!m_current_rom_metadata->location_on_disk.empty())
+		// Reopen the first configured ROM; which version it is comes from its contents.
+		const auto configured_it = std::find_if(
+			std::begin(m_metadata.rom_metadatas),
+			std::end(m_metadata.rom_metadatas),
+			[](const rom::ROMMetadata& metadata)
+			{
+				return !metadata.location_on_disk.empty();
+			}
+		);
+		if (configured_it != std::end(m_metadata.rom_metadatas))
 		{
-			AttemptLoadROM(m_current_rom_metadata->location_on_disk);
+			AttemptLoadROM(configured_it->location_on_disk);
 		}
 	}
 
@@ -359,6 +435,23 @@ namespace spintool
 		float menu_bar_height = 0;
 		bool open_rom_popup = false;
 
+		if (IsROMLoaded() && !ImGui::GetIO().WantTextInput && ImGui::IsKeyDown(ImGuiKey_ModCtrl))
+		{
+			if (ImGui::IsKeyPressed(ImGuiKey_Y, false) ||
+				(ImGui::IsKeyDown(ImGuiKey_ModShift) && ImGui::IsKeyPressed(ImGuiKey_Z, false)))
+			{
+				RedoROMEdit();
+			}
+			else if (ImGui::IsKeyPressed(ImGuiKey_Z, false))
+			{
+				UndoROMEdit();
+			}
+		}
+
+		// Imports, level saves, undo and redo all land here, so every view refreshes what it
+		// decoded from the bytes that changed since the last frame, whoever wrote them.
+		DispatchROMChanges();
+
 		if (ImGui::BeginMainMenuBar())
 		{
 			if (IsROMLoaded())
@@ -391,6 +484,32 @@ namespace spintool
 					ImGui::EndMenu();
 				}*/
 
+				if (ImGui::BeginMenu("Edit"))
+				{
+					const rom::ROMJournal& journal = m_rom.GetJournal();
+					const std::string undo_label = journal.CanUndo()
+						? "Undo " + journal.GetUndoName()
+						: std::string{ "Undo" };
+					const std::string redo_label = journal.CanRedo()
+						? "Redo " + journal.GetRedoName()
+						: std::string{ "Redo" };
+					if (ImGui::MenuItem(undo_label.c_str(), "Ctrl+Z", false, journal.CanUndo()))
+					{
+						UndoROMEdit();
+					}
+					if (ImGui::MenuItem(redo_label.c_str(), "Ctrl+Y", false, journal.CanRedo()))
+					{
+						RedoROMEdit();
+					}
+					ImGui::Separator();
+					ImGui::TextDisabled(
+						"History: %zu step(s), %.1f KB",
+						journal.GetNumUndoSteps(),
+						static_cast<float>(journal.GetMemoryUsage()) / 1024.0f
+					);
+					ImGui::EndMenu();
+				}
+
 				if (ImGui::BeginMenu("Tools"))
 				{
 					ImGui::MenuItem(
@@ -418,6 +537,11 @@ namespace spintool
 						nullptr,
 						&m_palette_viewer.m_visible
 					);
+					ImGui::MenuItem(
+						"Find Asset at Offset",
+						nullptr,
+						&m_asset_lookup.m_visible
+					);
 					/*ImGui::Separator();
 					ImGui::MenuItem(
 						"Sprite Importer",
@@ -459,6 +583,45 @@ namespace spintool
 					ImGui::GetIO().FontGlobalScale = m_font_scale;
 					SaveUIConfig();
 				}
+
+				ImGui::Separator();
+				ImGui::TextUnformatted("Grow ROM up to");
+				ImGui::SetNextItemWidth(180.0f);
+				int expanded_mb = static_cast<int>(m_rom.m_free_space_settings.expanded_size / 0x100000);
+				if (ImGui::SliderInt(
+					"##expanded_rom_size",
+					&expanded_mb,
+					1,
+					static_cast<int>(rom::FreeSpaceSettings::s_max_expanded_size / 0x100000),
+					"%d MB",
+					ImGuiSliderFlags_AlwaysClamp
+				))
+				{
+					m_rom.m_free_space_settings.expanded_size =
+						static_cast<Uint32>(expanded_mb) * 0x100000;
+				}
+				if (ImGui::IsItemDeactivatedAfterEdit())
+				{
+					SaveUIConfig();
+				}
+				if (ImGui::IsItemHovered())
+				{
+					ImGui::SetTooltip("Assets that outgrow their original space are moved to the padding at the end of the ROM or past it, up to this size.");
+				}
+
+				ImGui::Separator();
+				bool save_in_place = m_rom.GetSaveStrategy() == rom::ROMSaveStrategy::PatchInPlace;
+				if (ImGui::MenuItem("Save in place", nullptr, &save_in_place))
+				{
+					m_rom.SetSaveStrategy(save_in_place
+						? rom::ROMSaveStrategy::PatchInPlace
+						: rom::ROMSaveStrategy::AtomicCopy);
+					SaveUIConfig();
+				}
+				if (ImGui::IsItemHovered())
+				{
+					ImGui::SetTooltip("Write edits straight into the ROM file instead of a copy that replaces it. Faster for large ROMs, but a crash mid-save can leave the file half written.");
+				}
 				ImGui::EndMenu();
 			}
 			ImGui::SameLine();
@@ -484,6 +647,42 @@ namespace spintool
 				open_rom_popup = true;
 			}
 
+			if (IsROMLoaded())
+			{
+				const rom::DirtyRangeSet& dirty_ranges = m_rom.GetDirtyRanges();
+				const rom::ROMSaveStats& save_stats = m_rom.GetLastSaveStats();
+				ImGui::SameLine();
+				ImGui::BeginDisabled();
+				ImGui::Text(
+					"Unsaved: %zu bytes | Last save: %zu bytes, %.2f ms",
+					dirty_ranges.TotalBytes(),
+					save_stats.bytes_written,
+					save_stats.milliseconds
+				);
+				ImGui::EndDisabled();
+				if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled) && ImGui::BeginTooltip())
+				{
+					ImGui::Text(
+						"Last save: %s, %zu range(s), %zu bytes copied",
+						save_stats.incremental ? "incremental" : "full image",
+						save_stats.ranges_written,
+						save_stats.bytes_copied
+					);
+					ImGui::Separator();
+					constexpr size_t max_listed_ranges = 16;
+					const std::vector<rom::DirtyRange> ranges = dirty_ranges.GetRanges();
+					for (size_t i = 0; i < ranges.size() && i < max_listed_ranges; ++i)
+					{
+						ImGui::Text("0x%06X - 0x%06X (%u bytes)", ranges[i].begin, ranges[i].end, ranges[i].Size());
+					}
+					if (ranges.size() > max_listed_ranges)
+					{
+						ImGui::Text("... and %zu more", ranges.size() - max_listed_ranges);
+					}
+					ImGui::EndTooltip();
+				}
+			}
+
 			static std::array<double, 32> rolling_frame_times{};
 			static size_t current_frame = 0;
 			static std::chrono::time_point previous_poll_time =
@@ -584,9 +783,14 @@ namespace spintool
 		m_sprite_importer.Update();
 		m_sprite_navigator.Update();
 		m_tileset_navigator.Update();
+		// The layout viewer already holds whatever it writes itself, so split its writes off
+		// from everyone else's; reloading the level for them would drop its unsaved edits.
+		DispatchROMChanges();
 		m_tile_layout_viewer.Update();
+		DispatchROMChanges(&m_tile_layout_viewer);
 		m_animation_navigator.Update();
 		m_palette_viewer.Update();
+		m_asset_lookup.Update();
 
 		for (std::unique_ptr<EditorSpriteViewer>& sprite_window :
 			m_sprite_viewer_windows)
@@ -617,6 +821,7 @@ namespace spintool
 		m_tileset_navigator.Shutdown();
 		m_sprite_navigator.Shutdown();
 		m_sprite_importer.Shutdown();
+		m_rom.GetAssetCache().Flush();
 	}
 
 	bool EditorUI::IsROMLoaded() const
@@ -669,6 +874,11 @@ namespace spintool
 		return m_working_rom_path;
 	}
 
+	const std::optional<rom::ROMHash>& EditorUI::GetReferenceROMHash() const
+	{
+		return m_reference_rom_hash;
+	}
+
 	const std::vector<TilesetEntry>& EditorUI::GetTilesets() const
 	{
 		return m_tileset_navigator.m_tilesets;
@@ -692,6 +902,71 @@ namespace spintool
 		}
 	}
 
+	void EditorUI::DispatchROMChanges(const EditorWindowBase* writer)
+	{
+		if (IsROMLoaded())
+		{
+			const std::vector<rom::DirtyRange> changed_ranges = m_rom.TakeChangedRanges();
+			if (!changed_ranges.empty())
+			{
+				NotifyROMChanged(changed_ranges, writer);
+			}
+		}
+	}
+
+	void EditorUI::NotifyROMChanged(const std::vector<rom::DirtyRange>& ranges, const EditorWindowBase* writer)
+	{
+		// Forget what was decoded from these bytes; the reloads below register it again.
+		rom::ROMAssetIndex& asset_index = m_rom.GetAssetIndex();
+		for (const rom::DirtyRange& range : ranges)
+		{
+			asset_index.Invalidate(range.begin, range.end);
+		}
+
+		bool palettes_changed = false;
+		for (std::vector<std::shared_ptr<rom::Palette>>* palettes : { &m_palettes, &m_rom.m_palettes })
+		{
+			for (std::shared_ptr<rom::Palette>& palette : *palettes)
+			{
+				if (palette && rom::RangesOverlap(ranges, palette->offset, palette->offset + rom::Palette::s_palette_size_on_rom))
+				{
+					palette->palette_swatches = rom::Palette::LoadFromROM(m_rom, palette->offset)->palette_swatches;
+					palettes_changed = true;
+				}
+			}
+		}
+
+		if (palettes_changed)
+		{
+			NotifyPaletteChanged();
+		}
+
+		m_sprite_navigator.NotifyROMChanged(ranges);
+		m_tileset_navigator.NotifyROMChanged(ranges);
+		if (writer != &m_tile_layout_viewer)
+		{
+			m_tile_layout_viewer.NotifyROMChanged(ranges);
+		}
+	}
+
+	void EditorUI::UndoROMEdit()
+	{
+		// Undo touches only the journalled bytes; persist them like any other edit. The views
+		// hear about the change with every other write at the start of the next frame.
+		if (!m_rom.Undo().empty())
+		{
+			m_rom.SaveROM();
+		}
+	}
+
+	void EditorUI::RedoROMEdit()
+	{
+		if (!m_rom.Redo().empty())
+		{
+			m_rom.SaveROM();
+		}
+	}
+
 	void EditorUI::OpenSpriteViewer(
 		std::shared_ptr<const rom::Sprite>& sprite
 	)
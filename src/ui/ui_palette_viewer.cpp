@@ -10,7 +10,6 @@
 #include <fstream>
 #include <vector>
 
-
 namespace spintool
 {
 	namespace
@@ -601,30 +600,6 @@ namespace spintool
 			return true;
 		}
 
-		void UpdateMegaDriveChecksum(rom::SpinballROM& rom)
-		{
-			if (rom.m_buffer.size() < 0x190U)
-			{
-				return;
-			}
-
-			Uint32 checksum = 0U;
-			for (std::size_t offset = 0x200U;
-				offset < rom.m_buffer.size();
-				offset += 2U)
-			{
-				Uint16 word = static_cast<Uint16>(rom.m_buffer[offset]) << 8U;
-				if (offset + 1U < rom.m_buffer.size())
-				{
-					word = static_cast<Uint16>(word | rom.m_buffer[offset + 1U]);
-				}
-				checksum = (checksum + word) & 0xFFFFU;
-			}
-
-			rom.m_buffer[0x18EU] = static_cast<Uint8>((checksum >> 8U) & 0xFFU);
-			rom.m_buffer[0x18FU] = static_cast<Uint8>(checksum & 0xFFU);
-		}
-
 		bool VerifyWorkingROMWrite(
 			const std::filesystem::path& path,
 			const Uint32 colour_offset,
@@ -842,6 +817,7 @@ namespace spintool
 				}
 				else
 				{
+					rom::ROMTransaction transaction{ working_rom, "Change palette colour" };
 					const Uint16 previous_packed = working_rom.ReadUint16(swatch_rom_offset);
 					const Uint16 previous_checksum = working_rom.ReadUint16(0x18EU);
 
@@ -849,7 +825,7 @@ namespace spintool
 						swatch_rom_offset,
 						g_colour_editor.pending_packed
 					);
-					UpdateMegaDriveChecksum(working_rom);
+					working_rom.RefreshChecksum();
 
 					// Save explicitly to the ROM copy managed by EditorUI. This avoids
 					// silently writing to a stale path if the ROM object was reloaded.
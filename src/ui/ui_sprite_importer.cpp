@@ -440,16 +440,17 @@ namespace spintool
 
 				const BoundingBox bounds = result_sprite->GetBoundingBox();
 				rom::SpinballROM& rom = m_owning_ui.GetROM();
-				Uint8* current_byte = &rom.m_buffer[target_write_location];
-				current_byte += 2; // tiles
-				current_byte += 2; // vdp tiles
+				rom::ROMTransaction transaction{ rom, "Overwrite sprite pixels" };
+				Uint32 current_offset = static_cast<Uint32>(target_write_location);
+				current_offset += 2; // tiles
+				current_offset += 2; // vdp tiles
 
 				for (const std::shared_ptr<rom::SpriteTile>& sprite_tile : result_sprite->sprite_tiles)
 				{
-					current_byte += 2; // xoffset
-					current_byte += 2; // yoffset
+					current_offset += 2; // xoffset
+					current_offset += 2; // yoffset
 
-					current_byte += 2; // ysize, xsize
+					current_offset += 2; // ysize, xsize
 				}
 
 				for (const std::shared_ptr<rom::SpriteTile>& sprite_tile : result_sprite->sprite_tiles)
@@ -475,7 +476,7 @@ namespace spintool
 							{
 								pixel_source_idx = (y_off * m_preview_image->pitch) + (m_preview_image->pitch * (pixels_written / sprite_tile->x_size)) + x_off;
 							}
-							*current_byte = ((static_cast<Uint8*>(m_preview_image->pixels)[pixel_source_idx] & 0x0F) << 4);
+							Uint8 packed_pixels = ((static_cast<Uint8*>(m_preview_image->pixels)[pixel_source_idx] & 0x0F) << 4);
 							++pixel_source_idx;
 							++pixels_written;
 
@@ -483,11 +484,11 @@ namespace spintool
 							{
 								pixel_source_idx = (y_off * m_preview_image->pitch) + (m_preview_image->pitch * (pixels_written / sprite_tile->x_size)) + x_off;
 							}
-							*current_byte = *current_byte | static_cast<Uint8*>(m_preview_image->pixels)[pixel_source_idx] & 0x0F;
+							packed_pixels = packed_pixels | static_cast<Uint8*>(m_preview_image->pixels)[pixel_source_idx] & 0x0F;
 							++pixel_source_idx;
 							++pixels_written;
 
-							++current_byte;
+							current_offset = rom.WriteUint8(current_offset, packed_pixels);
 						}
 					}
 				}
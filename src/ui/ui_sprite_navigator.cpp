@@ -1,6 +1,8 @@
 #include "ui/ui_sprite_navigator.h"
 
 #include "rom/spinball_rom.h"
+#include "rom/rom_snapshot.h"
+#include "rom/sprite_header_filter.h"
 #include "rom/bonus_stage_decoder.h"
 #include "rom/tails_plane_decoder.h"
 #include "rom/title_screen_decoder.h"
@@ -33,6 +35,9 @@
 
 namespace
 {
+	// Bytes of the "Find All" range a scan worker takes at a time.
+	constexpr size_t kSpriteScanChunkBytes = 0x1000;
+
 	std::string PathToUtf8(const std::filesystem::path& path)
 	{
 #if defined(__cpp_lib_char8_t)
@@ -498,28 +503,6 @@ namespace
 		}
 		return "title";
 	}
-
-	void UpdateMegaDriveChecksum(spintool::rom::SpinballROM& rom)
-	{
-		if (rom.m_buffer.size() < 0x190U)
-		{
-			return;
-		}
-
-		Uint32 checksum = 0;
-		for (std::size_t offset = 0x200U; offset < rom.m_buffer.size(); offset += 2U)
-		{
-			Uint16 word = static_cast<Uint16>(rom.m_buffer[offset]) << 8U;
-			if (offset + 1U < rom.m_buffer.size())
-			{
-				word = static_cast<Uint16>(word | rom.m_buffer[offset + 1U]);
-			}
-			checksum = (checksum + word) & 0xFFFFU;
-		}
-
-		rom.m_buffer[0x18EU] = static_cast<Uint8>((checksum >> 8U) & 0xFFU);
-		rom.m_buffer[0x18FU] = static_cast<Uint8>(checksum & 0xFFU);
-	}
 }
 
 namespace spintool
@@ -647,7 +630,6 @@ namespace spintool
 			m_bonus_stage_status = "The working ROM has no file path and cannot be saved.";
 			return;
 		}
-		const std::vector<Uint8> original_rom_buffer = rom.m_buffer;
 
 		const std::filesystem::path reference_rom_path =
 			m_owning_ui.GetReferenceROMPath();
@@ -666,6 +648,7 @@ namespace spintool
 			return;
 		}
 
+		rom::ROMTransaction transaction{ rom, "Import PNG into Bonus Stage image " + std::to_string(image_index) };
 		const rom::BonusStageImportResult import_result =
 			rom::BonusStageDecoder::ImportIndexedImage(
 				rom,
@@ -679,6 +662,7 @@ namespace spintool
 			);
 		if (!import_result.success)
 		{
+			transaction.Rollback();
 			m_bonus_stage_status = "Import failed: " + import_result.message;
 			return;
 		}
@@ -702,7 +686,7 @@ namespace spintool
 		}
 		if (backup_error)
 		{
-			rom.m_buffer = original_rom_buffer;
+			transaction.Rollback();
 			m_bonus_stage_status = "Could not create ROM backup: " +
 				backup_error.message();
 			return;
@@ -732,14 +716,6 @@ namespace spintool
 			return;
 		}
 
-		if (!rom.LoadROMFromPath(saved_rom_path))
-		{
-			m_bonus_stage_status =
-				"The ROM was written and verified, but SpinTool could not reload it: " +
-				PathToUtf8(saved_rom_path);
-			return;
-		}
-
 		LoadBonusStageImages();
 
 		std::error_code absolute_path_error;
@@ -875,7 +851,6 @@ namespace spintool
 			m_tails_plane_status = "The working ROM has no file path and cannot be saved.";
 			return;
 		}
-		const std::vector<Uint8> original_rom_buffer = working_rom.m_buffer;
 		const std::filesystem::path reference_rom_path =
 			m_owning_ui.GetReferenceROMPath();
 		if (reference_rom_path.empty())
@@ -893,6 +868,7 @@ namespace spintool
 			return;
 		}
 
+		rom::ROMTransaction transaction{ working_rom, "Import PNG into Tails plane frame " + std::to_string(image_index) };
 		const rom::TailsPlaneImportResult import_result =
 			rom::TailsPlaneDecoder::ImportIndexedImage(
 				working_rom,
@@ -904,6 +880,7 @@ namespace spintool
 			);
 		if (!import_result.success)
 		{
+			transaction.Rollback();
 			m_tails_plane_status = "Import failed: " + import_result.message;
 			return;
 		}
@@ -927,7 +904,7 @@ namespace spintool
 		}
 		if (backup_error)
 		{
-			working_rom.m_buffer = original_rom_buffer;
+			transaction.Rollback();
 			m_tails_plane_status = "Could not create ROM backup: " +
 				backup_error.message();
 			return;
@@ -953,14 +930,6 @@ namespace spintool
 				PathToUtf8(saved_rom_path);
 			return;
 		}
-		if (!working_rom.LoadROMFromPath(saved_rom_path))
-		{
-			m_tails_plane_status =
-				"The ROM was written and verified, but SpinTool could not reload it: " +
-				PathToUtf8(saved_rom_path);
-			return;
-		}
-
 		LoadTailsPlaneImages();
 		m_tails_plane_status = import_result.message;
 	}
@@ -1157,7 +1126,6 @@ namespace spintool
 			m_title_screen_status = "The working ROM has no file path and cannot be saved.";
 			return;
 		}
-		const std::vector<Uint8> original_rom_buffer = working_rom.m_buffer;
 		const std::filesystem::path reference_rom_path =
 			m_owning_ui.GetReferenceROMPath();
 		if (reference_rom_path.empty())
@@ -1175,6 +1143,7 @@ namespace spintool
 			return;
 		}
 
+		rom::ROMTransaction transaction{ working_rom, "Import PNG into title screen image " + std::to_string(image_index) };
 		const rom::TitleScreenImportResult import_result =
 			rom::TitleScreenDecoder::ImportIndexedImage(
 				working_rom,
@@ -1186,6 +1155,7 @@ namespace spintool
 			);
 		if (!import_result.success)
 		{
+			transaction.Rollback();
 			m_title_screen_status = "Import failed: " + import_result.message;
 			return;
 		}
@@ -1209,7 +1179,7 @@ namespace spintool
 		}
 		if (backup_error)
 		{
-			working_rom.m_buffer = original_rom_buffer;
+			transaction.Rollback();
 			m_title_screen_status = "Could not create ROM backup: " +
 				backup_error.message();
 			return;
@@ -1235,14 +1205,6 @@ namespace spintool
 				PathToUtf8(saved_rom_path);
 			return;
 		}
-		if (!working_rom.LoadROMFromPath(saved_rom_path))
-		{
-			m_title_screen_status =
-				"The ROM was written and verified, but SpinTool could not reload it: " +
-				PathToUtf8(saved_rom_path);
-			return;
-		}
-
 		LoadTitleScreenImages();
 		m_title_screen_status = import_result.message;
 	}
@@ -1430,6 +1392,7 @@ namespace spintool
 			}
 		}
 
+		rom::ROMTransaction transaction{ rom, "Import PNG into Main Sprite" };
 		std::size_t write_cursor = write_begin;
 		for (const auto& sprite_tile : target_sprite->sprite_tiles)
 		{
@@ -1470,14 +1433,15 @@ namespace spintool
 				{
 					const Uint8 left = read_palette_index(x, y);
 					const Uint8 right = read_palette_index(x + 1, y);
-					rom.m_buffer[write_cursor++] = static_cast<Uint8>(
-						(left << 4U) | right
+					rom.WriteUint8(
+						static_cast<Uint32>(write_cursor++),
+						static_cast<Uint8>((left << 4U) | right)
 					);
 				}
 			}
 		}
 
-		UpdateMegaDriveChecksum(rom);
+		rom.RefreshChecksum();
 
 		const std::filesystem::path saved_rom_path = rom.m_filepath;
 		if (saved_rom_path.empty())
@@ -1509,14 +1473,6 @@ namespace spintool
 			return;
 		}
 
-		if (!rom.LoadROMFromPath(saved_rom_path))
-		{
-			m_main_sprite_status =
-				"The ROM was written and verified, but SpinTool could not reload it: " +
-				PathToUtf8(saved_rom_path);
-			return;
-		}
-
 		std::shared_ptr<const rom::Sprite> refreshed_sprite =
 			rom::Sprite::LoadFromROM(rom, sprite_rom_offset);
 		if (!refreshed_sprite)
@@ -1569,6 +1525,179 @@ namespace spintool
 	}
 
 
+	void EditorSpriteNavigator::NotifyROMChanged(const std::vector<rom::DirtyRange>& ranges)
+	{
+		switch (m_result_display_mode)
+		{
+			case ResultDisplayMode::BONUS_OBJECT_FRAMES:
+				if (!m_bonus_stage_images.empty())
+				{
+					LoadBonusStageImages();
+				}
+				break;
+			case ResultDisplayMode::TAILS_PLANE_FRAMES:
+				if (!m_tails_plane_images.empty())
+				{
+					LoadTailsPlaneImages();
+				}
+				break;
+			case ResultDisplayMode::TITLE_SCREEN_FRAMES:
+				if (!m_title_screen_images.empty())
+				{
+					LoadTitleScreenImages();
+				}
+				break;
+			case ResultDisplayMode::MAIN_SPRITES:
+			default:
+				break;
+		}
+
+		// A finished scan is kept live by rescanning around the edits. One still running reads
+		// an older snapshot, so its edits wait until its results are in.
+		if (m_main_scan_pending)
+		{
+			for (const rom::DirtyRange& range : ranges)
+			{
+				m_edits_during_scan.Add(range.begin, range.end);
+			}
+			return;
+		}
+		if (m_main_scan_complete)
+		{
+			RescanSpriteRanges(ranges);
+			return;
+		}
+
+		// Re-read any main sprite whose header or pixels changed; drop it if it no longer parses.
+		for (std::shared_ptr<UISpriteTexture>& sprite : m_sprites_found)
+		{
+			if (!sprite || !sprite->sprite ||
+				!rom::RangesOverlap(ranges, sprite->sprite->rom_data.rom_offset, sprite->sprite->rom_data.rom_offset_end))
+			{
+				continue;
+			}
+
+			std::shared_ptr<const rom::Sprite> reloaded_sprite =
+				rom::Sprite::LoadFromROM(m_owning_ui.GetROM(), sprite->sprite->rom_data.rom_offset);
+			sprite = reloaded_sprite ? std::make_shared<UISpriteTexture>(reloaded_sprite) : nullptr;
+		}
+		m_sprites_found.erase(
+			std::remove(m_sprites_found.begin(), m_sprites_found.end(), nullptr),
+			m_sprites_found.end()
+		);
+	}
+
+	void EditorSpriteNavigator::RescanSpriteRanges(const std::vector<rom::DirtyRange>& ranges)
+	{
+		const rom::SpinballROM& rom = m_owning_ui.GetROM();
+		const size_t rom_size = rom.m_buffer.size();
+		if (rom_size == 0)
+		{
+			return;
+		}
+		const Uint32 rom_last_offset = static_cast<Uint32>(rom_size - 1);
+		const Uint32 scan_start = std::min(m_applied_scan_start, rom_last_offset);
+		const Uint32 scan_end = std::min(m_applied_scan_end, rom_last_offset);
+		if (scan_start > scan_end)
+		{
+			return;
+		}
+
+		// Only a sprite starting less than s_max_sprite_bytes before a changed byte can reach it.
+		constexpr Uint32 max_sprite_bytes = rom::SpriteHeaderFilter::s_max_sprite_bytes;
+		rom::DirtyRangeSet windows;
+		for (const rom::DirtyRange& range : ranges)
+		{
+			if (range.end <= range.begin)
+			{
+				continue;
+			}
+			const Uint32 window_begin = std::max(scan_start, range.begin >= max_sprite_bytes ? range.begin - max_sprite_bytes + 1 : 0U);
+			const Uint32 window_last = std::min(scan_end, range.end - 1);
+			if (window_begin <= window_last)
+			{
+				windows.Add(window_begin, window_last + 1);
+			}
+		}
+		if (windows.Empty())
+		{
+			return;
+		}
+
+		std::vector<Uint32> candidates;
+		for (const rom::DirtyRange& window : windows.GetRanges())
+		{
+			rom::SpriteHeaderFilter::FindCandidates(rom.m_buffer, window.begin, window.end - 1, candidates);
+		}
+
+		std::lock_guard<std::recursive_mutex> render_lock(
+			m_owning_ui.m_render_to_texture_mutex
+		);
+		// Every hit starting in a window is stale; whatever parses there now goes back in.
+		m_sprites_found.erase(
+			std::remove_if(
+				m_sprites_found.begin(),
+				m_sprites_found.end(),
+				[&windows](const std::shared_ptr<UISpriteTexture>& sprite)
+				{
+					return !sprite || !sprite->sprite ||
+						windows.Overlaps(sprite->sprite->rom_data.rom_offset, sprite->sprite->rom_data.rom_offset + 1);
+				}
+			),
+			m_sprites_found.end()
+		);
+		for (const Uint32 offset : candidates)
+		{
+			std::shared_ptr<const rom::Sprite> sprite = rom::Sprite::LoadFromROM(rom, offset);
+			if (sprite && sprite->rom_data.rom_offset_end <= scan_end + 1)
+			{
+				m_sprites_found.emplace_back(std::make_shared<UISpriteTexture>(sprite));
+			}
+		}
+		std::stable_sort(
+			m_sprites_found.begin(),
+			m_sprites_found.end(),
+			[](const std::shared_ptr<UISpriteTexture>& lhs, const std::shared_ptr<UISpriteTexture>& rhs)
+			{
+				return lhs->sprite->rom_data.rom_offset < rhs->sprite->rom_data.rom_offset;
+			}
+		);
+
+		// Keep the cached scan in step, so the next session doesn't scan the range again either.
+		rom::ROMWriter found_offsets{ 0 };
+		for (const std::shared_ptr<UISpriteTexture>& sprite : m_sprites_found)
+		{
+			found_offsets.WriteUint32(sprite->sprite->rom_data.rom_offset);
+		}
+		rom.GetAssetCache().Store(
+			rom::AssetCacheKey{ rom::AssetCacheKind::SpriteScan, scan_start, scan_end },
+			rom.m_buffer,
+			scan_start,
+			scan_end + 1U,
+			std::vector<Uint8>(found_offsets.GetBytes().begin(), found_offsets.GetBytes().end())
+		);
+	}
+
+	void EditorSpriteNavigator::NotifyROMLoaded()
+	{
+		ClearSpriteScan();
+	}
+
+	void EditorSpriteNavigator::ClearSpriteScan()
+	{
+		++m_scan_generation;
+		m_find_all_running = false;
+		m_main_scan_pending = false;
+		m_main_scan_complete = false;
+		m_edits_during_scan.Clear();
+		m_sprites_found.clear();
+		{
+			std::lock_guard<std::mutex> pending_lock(m_pending_sprites_mutex);
+			m_pending_sprites.clear();
+		}
+		m_selected_sprite_rom_offset = 0;
+	}
+
 	void EditorSpriteNavigator::InvalidatePaletteDependentTextures()
 	{
 		for (std::shared_ptr<UISpriteTexture>& texture : m_sprites_found)
@@ -2052,6 +2181,8 @@ namespace spintool
 
 			// Texture creation remains on the main/render thread.
 			{
+				// Read before draining: the scan publishes its last batch before it stops running.
+				const bool scan_finished = m_main_scan_pending && !m_find_all_running.load();
 				std::vector<std::shared_ptr<UISpriteTexture>> ready_sprites;
 				{
 					std::lock_guard<std::mutex> pending_lock(m_pending_sprites_mutex);
@@ -2086,11 +2217,24 @@ namespace spintool
 								continue;
 							}
 
+							// Scans decode from a snapshot, which keeps no index of its own.
+							m_owning_ui.GetROM().GetAssetIndex().Register(rom::ROMAssetType::Sprite, sprite->sprite->rom_data);
 							sprite->texture = sprite->RenderTextureForPalette(palette);
 							m_sprites_found.emplace_back(std::move(sprite));
 						}
 					}
 				}
+
+				if (scan_finished)
+				{
+					m_main_scan_pending = false;
+					m_main_scan_complete = true;
+					if (!m_edits_during_scan.Empty())
+					{
+						RescanSpriteRanges(m_edits_during_scan.GetRanges());
+						m_edits_during_scan.Clear();
+					}
+				}
 			}
 
 			auto start_full_sprite_scan = [this](
@@ -2099,7 +2243,12 @@ namespace spintool
 			)
 			{
 				const Uint32 scan_generation = ++m_scan_generation;
+				m_applied_scan_start = requested_scan_start;
+				m_applied_scan_end = requested_scan_end;
 				m_find_all_running = true;
+				m_main_scan_pending = true;
+				m_main_scan_complete = false;
+				m_edits_during_scan.Clear();
 				m_find_all_progress = 0.0f;
 				m_find_all_result_count = 0;
 
@@ -2110,14 +2259,20 @@ namespace spintool
 				}
 				m_selected_sprite_rom_offset = 0;
 
+				// The scan reads a pinned snapshot, so edits made while it runs can't tear
+				// the image under it and a reload can't unmap it.
+				std::shared_ptr<const rom::ROMSnapshot> snapshot = m_owning_ui.GetROM().GetSnapshot();
+
 				std::thread([
 					this,
+					snapshot = std::move(snapshot),
 					requested_scan_start,
 					requested_scan_end,
 					scan_generation
 				]()
 				{
-					const size_t scan_rom_size = m_owning_ui.GetROM().m_buffer.size();
+					const rom::SpinballROM& scan_rom = snapshot->GetROM();
+					const size_t scan_rom_size = scan_rom.m_buffer.size();
 					if (scan_rom_size == 0)
 					{
 						if (m_scan_generation.load() == scan_generation)
@@ -2149,55 +2304,155 @@ namespace spintool
 						return;
 					}
 
-					const Uint32 scan_length = scan_end - scan_start + 1U;
-					Uint32 working_offset = scan_start;
-					while (
-						working_offset <= scan_end &&
-						working_offset < scan_rom_size &&
-						m_scan_generation.load() == scan_generation
-					)
+					// A previous session may already have scanned these exact bytes.
+					rom::AssetCache& asset_cache = m_owning_ui.GetROM().GetAssetCache();
+					const rom::AssetCacheKey cache_key{ rom::AssetCacheKind::SpriteScan, scan_start, scan_end };
+					if (std::optional<rom::AssetCacheHit> hit = asset_cache.Find(cache_key, scan_rom.m_buffer))
 					{
-						m_find_all_progress = static_cast<float>(
-							working_offset - scan_start
-						) / static_cast<float>(std::max<Uint32>(1U, scan_length));
+						rom::ROMCursor cached_offsets{ rom::ROMSpan{ hit->payload, 0, static_cast<Uint32>(hit->payload.size()) } };
+						while (cached_offsets.Remaining() >= 4 && m_scan_generation.load() == scan_generation)
+						{
+							auto sprite = rom::Sprite::LoadFromROM(scan_rom, cached_offsets.ReadUint32());
+							if (!sprite)
+							{
+								continue;
+							}
 
-						auto sprite = rom::Sprite::LoadFromROM(
-							m_owning_ui.GetROM(),
-							working_offset
-						);
+							std::lock_guard<std::mutex> pending_lock(m_pending_sprites_mutex);
+							if (m_scan_generation.load() == scan_generation)
+							{
+								m_pending_sprites.emplace_back(std::make_shared<UISpriteTexture>(sprite));
+								++m_find_all_result_count;
+							}
+						}
 
-						if (sprite)
+						if (m_scan_generation.load() == scan_generation)
 						{
-							const Uint32 sprite_end = sprite->rom_data.rom_offset_end;
-							if (
-								sprite_end > working_offset &&
-								sprite_end <= scan_rom_size &&
-								sprite_end <= scan_end + 1 &&
-								m_scan_generation.load() == scan_generation
-							)
+							m_find_all_progress = 1.0f;
+							m_find_all_running = false;
+						}
+						return;
+					}
+
+					// The range is cut into fixed chunks that workers pull from a shared counter, so
+					// a stretch dense with plausible headers can't leave the other cores idle. Hits
+					// wait in their chunk's slot and reach the UI a whole chunk at a time, in offset
+					// order, so the pending lock is taken once per batch rather than once per hit.
+					struct ScanChunk
+					{
+						std::vector<std::shared_ptr<UISpriteTexture>> sprites;
+						std::vector<Uint32> offsets;
+						std::atomic<bool> done{ false };
+					};
+
+					const Uint32 scan_length = scan_end - scan_start + 1U;
+					const size_t num_chunks = (static_cast<size_t>(scan_length) + kSpriteScanChunkBytes - 1U) / kSpriteScanChunkBytes;
+					std::vector<ScanChunk> chunks(num_chunks);
+					std::atomic<size_t> next_chunk{ 0 };
+					std::atomic<size_t> chunks_scanned{ 0 };
+					// Guarded by m_pending_sprites_mutex.
+					size_t next_chunk_to_publish = 0;
+
+					auto publish_ready_chunks = [&]()
+					{
+						std::lock_guard<std::mutex> pending_lock(m_pending_sprites_mutex);
+						if (m_scan_generation.load() != scan_generation)
+						{
+							return;
+						}
+						m_find_all_progress = static_cast<float>(chunks_scanned.load()) / static_cast<float>(num_chunks);
+						while (next_chunk_to_publish < num_chunks && chunks[next_chunk_to_publish].done.load(std::memory_order_acquire))
+						{
+							std::vector<std::shared_ptr<UISpriteTexture>>& ready = chunks[next_chunk_to_publish].sprites;
+							m_find_all_result_count += static_cast<int>(ready.size());
+							m_pending_sprites.insert(
+								m_pending_sprites.end(),
+								std::make_move_iterator(ready.begin()),
+								std::make_move_iterator(ready.end())
+							);
+							ready.clear();
+							++next_chunk_to_publish;
+						}
+					};
+
+					auto run_worker = [&]()
+					{
+						std::vector<Uint32> candidates;
+						for (size_t chunk_index = next_chunk++; chunk_index < num_chunks; chunk_index = next_chunk++)
+						{
+							ScanChunk& chunk = chunks[chunk_index];
+							const Uint32 chunk_start = scan_start + static_cast<Uint32>(chunk_index * kSpriteScanChunkBytes);
+							const Uint32 chunk_end = static_cast<Uint32>(
+								std::min<size_t>(static_cast<size_t>(chunk_start) + kSpriteScanChunkBytes - 1U, scan_end)
+							);
+							// Only offsets whose header could parse are worth building a Sprite for.
+							candidates.clear();
+							rom::SpriteHeaderFilter::FindCandidates(scan_rom.m_buffer, chunk_start, chunk_end, candidates);
+							for (const Uint32 working_offset : candidates)
 							{
-								std::lock_guard<std::mutex> pending_lock(
-									m_pending_sprites_mutex
+								if (m_scan_generation.load(std::memory_order_relaxed) != scan_generation)
+								{
+									return;
+								}
+
+								auto sprite = rom::Sprite::LoadFromROM(
+									scan_rom,
+									working_offset
 								);
-								if (m_scan_generation.load() == scan_generation)
+								if (!sprite)
 								{
-									m_pending_sprites.emplace_back(
-										std::make_shared<UISpriteTexture>(sprite)
-									);
-									++m_find_all_result_count;
+									continue;
+								}
+
+								const Uint32 sprite_end = sprite->rom_data.rom_offset_end;
+								if (
+									sprite_end > working_offset &&
+									sprite_end <= scan_rom_size &&
+									sprite_end <= scan_end + 1
+								)
+								{
+									chunk.sprites.emplace_back(std::make_shared<UISpriteTexture>(sprite));
+									chunk.offsets.emplace_back(working_offset);
 								}
 							}
-						}
 
-						if (working_offset == std::numeric_limits<Uint32>::max())
-						{
-							break;
+							chunk.done.store(true, std::memory_order_release);
+							++chunks_scanned;
+							publish_ready_chunks();
 						}
-						++working_offset;
+					};
+
+					// This thread is worker 0.
+					const size_t num_threads = std::min<size_t>(num_chunks, std::max(1u, std::thread::hardware_concurrency()));
+					std::vector<std::thread> workers;
+					workers.reserve(num_threads - 1U);
+					for (size_t worker = 1; worker < num_threads; ++worker)
+					{
+						workers.emplace_back(run_worker);
+					}
+					run_worker();
+					for (std::thread& worker : workers)
+					{
+						worker.join();
 					}
 
 					if (m_scan_generation.load() == scan_generation)
 					{
+						rom::ROMWriter found_offsets{ 0 };
+						for (const ScanChunk& chunk : chunks)
+						{
+							for (const Uint32 found_offset : chunk.offsets)
+							{
+								found_offsets.WriteUint32(found_offset);
+							}
+						}
+						asset_cache.Store(
+							cache_key,
+							scan_rom.m_buffer,
+							scan_start,
+							scan_end + 1U,
+							std::vector<Uint8>(found_offsets.GetBytes().begin(), found_offsets.GetBytes().end())
+						);
 						m_find_all_progress = 1.0f;
 						m_find_all_running = false;
 					}
@@ -2272,14 +2527,7 @@ namespace spintool
 				m_result_display_mode = ResultDisplayMode::MAIN_SPRITES;
 				m_main_sprite_status.clear();
 				m_main_import_target.reset();
-				++m_scan_generation;
-				m_find_all_running = false;
-				m_sprites_found.clear();
-				{
-					std::lock_guard<std::mutex> pending_lock(m_pending_sprites_mutex);
-					m_pending_sprites.clear();
-				}
-				m_selected_sprite_rom_offset = 0;
+				ClearSpriteScan();
 			}
 			
 			if (m_find_all_running)
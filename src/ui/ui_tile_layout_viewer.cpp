@@ -45,6 +45,49 @@ namespace spintool
 			resolved_offset = rom.ReadUint32(table_offset);
 			return ROMRangeIsValid(rom, resolved_offset, minimum_size);
 		}
+
+		std::vector<rom::Ptr32> GetLevelTableEntries(const rom::LevelDataOffsets& offsets)
+		{
+			return {
+				offsets.foreground_tileset, offsets.background_tileset,
+				offsets.foreground_tile_layout, offsets.background_tile_layout,
+				offsets.foreground_tile_brushes, offsets.background_tile_brushes,
+				offsets.collision_data_terrain, offsets.palette_set,
+				offsets.tile_layout_width, offsets.tile_layout_height,
+				offsets.camera_start_position_x, offsets.camera_start_position_y,
+				offsets.camera_activation_sector_anim_obj_ids,
+				offsets.player_start_position_x, offsets.player_start_position_y,
+				offsets.flipper_data, offsets.flipper_count,
+				offsets.level_name, offsets.ring_count
+			};
+		}
+
+		std::string DescribeTilesetSaveStats(const std::vector<rom::Level::TilesetSaveStats>& tileset_stats)
+		{
+			if (tileset_stats.empty())
+			{
+				return "No tileset was recompressed.";
+			}
+
+			std::string description;
+			for (const rom::Level::TilesetSaveStats& stats : tileset_stats)
+			{
+				char line[160];
+				snprintf(
+					line,
+					sizeof(line),
+					"Tileset at 0x%06X: %zu -> %zu bytes (was %zu, ratio %.2f, %.1f MB/s)\n",
+					static_cast<unsigned int>(stats.rom_offset),
+					stats.compression.input_size,
+					stats.compression.output_size,
+					stats.previous_size,
+					stats.compression.GetRatio(),
+					stats.compression.GetMegabytesPerSecond()
+				);
+				description += line;
+			}
+			return description;
+		}
 	}
 	EditorTileLayoutViewer::EditorTileLayoutViewer(EditorUI& owning_ui)
 		: EditorWindowBase(owning_ui)
@@ -94,8 +137,10 @@ namespace spintool
 							m_level->m_game_obj_instances.emplace_back(game_obj->obj_definition);
 						}
 
+						rom::ROMTransaction transaction{ m_owning_ui.GetROM(), "Save level" };
 						m_level->SaveToROM(m_owning_ui.GetROM());
 						m_owning_ui.GetROM().SaveROM();
+						m_has_unsaved_layout_edits = false;
 					}
 				}
 
@@ -103,36 +148,31 @@ namespace spintool
 				{
 					if (m_level != nullptr)
 					{
-						rom::Ptr32 next_tileset_location = 0x100000;
-						const rom::SSCCompressionResult compressed_data = rom::SSCCompressor::CompressData(m_level->m_tile_layers[0].tileset->uncompressed_data, 0, m_level->m_tile_layers[0].tileset->num_tiles * 64);
-						if (m_level->m_tile_layers[0].tileset->compressed_size < compressed_data.size())
-						{
-							m_owning_ui.GetROM().WriteUint32(m_level->m_data_offsets.background_tileset, next_tileset_location);
-							m_owning_ui.GetROM().m_buffer.resize(0x200000);
-							next_tileset_location = m_level->m_tile_layers[0].tileset->SaveToROM_SSCCompression(m_owning_ui.GetROM(), next_tileset_location);
-							if ((next_tileset_location % 2) == 1)
-							{
-								next_tileset_location += 1;
-							}
-						}
-						else
-						{
-							m_level->m_tile_layers[0].tileset->SaveToROM_SSCCompression(m_owning_ui.GetROM(), m_owning_ui.GetROM().ReadUint32(m_level->m_data_offsets.background_tileset));
-						}
-
-						const rom::SSCCompressionResult compressed_fg_data = rom::SSCCompressor::CompressData(m_level->m_tile_layers[1].tileset->uncompressed_data, 0, m_level->m_tile_layers[1].tileset->num_tiles * 64);
+						rom::ROMTransaction transaction{ m_owning_ui.GetROM(), "Save tilesets" };
+						std::vector<rom::Level::TilesetSaveStats> tileset_stats;
+						m_level->SaveTilesetsToROM(m_owning_ui.GetROM(), &tileset_stats);
+						m_owning_ui.GetROM().SaveROM();
+						m_popup_msg = PopupMessage{ "Tilesets saved", DescribeTilesetSaveStats(tileset_stats) };
+					}
+				}
 
-						if (m_level->m_tile_layers[0].tileset->compressed_size < compressed_data.size() || m_level->m_tile_layers[1].tileset->compressed_size < compressed_fg_data.size())
-						{
-							m_owning_ui.GetROM().WriteUint32(m_level->m_data_offsets.foreground_tileset, next_tileset_location);
-							m_owning_ui.GetROM().m_buffer.resize(0x200000);
-							m_level->m_tile_layers[1].tileset->SaveToROM_SSCCompression(m_owning_ui.GetROM(), next_tileset_location);
-						}
-						else
-						{
-							m_level->m_tile_layers[1].tileset->SaveToROM_SSCCompression(m_owning_ui.GetROM(), m_owning_ui.GetROM().ReadUint32(m_level->m_data_offsets.foreground_tileset));
-						}
-					m_owning_ui.GetROM().SaveROM();
+				if (ImGui::Selectable("Save Tilesets (optimise tile order)"))
+				{
+					if (m_level != nullptr)
+					{
+						rom::ROMTransaction transaction{ m_owning_ui.GetROM(), "Save tilesets with optimised tile order" };
+						const std::size_t reorder_bytes_saved = m_level->OptimiseTileOrder(m_owning_ui.GetROM());
+						std::vector<rom::Level::TilesetSaveStats> tileset_stats;
+						m_level->SaveTilesetsToROM(m_owning_ui.GetROM(), &tileset_stats);
+						m_level->SaveTileLayersToROM(m_owning_ui.GetROM());
+						m_owning_ui.GetROM().SaveROM();
+						m_popup_msg = PopupMessage{
+							"Tilesets saved",
+							"Reordering tiles saved " + std::to_string(reorder_bytes_saved) + " bytes. Shared tilesets keep their order.\n" + DescribeTilesetSaveStats(tileset_stats)
+						};
+						m_has_unsaved_layout_edits = false;
+						m_render_from_edit = true;
+						out_render_request = RenderRequestType::LEVEL;
 					}
 				}
 
@@ -289,6 +329,16 @@ namespace spintool
 			ImGui::EndMenuBar();
 		}
 
+		if (m_reload_level_requested)
+		{
+			m_reload_level_requested = false;
+			if (level_index == -1 && previous_level_index != -1)
+			{
+				level_index = previous_level_index;
+				out_render_request = RenderRequestType::LEVEL;
+			}
+		}
+
 		if (level_index != -1)
 		{
 			m_level = std::make_shared<rom::Level>(rom::Level::LoadFromROM(m_owning_ui.GetROM(), level_index));
@@ -298,6 +348,8 @@ namespace spintool
 			m_selected_tile.Clear();
 			m_working_brush.reset();
 			m_working_flipper.reset();
+			m_has_unsaved_layout_edits = false;
+			m_reload_level_prompt = false;
 			Uint32 spline_offset = 0;
 			if (ROMPointerIsValid(m_owning_ui.GetROM(), m_level->m_data_offsets.collision_data_terrain, spline_offset, 2))
 			{
@@ -376,6 +428,33 @@ namespace spintool
 				}
 			}
 
+			if (m_reload_level_prompt)
+			{
+				constexpr const char* reload_popup_title = "Level changed on ROM";
+				if (ImGui::IsPopupOpen(reload_popup_title) == false)
+				{
+					ImGui::OpenPopup(reload_popup_title);
+				}
+				if (ImGui::BeginPopupModal(reload_popup_title, nullptr, ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoScrollbar))
+				{
+					ImGui::Text("ROM data this level was loaded from has changed, but its tile layout has unsaved edits.");
+					ImGui::Text("Reloading picks up the change and discards those edits.");
+					if (ImGui::Button("Reload Level"))
+					{
+						m_reload_level_prompt = false;
+						m_reload_level_requested = true;
+						ImGui::CloseCurrentPopup();
+					}
+					ImGui::SameLine();
+					if (ImGui::Button("Keep Editing"))
+					{
+						m_reload_level_prompt = false;
+						ImGui::CloseCurrentPopup();
+					}
+					ImGui::EndPopup();
+				}
+			}
+
 			bool has_just_selected_item = false;
 
 			DrawSidebar(has_just_selected_item);
@@ -1587,6 +1666,7 @@ namespace spintool
 									}
 								}
 								m_render_from_edit = true;
+								m_has_unsaved_layout_edits = true;
 								m_selected_tile.dragging_start_ref.reset();
 							}
 						}
@@ -1741,6 +1821,7 @@ namespace spintool
 											}
 										}
 										m_render_from_edit = true;
+										m_has_unsaved_layout_edits = true;
 										m_selected_brush.dragging_start_ref.reset();
 									}
 								}
@@ -1862,6 +1943,7 @@ namespace spintool
 								{
 									m_working_flipper->initial_drag_offset.reset();
 									*m_working_flipper->destination = m_working_flipper->flipper_obj;
+									rom::ROMTransaction transaction{ m_owning_ui.GetROM(), "Move flipper" };
 									m_working_flipper->destination->SaveToROM(m_owning_ui.GetROM());
 									m_render_from_edit = true;
 									m_working_flipper.reset();
@@ -1891,6 +1973,7 @@ namespace spintool
 								{
 									m_working_ring->initial_drag_offset.reset();
 									*m_working_ring->destination = m_working_ring->ring_obj;
+									rom::ROMTransaction transaction{ m_owning_ui.GetROM(), "Move ring" };
 									m_working_ring->destination->SaveToROM(m_owning_ui.GetROM());
 									m_render_from_edit = true;
 									m_working_ring.reset();
@@ -2181,6 +2264,7 @@ namespace spintool
 					{
 						if (ImGui::Button("Confirm"))
 						{
+							rom::ROMTransaction transaction{ m_owning_ui.GetROM(), "Edit game object" };
 							*m_working_game_obj->destination = m_working_game_obj->game_obj;
 							m_working_game_obj->destination->obj_definition.SaveToROM(m_owning_ui.GetROM());
 							m_render_from_edit = true;
@@ -2196,6 +2280,7 @@ namespace spintool
 
 						if (ImGui::Button("Create duplicate here"))
 						{
+							rom::ROMTransaction transaction{ m_owning_ui.GetROM(), "Duplicate game object" };
 							if (UIGameObject* new_obj = m_game_object_manager.DuplicateGameObject(m_working_game_obj->game_obj, m_level->m_data_offsets))
 							{
 								new_obj->had_collision_sectors_on_rom = true;
@@ -2209,6 +2294,7 @@ namespace spintool
 						ImGui::SameLine();
 						if (ImGui::Button("Delete"))
 						{
+							rom::ROMTransaction transaction{ m_owning_ui.GetROM(), "Delete game object" };
 							if (UIGameObject* removed_obj = m_game_object_manager.DeleteGameObject(m_working_game_obj->game_obj))
 							{
 								removed_obj->obj_definition.SaveToROM(m_owning_ui.GetROM());
@@ -2223,6 +2309,7 @@ namespace spintool
 							ImGui::BeginDisabled(m_working_game_obj->destination->had_collision_sectors_on_rom && m_working_game_obj->destination->had_culling_sectors_on_rom);
 							if (ImGui::Button("Enable culling"))
 							{
+								rom::ROMTransaction transaction{ m_owning_ui.GetROM(), "Enable game object culling" };
 								m_working_game_obj->destination->had_collision_sectors_on_rom = true;
 								m_working_game_obj->destination->had_culling_sectors_on_rom = true;
 								m_working_game_obj->destination->obj_definition.SaveToROM(m_owning_ui.GetROM());
@@ -2301,6 +2388,7 @@ namespace spintool
 										{
 											target_game_obj->get()->obj_definition.x_pos += offset.x;
 											target_game_obj->get()->obj_definition.y_pos += offset.y;
+											rom::ROMTransaction transaction{ m_owning_ui.GetROM(), "Move game object" };
 											target_game_obj->get()->obj_definition.SaveToROM(m_owning_ui.GetROM());
 											m_render_from_edit = true;
 										}
@@ -2805,24 +2893,15 @@ namespace spintool
 					// Derive the exact brush range from the brush indices used by this layout.
 					// The previous code used another asset pointer as the end address, which is
 					// not reliable because level assets are not guaranteed to be contiguous.
-					Uint16 highest_brush_index = 0;
-					for (std::size_t off = 0; off < layout_bytes; off += sizeof(Uint16))
-					{
-						const Uint8 first_byte = rom_data.m_buffer[layout + off];
-						const Uint8 second_byte = rom_data.m_buffer[layout + off + 1];
-						const Uint16 brush_index =
-							(static_cast<Uint16>(first_byte & 0x03) << 8) | second_byte;
-						highest_brush_index = std::max(highest_brush_index, brush_index);
-					}
+					const Uint32 brush_count = rom::TileLayout::CountReferencedBrushes(rom_data, layout, static_cast<Uint32>(layout_bytes));
 
 					constexpr std::size_t brush_bytes = rom::TileBrush::s_default_total_tiles * sizeof(Uint16);
-					const std::size_t required_brush_bytes =
-						(static_cast<std::size_t>(highest_brush_index) + 1) * brush_bytes;
+					const std::size_t required_brush_bytes = static_cast<std::size_t>(brush_count) * brush_bytes;
 					if (!ROMRangeIsValid(rom_data, brushes, required_brush_bytes))
 					{
 						std::cerr << "Skipping " << layer_name
 							<< ": brush data exceeds ROM bounds (highest index "
-							<< highest_brush_index << ")\\n";
+							<< brush_count - 1 << ")\\n";
 						make_placeholder(layer_index);
 						return false;
 					}
@@ -3249,6 +3328,42 @@ namespace spintool
 		}
 	}
 
+	void EditorTileLayoutViewer::NotifyROMChanged(const std::vector<rom::DirtyRange>& ranges)
+	{
+		if (m_level == nullptr || m_level->m_level_index == -1)
+		{
+			return;
+		}
+
+		// The level's data is scattered across many tables, so reload all of it when any of
+		// them changes rather than trying to patch individual objects.
+		const rom::SpinballROM& rom = m_owning_ui.GetROM();
+		bool level_changed = false;
+		for (const rom::ROMData& extent : rom::Level::CollectAssetExtents(rom, m_level->m_level_index))
+		{
+			level_changed = level_changed || rom::RangesOverlap(ranges, extent.rom_offset, extent.rom_offset_end);
+		}
+		// The level table entries hold the pointers to all of it, and values like the start positions.
+		for (const rom::Ptr32 table_entry : GetLevelTableEntries(m_level->m_data_offsets))
+		{
+			level_changed = level_changed || rom::RangesOverlap(ranges, table_entry, table_entry + static_cast<Uint32>(sizeof(rom::Ptr32)));
+		}
+		if (!level_changed)
+		{
+			return;
+		}
+
+		// Layout edits only live here until the level is saved, so ask before throwing them away.
+		if (m_has_unsaved_layout_edits)
+		{
+			m_reload_level_prompt = true;
+		}
+		else
+		{
+			m_reload_level_requested = true;
+		}
+	}
+
 	void EditorTileLayoutViewer::Reset()
 	{
 		m_level.reset();
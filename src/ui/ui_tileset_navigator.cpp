@@ -1,8 +1,12 @@
 #include "ui/ui_tileset_navigator.h"
 
 #include "ui/ui_editor.h"
+#include "ui/ui_palette_viewer.h"
 #include "rom/spinball_rom.h"
+#include "rom/rom_snapshot.h"
 #include "rom/ssc_decompressor.h"
+#include "rom/stream_discovery.h"
+#include <algorithm>
 #include <iostream>
 
 namespace spintool
@@ -33,6 +37,113 @@ namespace spintool
 		0x000cf2de // Bonus stage FG tiles
 	};
 
+	// One page of the 20-tile-wide grid RenderToSurface draws.
+	constexpr Uint32 s_preview_tiles_per_frame = 20 * 8;
+
+	void EditorTilesetNavigator::NotifyROMChanged(const std::vector<rom::DirtyRange>& ranges)
+	{
+		// The preview decodes the image as it was when it started, so any edit makes it stale.
+		if (m_preview_decoder && !ranges.empty())
+		{
+			ResetPreview();
+		}
+
+		for (TilesetEntry& entry : m_tilesets)
+		{
+			// SSC results start after the two-byte tile count header.
+			const Uint32 ssc_header_offset = entry.result.rom_data.rom_offset >= 2 ? entry.result.rom_data.rom_offset - 2 : 0;
+			const bool is_ssc = std::find(std::begin(s_tile_offsets), std::end(s_tile_offsets), ssc_header_offset) != std::end(s_tile_offsets)
+				|| std::any_of(m_discovered_streams.begin(), m_discovered_streams.end(), [ssc_header_offset](const rom::DiscoveredStream& stream)
+					{
+						return stream.algorithm == CompressionAlgorithm::SSC && stream.rom_data.rom_offset == ssc_header_offset;
+					});
+			const Uint32 load_offset = is_ssc ? ssc_header_offset : entry.result.rom_data.rom_offset;
+			const Uint32 end_offset = std::max(entry.result.rom_data.rom_offset_end, load_offset + 2);
+			if (!rom::RangesOverlap(ranges, load_offset, end_offset))
+			{
+				continue;
+			}
+
+			entry = is_ssc
+				? rom::TileSet::LoadFromROM_SSCCompression(m_owning_ui.GetROM(), load_offset)
+				: rom::TileSet::LoadFromROM_LZSSCompression(m_owning_ui.GetROM(), load_offset);
+		}
+
+		if (m_discovery && !ranges.empty())
+		{
+			// A running search or rescan reads its snapshot, so its results only catch up once it is done.
+			for (const rom::DirtyRange& range : ranges)
+			{
+				m_edits_during_discovery.Add(range.begin, range.end);
+			}
+			RescanDiscoveredStreams();
+		}
+	}
+
+	void EditorTilesetNavigator::NotifyROMLoaded()
+	{
+		ResetPreview();
+		m_tilesets.clear();
+		m_discovery.reset();
+		m_discovered_streams.clear();
+		m_edits_during_discovery.Clear();
+		m_edits_being_rescanned.Clear();
+		m_rescanning_discovered_streams = false;
+	}
+
+	void EditorTilesetNavigator::ResetPreview()
+	{
+		m_preview_decoder.reset();
+		m_preview_snapshot.reset();
+		m_preview_rendered_tiles = 0;
+		m_preview_surface.reset();
+		m_preview_texture.reset();
+	}
+
+	void EditorTilesetNavigator::CollectDiscoveredStreams()
+	{
+		if (m_rescanning_discovered_streams)
+		{
+			// A rescan hands back the whole list once it is done; until then the old one stays up.
+			if (!m_discovery->IsFinished())
+			{
+				return;
+			}
+			m_discovered_streams.clear();
+			m_rescanning_discovered_streams = false;
+			if (m_discovery->WasCancelled())
+			{
+				// The list came back as it went in, so those offsets still need trying.
+				for (const rom::DirtyRange& range : m_edits_being_rescanned.GetRanges())
+				{
+					m_edits_during_discovery.Add(range.begin, range.end);
+				}
+			}
+			m_edits_being_rescanned.Clear();
+		}
+		m_discovery->CollectResults(m_discovered_streams);
+	}
+
+	void EditorTilesetNavigator::RescanDiscoveredStreams()
+	{
+		if (!m_discovery || !m_discovery->IsFinished() || m_edits_during_discovery.Empty())
+		{
+			return;
+		}
+		CollectDiscoveredStreams();
+		// Runs off the UI thread like the search, over a snapshot taken after the edits.
+		m_discovery = std::make_unique<rom::StreamDiscovery>(
+			m_owning_ui.GetROM().GetSnapshot(),
+			m_owning_ui.GetROM().GetAssetCache(),
+			m_discovery->GetBegin(),
+			m_discovery->GetEnd(),
+			m_discovered_streams,
+			m_edits_during_discovery.GetRanges());
+		m_rescanning_discovered_streams = true;
+		m_edits_being_rescanned = std::move(m_edits_during_discovery);
+		m_edits_during_discovery.Clear();
+	}
+
 	void EditorTilesetNavigator::Update()
 	{
 		if (m_visible == false)
@@ -82,61 +193,33 @@ namespace spintool
 				ImGui::Text(result.error_msg.value_or(std::string("OK!")).c_str());
 			}
 
-			static std::vector<rom::SSCDecompressionResult> valid_ssc_results;
-			valid_ssc_results.reserve(0xFFFF);
-			if (ImGui::Button("Search for SSC Compressed data"))
+			const bool preview_ssc = ImGui::Button("Preview SSC tileset");
+			ImGui::SameLine();
+			const bool preview_lzss = ImGui::Button("Preview LZSS tileset");
+			if ((preview_ssc || preview_lzss) && actual_offset >= 0)
 			{
-				constexpr Uint32 max_tiles = 256;
-				valid_ssc_results.clear();
-				Uint32 next_offset = actual_offset;
-				while (next_offset+2 < m_owning_ui.GetROM().m_buffer.size())
-				{
-					Uint16 num_tiles = (static_cast<Sint16>(m_owning_ui.GetROM().m_buffer[next_offset] << 8)) | (static_cast<Sint16>(m_owning_ui.GetROM().m_buffer[next_offset + 1]));
-					if (num_tiles >= 2 && num_tiles < max_tiles)
-					{
-						rom::SSCDecompressionResult result = rom::SSCDecompressor::IsValidSSCCompressedData(&m_owning_ui.GetROM().m_buffer[next_offset+2], next_offset+2);
-						//rom::SSCDecompressionResult decompressed_data_result = rom::SSCDecompressor::DecompressData(&m_owning_ui.GetROM().m_buffer[next_offset+2], num_tiles * 0x40);
-						next_offset += 2;// result.rom_data.rom_offset_end;
-						if (result.error_msg.has_value() == false)
-						{
-							//if (result.uncompressed_size != decompressed_data_result.uncompressed_data.size())
-							//{
-							//	//char buffer[2048];
-							//	//sprintf(buffer, "Mismatched size detected at 0x%08X [Expected: %llu] [Actual: %llu]", static_cast<unsigned int>(result.rom_data.rom_offset), result.uncompressed_size, decompressed_data_result.uncompressed_data.size());
-							//	//std::cout << buffer << std::endl;
-							//}
-
-							if (result.uncompressed_size > 0x400 && (valid_ssc_results.empty() || result.rom_data.rom_offset_end != valid_ssc_results.back().rom_data.rom_offset_end))
-							{
-								//std::shared_ptr<const rom::TileSet> tileset_result = m_owning_ui.GetROM().LoadTileData(next_offset);
-								//if (tileset_result->num_tiles == num_tiles)
-								{
-									valid_ssc_results.emplace_back(result);
-									//valid_ssc_results.emplace_back(result, std::move(tileset_result));
-								}
-							}
-						}
-
-						if (next_offset % 2 == 1)
-						{
-							next_offset++;
-						}
-					}
-					else
-					{
-						next_offset += 2;
-					}
-				}
+				ResetPreview();
+				m_preview_snapshot = m_owning_ui.GetROM().GetSnapshot();
+				m_preview_decoder = std::make_unique<rom::TileSetStreamDecoder>(m_preview_snapshot->GetROM(), static_cast<Uint32>(actual_offset), preview_ssc ? CompressionAlgorithm::SSC : CompressionAlgorithm::LZSS);
 			}
+			DrawPreview();
 
-			if (valid_ssc_results.empty() == false)
+			if (ImGui::Button("Search for compressed tile data"))
 			{
-				ImGui::SeparatorText("Valid SSC data found");
-			}
-			for (const rom::SSCDecompressionResult& result : valid_ssc_results)
-			{
-				ImGui::Text("0x%08X -> 0x%08X [0x%02X] (Tiles: %u)", result.rom_data.rom_offset, result.rom_data.rom_offset_end, result.uncompressed_size);
+				// Runs off the UI thread over a snapshot; replacing it cancels any search in progress.
+				m_discovered_streams.clear();
+				m_edits_during_discovery.Clear();
+				m_edits_being_rescanned.Clear();
+				m_rescanning_discovered_streams = false;
+				const Uint32 search_start = static_cast<Uint32>(std::max(actual_offset, 0));
+				const size_t rom_size = m_owning_ui.GetROM().m_buffer.size();
+				m_discovery = std::make_unique<rom::StreamDiscovery>(
+					m_owning_ui.GetROM().GetSnapshot(),
+					m_owning_ui.GetROM().GetAssetCache(),
+					search_start,
+					rom_size > 0 ? static_cast<Uint32>(rom_size - 1) : 0);
 			}
+			DrawDiscoveredStreams();
 
 			for (const TilesetEntry& tileset_entry : m_tilesets)
 			{
@@ -184,4 +267,99 @@ namespace spintool
 		ImGui::End();
 	}
 
+	void EditorTilesetNavigator::DrawDiscoveredStreams()
+	{
+		if (!m_discovery)
+		{
+			return;
+		}
+
+		CollectDiscoveredStreams();
+		RescanDiscoveredStreams();
+		if (!m_discovery->IsFinished())
+		{
+			ImGui::ProgressBar(m_discovery->GetProgress());
+			// A rescan keeps the list in step with edits, so it always runs to the end.
+			if (!m_rescanning_discovered_streams)
+			{
+				ImGui::SameLine();
+				if (ImGui::Button("Cancel search"))
+				{
+					m_discovery->Cancel();
+				}
+			}
+		}
+
+		if (m_discovered_streams.empty())
+		{
+			return;
+		}
+
+		ImGui::SeparatorText("Compressed tile data found");
+		for (size_t i = 0; i < m_discovered_streams.size(); ++i)
+		{
+			const rom::DiscoveredStream& stream = m_discovered_streams[i];
+			ImGui::PushID(static_cast<int>(i));
+			if (ImGui::SmallButton("Load"))
+			{
+				m_tilesets.emplace_back(rom::TileSet::LoadFromROM(m_owning_ui.GetROM(), stream.rom_data.rom_offset, stream.algorithm));
+			}
+			ImGui::SameLine();
+			ImGui::Text("%s 0x%08X -> 0x%08X [0x%04X] (Tiles: %u) %3.0f%%",
+				stream.algorithm == CompressionAlgorithm::SSC ? "SSC" : "Compressed2",
+				static_cast<unsigned int>(stream.rom_data.rom_offset),
+				static_cast<unsigned int>(stream.rom_data.rom_offset_end),
+				static_cast<unsigned int>(stream.uncompressed_size),
+				static_cast<unsigned int>(stream.num_tiles),
+				stream.confidence * 100.0f);
+			ImGui::PopID();
+		}
+	}
+
+	void EditorTilesetNavigator::DrawPreview()
+	{
+		if (!m_preview_decoder)
+		{
+			return;
+		}
+
+		const auto& palettes = m_owning_ui.GetPalettes();
+		bool palette_changed = false;
+		if (!palettes.empty())
+		{
+			palette_changed = DrawPaletteSelector(m_preview_palette_index, palettes);
+			m_preview_palette_index = std::clamp(m_preview_palette_index, 0, static_cast<int>(palettes.size()) - 1);
+		}
+
+		if (!m_preview_decoder->IsFinished())
+		{
+			m_preview_decoder->DecodeTiles(m_preview_decoder->GetDecodedTileCount() + s_preview_tiles_per_frame);
+		}
+
+		const Uint32 decoded_tiles = m_preview_decoder->GetDecodedTileCount();
+		if ((decoded_tiles != m_preview_rendered_tiles || palette_changed) && !palettes.empty())
+		{
+			m_preview_rendered_tiles = decoded_tiles;
+			m_preview_surface = m_preview_decoder->MakePartialTileSet()->RenderToSurface(*palettes.at(m_preview_palette_index));
+			m_preview_texture = m_preview_surface ? Renderer::RenderToTexture(m_preview_surface.get()) : SDLTextureHandle{};
+		}
+
+		const std::optional<Uint32> total_tiles = m_preview_decoder->GetTotalTileCount();
+		if (total_tiles.has_value())
+		{
+			ImGui::Text("Preview: %u / %u tiles", static_cast<unsigned int>(decoded_tiles), static_cast<unsigned int>(*total_tiles));
+		}
+		else
+		{
+			ImGui::Text("Preview: %u tiles so far", static_cast<unsigned int>(decoded_tiles));
+		}
+		if (const std::optional<std::string> error = m_preview_decoder->GetError())
+		{
+			ImGui::TextUnformatted(error->c_str());
+		}
+		if (m_preview_texture)
+		{
+			ImGui::Image((ImTextureID)m_preview_texture.get(), { static_cast<float>(m_preview_surface->w) * 2, static_cast<float>(m_preview_surface->h) * 2 });
+		}
+	}
 }